@@ -8,6 +8,9 @@
 #include <string.h>
 #include "meshx_cmd_common.h"
 #include "meshx_errno.h"
+#include "meshx_net.h"
+#include "meshx_bearer.h"
+#include "meshx_tty.h"
 
 int32_t meshx_cmd_list_node_info(const meshx_cmd_parsed_data_t *pparsed_data)
 {
@@ -19,3 +22,86 @@ int32_t meshx_cmd_node_reset(const meshx_cmd_parsed_data_t *pparsed_data)
     return MESHX_SUCCESS;
 }
 
+int32_t meshx_cmd_net_stats(const meshx_cmd_parsed_data_t *pparsed_data)
+{
+    bool reset = (pparsed_data->param_cnt > 0) && (1 == pparsed_data->param_val[0]);
+    meshx_net_iface_t net_iface;
+    meshx_net_iface_traverse_start(&net_iface);
+    while (NULL != net_iface)
+    {
+        meshx_net_iface_stats_t stats = meshx_net_iface_stats_get(net_iface);
+        meshx_net_iface_filter_info_t filter_info = meshx_net_iface_get_filter_info(net_iface);
+        meshx_tty_printf("net interface(0x%08x) type %d:\r\n", net_iface, meshx_net_iface_type(net_iface));
+        meshx_tty_printf("  rx: received %u, filtered %u, invalid length %u, no nid match %u, decrypt failed %u\r\n",
+                         stats.received, stats.filtered, stats.invalid_length, stats.no_nid_match,
+                         stats.decrypt_failed);
+        meshx_tty_printf("      low rssi %u, adv duplicated %u, invalid address %u, duplicated %u\r\n",
+                         stats.low_rssi, stats.adv_duplicated, stats.invalid_address, stats.duplicated);
+        meshx_tty_printf("      delivered %u, relay candidates %u\r\n", stats.delivered,
+                         stats.relay_candidates);
+        meshx_tty_printf("  tx: total %u, filtered %u, sent %u, bearer error %u\r\n",
+                         filter_info.total_send, filter_info.filtered_send, stats.sent, stats.bearer_error);
+        meshx_tty_printf("      queued %u, dropped %u, blocked %u\r\n", filter_info.queued_send,
+                         filter_info.dropped_send, filter_info.blocked_send);
+        meshx_bearer_t bearer = meshx_net_iface_get_bearer(net_iface);
+        if (NULL != bearer)
+        {
+            meshx_bearer_stats_t bearer_stats = meshx_bearer_stats_get(bearer);
+            meshx_tty_printf("  bearer: mtu %u, pending %u, sent %u, busy %u, failed %u, received %u\r\n",
+                             meshx_bearer_mtu_get(bearer), meshx_bearer_pending_get(bearer),
+                             bearer_stats.sent, bearer_stats.busy, bearer_stats.failed,
+                             bearer_stats.received);
+        }
+        if (reset)
+        {
+            meshx_net_iface_stats_reset(net_iface);
+            meshx_bearer_stats_reset(bearer);
+        }
+        meshx_net_iface_traverse_continue(&net_iface);
+    }
+
+    return MESHX_SUCCESS;
+}
+
+int32_t meshx_cmd_ip_bearer(const meshx_cmd_parsed_data_t *pparsed_data)
+{
+    if (0 == pparsed_data->param_cnt)
+    {
+        return -MESHX_ERR_INVAL;
+    }
+
+    meshx_ip_addr_t addr;
+    memset(&addr, 0, sizeof(meshx_ip_addr_t));
+    addr.family = MESHX_IP_FAMILY_UDP;
+    addr.ipv4[0] = 127;
+    addr.ipv4[3] = 1;
+    addr.port = pparsed_data->param_val[0];
+    meshx_bearer_t bearer = meshx_bearer_ip_create(&addr);
+    if (NULL == bearer)
+    {
+        meshx_tty_printf("create ip bearer failed\r\n");
+        return -MESHX_ERR_FAIL;
+    }
+
+    for (uint8_t i = 1; i < pparsed_data->param_cnt; ++i)
+    {
+        addr.port = pparsed_data->param_val[i];
+        meshx_bearer_ip_peer_add(bearer, &addr);
+    }
+
+    meshx_net_iface_t net_iface = meshx_net_iface_create();
+    if ((NULL == net_iface) || (MESHX_SUCCESS != meshx_net_iface_connect(net_iface, bearer, NULL, NULL)))
+    {
+        meshx_tty_printf("connect ip bearer failed\r\n");
+        if (NULL != net_iface)
+        {
+            meshx_net_iface_delete(net_iface);
+        }
+        meshx_bearer_delete(bearer);
+        return -MESHX_ERR_FAIL;
+    }
+
+    meshx_tty_printf("ip bearer(0x%08x) connected to net interface(0x%08x)\r\n", bearer, net_iface);
+
+    return MESHX_SUCCESS;
+}
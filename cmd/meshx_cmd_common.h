@@ -14,6 +14,8 @@ MESHX_BEGIN_DECLS
 
 MESHX_EXTERN int32_t meshx_cmd_list_node_info(const meshx_cmd_parsed_data_t *pparsed_data);
 MESHX_EXTERN int32_t meshx_cmd_node_reset(const meshx_cmd_parsed_data_t *pparsed_data);
+MESHX_EXTERN int32_t meshx_cmd_net_stats(const meshx_cmd_parsed_data_t *pparsed_data);
+MESHX_EXTERN int32_t meshx_cmd_ip_bearer(const meshx_cmd_parsed_data_t *pparsed_data);
 
 
 #define MESHX_CMD_COMMON \
@@ -28,6 +30,18 @@ MESHX_EXTERN int32_t meshx_cmd_node_reset(const meshx_cmd_parsed_data_t *pparsed
         "nr",\
         "node reset",\
         meshx_cmd_node_reset\
+    },\
+    {\
+        "net_stats",\
+        "net_stats [op]",\
+        "network statistics of all interfaces.\r\n  op: 0(dump) 1(dump and reset)",\
+        meshx_cmd_net_stats\
+    },\
+    {\
+        "ip_bearer",\
+        "ip_bearer [port] [peer port]...",\
+        "create udp bearer on loopback and connect it to a new network interface",\
+        meshx_cmd_ip_bearer\
     }
 
 
@@ -17,6 +17,7 @@ static meshx_list_t prov_dev_list = {.pprev = &prov_dev_list, .pnext = &prov_dev
 typedef struct
 {
     meshx_prov_dev_t prov_dev;
+    bool public_key_pending;
     meshx_list_t node;
 } meshx_prov_devs_t;
 
@@ -29,6 +30,7 @@ int32_t meshx_cmd_prov_add_device(meshx_prov_dev_t prov_dev)
         return -MESHX_ERR_MEM;
     }
     pdev->prov_dev = prov_dev;
+    pdev->public_key_pending = FALSE;
     meshx_list_append(&prov_dev_list, &pdev->node);
     return MESHX_SUCCESS;
 }
@@ -64,6 +66,22 @@ static meshx_prov_dev_t meshx_cmd_prov_get_device(uint32_t id)
     return NULL;
 }
 
+static meshx_prov_devs_t *meshx_cmd_prov_get_devs(meshx_prov_dev_t prov_dev)
+{
+    meshx_list_t *pnode = NULL;
+    meshx_prov_devs_t *pdev = NULL;
+    meshx_list_foreach(pnode, &prov_dev_list)
+    {
+        pdev = MESHX_CONTAINER_OF(pnode, meshx_prov_devs_t, node);
+        if (pdev->prov_dev == prov_dev)
+        {
+            return pdev;
+        }
+    }
+
+    return NULL;
+}
+
 int32_t meshx_cmd_prov_scan(const meshx_cmd_parsed_data_t *pparsed_data)
 {
     meshx_show_beacon = pparsed_data->param_val[0];
@@ -163,10 +181,34 @@ int32_t meshx_cmd_prov_public_key(const meshx_cmd_parsed_data_t *pparsed_data)
     }
 
     meshx_prov_public_key_t pub_key;
-    meshx_prov_get_local_public_key(prov_dev, &pub_key);
-    meshx_prov_public_key(prov_dev, &pub_key);
+    int32_t ret = meshx_prov_get_local_public_key(prov_dev, &pub_key);
+    if (-MESHX_ERR_BUSY == ret)
+    {
+        /* public key is sent when it is generated */
+        meshx_prov_devs_t *pdev = meshx_cmd_prov_get_devs(prov_dev);
+        if (NULL != pdev)
+        {
+            pdev->public_key_pending = TRUE;
+        }
+        return MESHX_SUCCESS;
+    }
+    else if (MESHX_SUCCESS != ret)
+    {
+        return ret;
+    }
 
-    return MESHX_SUCCESS;
+    return meshx_prov_public_key(prov_dev, &pub_key);
+}
+
+void meshx_cmd_prov_local_public_key_ready(meshx_prov_dev_t prov_dev,
+                                           const meshx_prov_public_key_t *pkey)
+{
+    meshx_prov_devs_t *pdev = meshx_cmd_prov_get_devs(prov_dev);
+    if ((NULL != pdev) && pdev->public_key_pending)
+    {
+        pdev->public_key_pending = FALSE;
+        meshx_prov_public_key(prov_dev, pkey);
+    }
 }
 
 int32_t meshx_cmd_prov_set_auth(const meshx_cmd_parsed_data_t *pparsed_data)
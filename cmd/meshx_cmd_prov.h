@@ -15,6 +15,9 @@ MESHX_BEGIN_DECLS
 
 MESHX_EXTERN int32_t meshx_cmd_prov_add_device(meshx_prov_dev_t prov_dev);
 MESHX_EXTERN void meshx_cmd_prov_remove_device(meshx_prov_dev_t prov_dev);
+/* send public key pending on prov_pub_key command once it is generated */
+MESHX_EXTERN void meshx_cmd_prov_local_public_key_ready(meshx_prov_dev_t prov_dev,
+                                                       const meshx_prov_public_key_t *pkey);
 
 MESHX_EXTERN int32_t meshx_cmd_prov_scan(const meshx_cmd_parsed_data_t *pparsed_data);
 MESHX_EXTERN int32_t meshx_cmd_prov_conn(const meshx_cmd_parsed_data_t *pparsed_data);
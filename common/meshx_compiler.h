@@ -24,5 +24,6 @@
 
 #define __WEAK __attribute((weak)) /*!< weak keywork */
 #define __PACKED __attribute__((__packed__))  /*!< packed keyword */
+#define __ALIGNED(n) __attribute__((aligned(n)))  /*!< aligned keyword */
 
 #endif
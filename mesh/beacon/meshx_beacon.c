@@ -83,8 +83,8 @@ static void meshx_beacon_send_snb(meshx_bearer_t bearer)
             pnet_key_value = &pnet_key->key_value[1];
         }
         memcpy(snb.net_id, pnet_key_value->net_id, sizeof(meshx_net_id_t));
-        meshx_aes_cmac(pnet_key_value->beacon_key, ((uint8_t *)&snb) + 1, sizeof(meshx_snb_t) - 9,
-                       snb_auth);
+        meshx_aes_cmac_ctx(&pnet_key_value->beacon_key_ctx, ((uint8_t *)&snb) + 1,
+                           sizeof(meshx_snb_t) - 9, snb_auth);
         memcpy(snb.auth_value, snb_auth, 8);
 
         /* send snb */
@@ -266,8 +266,8 @@ int32_t meshx_beacon_receive(meshx_bearer_t bearer, const uint8_t *pdata, uint8_
                     if (0 == memcmp(pnet_key->key_value[i].net_id, psnb->net_id, sizeof(meshx_net_id_t)))
                     {
                         uint8_t snb_auth[16];
-                        meshx_aes_cmac(pnet_key->key_value[i].beacon_key, ((uint8_t *)psnb) + 1, sizeof(meshx_snb_t) - 9,
-                                       snb_auth);
+                        meshx_aes_cmac_ctx(&pnet_key->key_value[i].beacon_key_ctx, ((uint8_t *)psnb) + 1,
+                                           sizeof(meshx_snb_t) - 9, snb_auth);
                         if (0 == memcmp(psnb->auth_value, snb_auth, 8))
                         {
                             if (psnb->flag.key_refresh)
@@ -278,17 +278,15 @@ int32_t meshx_beacon_receive(meshx_bearer_t bearer, const uint8_t *pdata, uint8_
                                     ret = -MESHX_ERR_STATE;
                                     goto FINISH;
                                 }
-                                pnet_key->key_state = MESHX_KEY_STATE_PHASE2;
+                                meshx_net_key_state_transit(pnet_key->key_index, MESHX_KEY_STATE_PHASE2);
                                 meshx_app_key_state_transit(pnet_key->key_index, MESHX_KEY_STATE_PHASE2);
                             }
                             else
                             {
                                 if (1 == i)
                                 {
-                                    /* use new key, skip state phase2 */
-                                    pnet_key->key_state = MESHX_KEY_STATE_NORMAL;
-                                    /* revoke old keys */
-                                    pnet_key->key_value[0] = pnet_key->key_value[1];
+                                    /* use new key, skip state phase2, old keys are revoked */
+                                    meshx_net_key_state_transit(pnet_key->key_index, MESHX_KEY_STATE_NORMAL);
                                     meshx_app_key_state_transit(pnet_key->key_index, MESHX_KEY_STATE_NORMAL);
                                 }
                             }
@@ -5,6 +5,7 @@
  *
  * See the LICENSE file for the terms of usage and distribution.
  */
+#include <string.h>
 #define MESHX_TRACE_MODULE "MESHX_BEARER"
 #include "meshx_bearer.h"
 #include "meshx_bearer_internal.h"
@@ -14,6 +15,7 @@
 #include "meshx_gap.h"
 #include "meshx_net.h"
 #include "meshx_node_internal.h"
+#include "meshx_net_internal.h"
 
 
 int32_t meshx_bearer_init(void)
@@ -36,6 +38,11 @@ int32_t meshx_bearer_init(void)
         MESHX_WARN("gatt bearer is diabled!");
     }
 
+    if (meshx_node_params.config.ip_bearer_enable)
+    {
+        meshx_bearer_ip_init();
+    }
+
     return MESHX_SUCCESS;
 }
 
@@ -44,22 +51,118 @@ uint8_t meshx_bearer_type_get(meshx_bearer_t bearer)
     return (NULL == bearer) ? MESHX_BEARER_TYPE_INVALID : bearer->type;
 }
 
+void meshx_bearer_setup(meshx_bearer_t bearer, uint8_t type, const meshx_bearer_ops_t *pops)
+{
+    MESHX_ASSERT(NULL != bearer);
+    MESHX_ASSERT((NULL != pops) && (NULL != pops->send) && (NULL != pops->mtu_get));
+
+    bearer->type = type;
+    bearer->blocked = FALSE;
+    bearer->pops = pops;
+    memset(&bearer->stats, 0, sizeof(meshx_bearer_stats_t));
+    bearer->net_iface = NULL;
+}
+
 void meshx_bearer_delete(meshx_bearer_t bearer)
 {
     if (NULL != bearer)
     {
-        switch (bearer->type)
+        if ((NULL == bearer->pops) || (NULL == bearer->pops->delete))
+        {
+            MESHX_WARN("bearer(0x%08x) type %d can't be deleted", bearer, bearer->type);
+            return ;
+        }
+        bearer->pops->delete(bearer);
+    }
+}
+
+void meshx_bearer_tx_ready(meshx_bearer_t bearer)
+{
+    if (NULL != bearer)
+    {
+        bearer->blocked = FALSE;
+        if (NULL != bearer->net_iface)
         {
-        case MESHX_BEARER_TYPE_ADV:
-            meshx_bearer_adv_delete(bearer);
-            break;
-        case MESHX_BEARER_TYPE_GATT:
-            meshx_bearer_gatt_delete(bearer);
-            break;
-        default:
-            MESHX_WARN("invalid bearer type: %d", bearer->type);
-            break;
+            meshx_net_iface_tx_ready(bearer->net_iface);
         }
     }
 }
 
+int32_t meshx_bearer_send(meshx_bearer_t bearer, const uint8_t *pdata, uint16_t len)
+{
+    MESHX_ASSERT(NULL != bearer);
+    MESHX_ASSERT(NULL != pdata);
+
+    if (len > bearer->pops->mtu_get(bearer))
+    {
+        MESHX_ERROR("bearer(0x%08x) send failed: length %d exceeds mtu %d", bearer, len,
+                    bearer->pops->mtu_get(bearer));
+        bearer->stats.failed ++;
+        return -MESHX_ERR_LENGTH;
+    }
+
+    int32_t ret = bearer->pops->send(bearer, pdata, len);
+    if (MESHX_SUCCESS == ret)
+    {
+        bearer->stats.sent ++;
+    }
+    else if (-MESHX_ERR_BUSY == ret)
+    {
+        bearer->blocked = TRUE;
+        bearer->stats.busy ++;
+    }
+    else
+    {
+        bearer->stats.failed ++;
+    }
+
+    return ret;
+}
+
+uint16_t meshx_bearer_mtu_get(meshx_bearer_t bearer)
+{
+    return (NULL == bearer) ? 0 : bearer->pops->mtu_get(bearer);
+}
+
+uint16_t meshx_bearer_pending_get(meshx_bearer_t bearer)
+{
+    if ((NULL == bearer) || (NULL == bearer->pops->pending_get))
+    {
+        return 0;
+    }
+
+    return bearer->pops->pending_get(bearer);
+}
+
+bool meshx_bearer_is_writable(meshx_bearer_t bearer)
+{
+    return (NULL != bearer) && !bearer->blocked;
+}
+
+bool meshx_bearer_is_multi_peer(meshx_bearer_t bearer)
+{
+    return (NULL != bearer) && bearer->pops->multi_peer;
+}
+
+meshx_bearer_stats_t meshx_bearer_stats_get(meshx_bearer_t bearer)
+{
+    meshx_bearer_stats_t stats;
+    if (NULL == bearer)
+    {
+        memset(&stats, 0, sizeof(meshx_bearer_stats_t));
+    }
+    else
+    {
+        stats = bearer->stats;
+    }
+
+    return stats;
+}
+
+void meshx_bearer_stats_reset(meshx_bearer_t bearer)
+{
+    if (NULL != bearer)
+    {
+        memset(&bearer->stats, 0, sizeof(meshx_bearer_stats_t));
+    }
+}
@@ -38,6 +38,30 @@ typedef struct
 
 static meshx_bearer_adv_t bearer_adv;
 
+static int32_t meshx_bearer_adv_net_send(meshx_bearer_t bearer, const uint8_t *pdata,
+                                         uint16_t len)
+{
+    return meshx_bearer_adv_send(bearer, MESHX_BEARER_ADV_PKT_TYPE_MESH_MSG, pdata, len);
+}
+
+static uint16_t meshx_bearer_adv_mtu_get(meshx_bearer_t bearer)
+{
+    return MESHX_GAP_ADV_DATA_MAX_LEN - 2;
+}
+
+static uint16_t meshx_bearer_adv_pending_get(meshx_bearer_t bearer)
+{
+    return meshx_gap_action_pending_num();
+}
+
+static const meshx_bearer_ops_t bearer_adv_ops =
+{
+    .send = meshx_bearer_adv_net_send,
+    .mtu_get = meshx_bearer_adv_mtu_get,
+    .pending_get = meshx_bearer_adv_pending_get,
+    .delete = meshx_bearer_adv_delete,
+};
+
 int32_t meshx_bearer_adv_init(void)
 {
     MESHX_INFO("initialize adv bearer success");
@@ -52,8 +76,7 @@ meshx_bearer_t meshx_bearer_adv_create(void)
         return NULL;
     }
 
-    bearer_adv.bearer.type = MESHX_BEARER_TYPE_ADV;
-    bearer_adv.bearer.net_iface = NULL;
+    meshx_bearer_setup(&bearer_adv.bearer, MESHX_BEARER_TYPE_ADV, &bearer_adv_ops);
     MESHX_INFO("create adv bearer(0x%08x) success", &bearer_adv);
     return &bearer_adv.bearer;
 }
@@ -86,20 +109,19 @@ int32_t meshx_bearer_adv_send(meshx_bearer_t bearer, uint8_t pkt_type,
     }
 #endif
 
-    meshx_bearer_adv_pkt_t adv_data;
-    adv_data.length = len + 1;
-    adv_data.ad_type = pkt_type;
-    memcpy(adv_data.pdu, pdata, len);
-
-    MESHX_INFO("send adv data:  ");
-    MESHX_DUMP_INFO(adv_data.buffer, len + 2);
-
+    /* build adv data in gap action directly */
     meshx_gap_action_t action;
     action.action_type = MESHX_GAP_ACTION_TYPE_ADV;
     action.action_adv_data.adv_type = MESHX_GAP_ADV_TYPE_NONCONN_IND;
-    memcpy(action.action_adv_data.data, adv_data.buffer, len + 2);
+    meshx_bearer_adv_pkt_t *padv_data = (meshx_bearer_adv_pkt_t *)action.action_adv_data.data;
+    padv_data->length = len + 1;
+    padv_data->ad_type = pkt_type;
+    memcpy(padv_data->pdu, pdata, len);
     action.action_adv_data.data_len = len + 2;
 
+    MESHX_INFO("send adv data:  ");
+    MESHX_DUMP_INFO(action.action_adv_data.data, len + 2);
+
     return meshx_gap_add_action(&action);
 }
 
@@ -112,6 +134,7 @@ int32_t meshx_bearer_adv_receive(meshx_bearer_t bearer, uint8_t adv_type, const
         return -MESHX_ERR_INVAL;
     }
 
+    bearer->stats.received ++;
     int32_t ret = MESHX_SUCCESS;
     switch (adv_type)
     {
@@ -122,7 +145,7 @@ int32_t meshx_bearer_adv_receive(meshx_bearer_t bearer, uint8_t adv_type, const
             ret = -MESHX_ERR_CONNECT;
             break;
         }
-        ret = meshx_net_receive(bearer->net_iface, pdata, len);
+        ret = meshx_net_receive_adv(bearer->net_iface, pdata, len, padv_metadata);
         break;
     case MESHX_GAP_ADTYPE_PB_ADV:
         ret = meshx_prov_receive(bearer, pdata, len);
@@ -10,6 +10,7 @@
 #include "meshx_bearer_internal.h"
 #include "meshx_errno.h"
 #include "meshx_assert.h"
+#include "meshx_mem.h"
 #include "meshx_net.h"
 #include "meshx_list.h"
 #include "meshx_proxy.h"
@@ -27,6 +28,26 @@ typedef struct
 
 static meshx_list_t meshx_bearer_gatt_list;
 
+static int32_t meshx_bearer_gatt_net_send(meshx_bearer_t bearer, const uint8_t *pdata,
+                                          uint16_t len)
+{
+    return meshx_proxy_send(bearer, MESHX_PROXY_MSG_TYPE_NET, pdata, len);
+}
+
+static uint16_t meshx_bearer_gatt_net_mtu_get(meshx_bearer_t bearer)
+{
+    /* proxy protocol segments pdu that exceeds att mtu */
+    return 0xffff;
+}
+
+static const meshx_bearer_ops_t bearer_gatt_ops =
+{
+    .send = meshx_bearer_gatt_net_send,
+    .mtu_get = meshx_bearer_gatt_net_mtu_get,
+    .pending_get = NULL,
+    .delete = meshx_bearer_gatt_delete,
+};
+
 meshx_bearer_t meshx_bearer_gatt_get(uint16_t conn_handle)
 {
     meshx_list_t *pnode;
@@ -82,12 +103,45 @@ int32_t meshx_bearer_gatt_send(meshx_bearer_t bearer, uint16_t char_value_handle
 
 meshx_bearer_t meshx_bearer_gatt_create(uint16_t conn_handle)
 {
-    return NULL;
+    if (NULL != meshx_bearer_gatt_get(conn_handle))
+    {
+        MESHX_WARN("gatt bearer of connection %d already exists", conn_handle);
+        return NULL;
+    }
+
+    meshx_bearer_gatt_t *pbearer = meshx_malloc(sizeof(meshx_bearer_gatt_t));
+    if (NULL == pbearer)
+    {
+        MESHX_ERROR("create gatt bearer failed: out of memory");
+        return NULL;
+    }
+
+    meshx_bearer_setup(&pbearer->bearer, MESHX_BEARER_TYPE_GATT, &bearer_gatt_ops);
+    pbearer->conn_handle = conn_handle;
+    meshx_list_append(&meshx_bearer_gatt_list, &pbearer->node);
+    MESHX_INFO("create gatt bearer(0x%08x) of connection %d success", pbearer, conn_handle);
+
+    return &pbearer->bearer;
 }
 
 void meshx_bearer_gatt_delete(meshx_bearer_t bearer)
 {
     MESHX_ASSERT(NULL != bearer);
+    if (!meshx_bearer_gatt_exists(bearer))
+    {
+        MESHX_WARN("gatt bearer(0x%08x) doesn't exist", bearer);
+        return ;
+    }
+
+    if (NULL != bearer->net_iface)
+    {
+        meshx_net_iface_disconnect(bearer->net_iface);
+    }
+
+    meshx_bearer_gatt_t *pbearer = (meshx_bearer_gatt_t *)bearer;
+    meshx_list_remove(&pbearer->node);
+    meshx_free(pbearer);
+    MESHX_INFO("delete gatt bearer(0x%08x) success", bearer);
 }
 
 int32_t meshx_bearer_gatt_receive(meshx_bearer_t bearer, uint16_t char_value_handle,
@@ -100,6 +154,7 @@ int32_t meshx_bearer_gatt_receive(meshx_bearer_t bearer, uint16_t char_value_han
     }
     MESHX_ASSERT(NULL != pdata);
 
+    bearer->stats.received ++;
     int32_t ret;
     if (char_value_handle == meshx_proxy_char_data_in_handle())
     {
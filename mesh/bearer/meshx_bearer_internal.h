@@ -12,15 +12,43 @@
 #include "meshx_errno.h"
 #include "meshx_bearer.h"
 #include "meshx_net.h"
+#include "meshx_async_internal.h"
 
 MESHX_BEGIN_DECLS
 
+/**
+ * operations that bearer registers on creation, network layer only accesses bearer
+ * through them, so new bearer can be added without touching network layer
+ */
+typedef struct
+{
+    /**
+     * send network pdu
+     * @return -MESHX_ERR_BUSY if bearer can't accept more data, bearer shall call
+     *         meshx_bearer_tx_ready() when it becomes writable again
+     */
+    int32_t (*send)(meshx_bearer_t bearer, const uint8_t *pdata, uint16_t len);
+    /* maximum network pdu length of one send */
+    uint16_t (*mtu_get)(meshx_bearer_t bearer);
+    /* pdus waiting to be transmitted by bearer, optional */
+    uint16_t (*pending_get)(meshx_bearer_t bearer);
+    void (*delete)(meshx_bearer_t bearer);
+    /* bearer reaches several peers through one interface, relay sends pdu back onto it */
+    bool multi_peer;
+} meshx_bearer_ops_t;
+
 struct _meshx_bearer
 {
     uint8_t type;
+    bool blocked; /* last send is rejected for bearer is busy */
+    const meshx_bearer_ops_t *pops;
+    meshx_bearer_stats_t stats;
     meshx_net_iface_t net_iface;
 };
 
+MESHX_EXTERN void meshx_bearer_setup(meshx_bearer_t bearer, uint8_t type,
+                                     const meshx_bearer_ops_t *pops);
+
 
 MESHX_EXTERN int32_t meshx_bearer_adv_init(void);
 MESHX_EXTERN void meshx_bearer_adv_delete(meshx_bearer_t bearer);
@@ -29,6 +57,11 @@ MESHX_EXTERN int32_t meshx_bearer_gatt_init(void);
 MESHX_EXTERN void meshx_bearer_gatt_delete(meshx_bearer_t bearer);
 MESHX_EXTERN uint16_t meshx_bearer_gatt_mtu_get(meshx_bearer_t bearer);
 
+MESHX_EXTERN int32_t meshx_bearer_ip_init(void);
+MESHX_EXTERN void meshx_bearer_ip_delete(meshx_bearer_t bearer);
+MESHX_EXTERN void meshx_bearer_ip_async_handle_poll_timeout(meshx_async_msg_t msg);
+MESHX_EXTERN void meshx_bearer_ip_async_handle_flush(meshx_async_msg_t msg);
+
 
 
 MESHX_END_DECLS
@@ -0,0 +1,478 @@
+/**
+ * This file is part of the meshx library.
+ *
+ * Copyright 2019, Huang Yang <elious.huang@gmail.com>. All rights reserved.
+ *
+ * See the LICENSE file for the terms of usage and distribution.
+ */
+#include <string.h>
+#define MESHX_TRACE_MODULE "MESHX_BEARER_IP"
+#include "meshx_trace.h"
+#include "meshx_bearer.h"
+#include "meshx_bearer_internal.h"
+#include "meshx_errno.h"
+#include "meshx_assert.h"
+#include "meshx_list.h"
+#include "meshx_mem.h"
+#include "meshx_net.h"
+#include "meshx_timer.h"
+#include "meshx_config.h"
+#include "meshx_node_internal.h"
+#include "meshx_ip_wrapper.h"
+
+/**
+ * network pdus sent in current processing are collected and sent to all peers by one
+ * batched call, received datagrams are passed to network layer in batch, duplicated pdus
+ * from several peers are dropped by network message cache
+ */
+#define MESHX_BEARER_IP_NET_PDU_MAX_LEN          29
+/* one more byte to find out oversized datagram */
+#define MESHX_BEARER_IP_DATAGRAM_MAX_LEN         (MESHX_BEARER_IP_NET_PDU_MAX_LEN + 2)
+
+typedef struct
+{
+    uint8_t data[MESHX_BEARER_IP_DATAGRAM_MAX_LEN];
+    uint8_t len;
+} meshx_bearer_ip_pdu_t;
+
+typedef struct
+{
+    struct _meshx_bearer bearer;
+    int32_t handle;
+    meshx_ip_addr_t *ppeers;
+    uint8_t peer_num;
+    meshx_bearer_ip_pdu_t tx_pdus[MESHX_BEARER_IP_BATCH_MAX];
+    uint8_t tx_num;
+    bool flush_posted;
+    meshx_timer_t poll_timer;
+    meshx_list_t node;
+} meshx_bearer_ip_t;
+
+static meshx_list_t meshx_bearer_ip_list;
+
+static bool meshx_bearer_ip_exists(meshx_bearer_t bearer)
+{
+    meshx_list_t *pnode;
+    meshx_bearer_ip_t *pbearer;
+    meshx_list_foreach(pnode, &meshx_bearer_ip_list)
+    {
+        pbearer = MESHX_CONTAINER_OF(pnode, meshx_bearer_ip_t, node);
+        if (&pbearer->bearer == bearer)
+        {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+static bool meshx_bearer_ip_addr_equal(const meshx_ip_addr_t *paddr1,
+                                       const meshx_ip_addr_t *paddr2)
+{
+    if (paddr1->family != paddr2->family)
+    {
+        return FALSE;
+    }
+
+    if (MESHX_IP_FAMILY_UNIX == paddr1->family)
+    {
+        return (0 == strncmp(paddr1->path, paddr2->path, MESHX_IP_UNIX_PATH_MAX_LEN));
+    }
+
+    return ((paddr1->port == paddr2->port) && (0 == memcmp(paddr1->ipv4, paddr2->ipv4, 4)));
+}
+
+static int16_t meshx_bearer_ip_peer_find(const meshx_bearer_ip_t *pbearer,
+                                         const meshx_ip_addr_t *paddr)
+{
+    for (uint8_t i = 0; i < pbearer->peer_num; ++i)
+    {
+        if (meshx_bearer_ip_addr_equal(&pbearer->ppeers[i], paddr))
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * send collected pdus to all peers
+ * @return -MESHX_ERR_BUSY if socket can't accept all datagrams, unsent pdus are kept and
+ *         sent to all peers again later, peers that already got them drop the duplicates
+ */
+static int32_t meshx_bearer_ip_flush(meshx_bearer_ip_t *pbearer)
+{
+    meshx_ip_datagram_t datagrams[MESHX_BEARER_IP_BATCH_MAX];
+    uint16_t num = 0;
+    uint32_t total = pbearer->tx_num * pbearer->peer_num;
+    uint32_t sent = 0;
+    int32_t ret = MESHX_SUCCESS;
+
+    for (uint32_t i = 0; i < total; ++i)
+    {
+        const meshx_bearer_ip_pdu_t *ppdu = &pbearer->tx_pdus[i / pbearer->peer_num];
+        datagrams[num].addr = pbearer->ppeers[i % pbearer->peer_num];
+        datagrams[num].pdata = (uint8_t *)ppdu->data;
+        datagrams[num].len = ppdu->len;
+        num ++;
+        if ((MESHX_BEARER_IP_BATCH_MAX == num) || (i == total - 1))
+        {
+            ret = meshx_ip_send_batch(pbearer->handle, datagrams, num);
+            if (ret < 0)
+            {
+                break;
+            }
+            sent += ret;
+            if (ret < num)
+            {
+                ret = -MESHX_ERR_BUSY;
+                break;
+            }
+            num = 0;
+        }
+    }
+
+    if (-MESHX_ERR_BUSY == ret)
+    {
+        uint8_t done = sent / pbearer->peer_num;
+        pbearer->tx_num -= done;
+        memmove(pbearer->tx_pdus, pbearer->tx_pdus + done,
+                pbearer->tx_num * sizeof(meshx_bearer_ip_pdu_t));
+        MESHX_DEBUG("ip bearer(0x%08x) is busy: %d pdus pending", pbearer, pbearer->tx_num);
+        return ret;
+    }
+
+    if (MESHX_SUCCESS != ret)
+    {
+        /* datagram is unreliable, lost pdus are recovered by upper layer */
+        MESHX_WARN("ip bearer(0x%08x) dropped %d datagrams", pbearer, total - sent);
+    }
+    pbearer->tx_num = 0;
+
+    return MESHX_SUCCESS;
+}
+
+static void meshx_bearer_ip_retry(meshx_bearer_ip_t *pbearer)
+{
+    if ((0 != pbearer->tx_num) && (MESHX_SUCCESS != meshx_bearer_ip_flush(pbearer)))
+    {
+        return ;
+    }
+
+    if (!meshx_bearer_is_writable(&pbearer->bearer))
+    {
+        meshx_bearer_tx_ready(&pbearer->bearer);
+    }
+}
+
+static int32_t meshx_bearer_ip_send(meshx_bearer_t bearer, const uint8_t *pdata, uint16_t len)
+{
+    meshx_bearer_ip_t *pbearer = (meshx_bearer_ip_t *)bearer;
+    if (0 == pbearer->peer_num)
+    {
+        MESHX_DEBUG("ip bearer(0x%08x) has no peer", pbearer);
+        return MESHX_SUCCESS;
+    }
+
+    if ((MESHX_BEARER_IP_BATCH_MAX == pbearer->tx_num) &&
+        (MESHX_SUCCESS != meshx_bearer_ip_flush(pbearer)))
+    {
+        return -MESHX_ERR_BUSY;
+    }
+
+    meshx_bearer_ip_pdu_t *ppdu = &pbearer->tx_pdus[pbearer->tx_num];
+    ppdu->data[0] = MESHX_BEARER_IP_PKT_TYPE_NET;
+    memcpy(ppdu->data + 1, pdata, len);
+    ppdu->len = len + 1;
+    pbearer->tx_num ++;
+
+    if (!pbearer->flush_posted)
+    {
+        meshx_async_msg_t msg;
+        msg.type = MESHX_ASYNC_MSG_TYPE_BEARER_IP_FLUSH;
+        msg.pdata = pbearer;
+        msg.data_len = 0;
+        /* message may be handled before send returns */
+        pbearer->flush_posted = TRUE;
+        if (MESHX_SUCCESS != meshx_async_msg_send(&msg))
+        {
+            pbearer->flush_posted = FALSE;
+            meshx_bearer_ip_flush(pbearer);
+        }
+    }
+
+    return MESHX_SUCCESS;
+}
+
+static uint16_t meshx_bearer_ip_mtu_get(meshx_bearer_t bearer)
+{
+    return MESHX_BEARER_IP_NET_PDU_MAX_LEN;
+}
+
+static uint16_t meshx_bearer_ip_pending_get(meshx_bearer_t bearer)
+{
+    return ((meshx_bearer_ip_t *)bearer)->tx_num;
+}
+
+static const meshx_bearer_ops_t bearer_ip_ops =
+{
+    .send = meshx_bearer_ip_send,
+    .mtu_get = meshx_bearer_ip_mtu_get,
+    .pending_get = meshx_bearer_ip_pending_get,
+    .delete = meshx_bearer_ip_delete,
+    .multi_peer = TRUE,
+};
+
+static void meshx_bearer_ip_poll_timeout(void *pargs)
+{
+    meshx_async_msg_t async_msg;
+    async_msg.type = MESHX_ASYNC_MSG_TYPE_TIMEOUT_BEARER_IP_POLL;
+    async_msg.pdata = pargs;
+    async_msg.data_len = 0;
+
+    meshx_async_msg_send(&async_msg);
+}
+
+int32_t meshx_bearer_ip_init(void)
+{
+    meshx_list_init_head(&meshx_bearer_ip_list);
+    MESHX_INFO("initialize ip bearer success");
+    return MESHX_SUCCESS;
+}
+
+meshx_bearer_t meshx_bearer_ip_create(const meshx_ip_addr_t *plocal)
+{
+    if (!meshx_node_params.config.ip_bearer_enable)
+    {
+        MESHX_WARN("ip bearer is disabled!");
+        return NULL;
+    }
+
+    if (NULL == plocal)
+    {
+        MESHX_ERROR("invalid local address!");
+        return NULL;
+    }
+
+    meshx_bearer_ip_t *pbearer = meshx_malloc(sizeof(meshx_bearer_ip_t));
+    if (NULL == pbearer)
+    {
+        MESHX_ERROR("create ip bearer failed: out of memory");
+        return NULL;
+    }
+    memset(pbearer, 0, sizeof(meshx_bearer_ip_t));
+
+    if (0 != meshx_node_params.config.ip_peer_num)
+    {
+        pbearer->ppeers = meshx_malloc(meshx_node_params.config.ip_peer_num * sizeof(meshx_ip_addr_t));
+        if (NULL == pbearer->ppeers)
+        {
+            MESHX_ERROR("create ip bearer failed: out of memory");
+            meshx_free(pbearer);
+            return NULL;
+        }
+    }
+
+    if (MESHX_SUCCESS != meshx_ip_open(plocal, &pbearer->handle))
+    {
+        MESHX_ERROR("create ip bearer failed: open socket failed");
+        if (NULL != pbearer->ppeers)
+        {
+            meshx_free(pbearer->ppeers);
+        }
+        meshx_free(pbearer);
+        return NULL;
+    }
+
+    if (0 != meshx_node_params.config.ip_poll_interval)
+    {
+        if (MESHX_SUCCESS != meshx_timer_create(&pbearer->poll_timer, MESHX_TIMER_MODE_REPEATED,
+                                                meshx_bearer_ip_poll_timeout, pbearer))
+        {
+            MESHX_ERROR("create ip bearer failed: create poll timer failed");
+            meshx_ip_close(pbearer->handle);
+            if (NULL != pbearer->ppeers)
+            {
+                meshx_free(pbearer->ppeers);
+            }
+            meshx_free(pbearer);
+            return NULL;
+        }
+        meshx_timer_start(pbearer->poll_timer, meshx_node_params.config.ip_poll_interval);
+    }
+
+    meshx_bearer_setup(&pbearer->bearer, MESHX_BEARER_TYPE_IP, &bearer_ip_ops);
+    meshx_list_append(&meshx_bearer_ip_list, &pbearer->node);
+    MESHX_INFO("create ip bearer(0x%08x) success", pbearer);
+
+    return &pbearer->bearer;
+}
+
+void meshx_bearer_ip_delete(meshx_bearer_t bearer)
+{
+    MESHX_ASSERT(NULL != bearer);
+    if (!meshx_bearer_ip_exists(bearer))
+    {
+        MESHX_WARN("ip bearer(0x%08x) doesn't exist", bearer);
+        return ;
+    }
+
+    if (NULL != bearer->net_iface)
+    {
+        meshx_net_iface_disconnect(bearer->net_iface);
+    }
+
+    meshx_bearer_ip_t *pbearer = (meshx_bearer_ip_t *)bearer;
+    if (NULL != pbearer->poll_timer)
+    {
+        meshx_timer_stop(pbearer->poll_timer);
+        meshx_timer_delete(pbearer->poll_timer);
+    }
+    meshx_ip_close(pbearer->handle);
+    meshx_list_remove(&pbearer->node);
+    if (NULL != pbearer->ppeers)
+    {
+        meshx_free(pbearer->ppeers);
+    }
+    meshx_free(pbearer);
+    MESHX_INFO("delete ip bearer(0x%08x) success", bearer);
+}
+
+int32_t meshx_bearer_ip_peer_add(meshx_bearer_t bearer, const meshx_ip_addr_t *ppeer)
+{
+    if ((NULL == bearer) || (MESHX_BEARER_TYPE_IP != bearer->type) || (NULL == ppeer))
+    {
+        MESHX_ERROR("invalid parameter: bearer 0x%08x", bearer);
+        return -MESHX_ERR_INVAL;
+    }
+
+    meshx_bearer_ip_t *pbearer = (meshx_bearer_ip_t *)bearer;
+    if (meshx_bearer_ip_peer_find(pbearer, ppeer) >= 0)
+    {
+        return -MESHX_ERR_ALREADY;
+    }
+
+    if (pbearer->peer_num >= meshx_node_params.config.ip_peer_num)
+    {
+        MESHX_ERROR("add ip peer failed: peer list is full");
+        return -MESHX_ERR_RESOURCE;
+    }
+
+    /* pdus collected for previous peers are sent first */
+    if (0 != pbearer->tx_num)
+    {
+        meshx_bearer_ip_flush(pbearer);
+    }
+    pbearer->ppeers[pbearer->peer_num] = *ppeer;
+    pbearer->peer_num ++;
+
+    return MESHX_SUCCESS;
+}
+
+int32_t meshx_bearer_ip_peer_remove(meshx_bearer_t bearer, const meshx_ip_addr_t *ppeer)
+{
+    if ((NULL == bearer) || (MESHX_BEARER_TYPE_IP != bearer->type) || (NULL == ppeer))
+    {
+        MESHX_ERROR("invalid parameter: bearer 0x%08x", bearer);
+        return -MESHX_ERR_INVAL;
+    }
+
+    meshx_bearer_ip_t *pbearer = (meshx_bearer_ip_t *)bearer;
+    int16_t index = meshx_bearer_ip_peer_find(pbearer, ppeer);
+    if (index < 0)
+    {
+        return -MESHX_ERR_NOT_FOUND;
+    }
+
+    if (0 != pbearer->tx_num)
+    {
+        meshx_bearer_ip_flush(pbearer);
+    }
+    pbearer->peer_num --;
+    pbearer->ppeers[index] = pbearer->ppeers[pbearer->peer_num];
+
+    return MESHX_SUCCESS;
+}
+
+int32_t meshx_bearer_ip_receive(meshx_bearer_t bearer)
+{
+    if ((NULL == bearer) || (MESHX_BEARER_TYPE_IP != bearer->type))
+    {
+        MESHX_ERROR("invalid bearer: 0x%08x", bearer);
+        return -MESHX_ERR_INVAL;
+    }
+
+    meshx_bearer_ip_t *pbearer = (meshx_bearer_ip_t *)bearer;
+    meshx_bearer_ip_retry(pbearer);
+
+    uint8_t buffers[MESHX_BEARER_IP_BATCH_MAX][MESHX_BEARER_IP_DATAGRAM_MAX_LEN];
+    meshx_ip_datagram_t datagrams[MESHX_BEARER_IP_BATCH_MAX];
+    const uint8_t *pdus[MESHX_BEARER_IP_BATCH_MAX];
+    uint8_t lens[MESHX_BEARER_IP_BATCH_MAX];
+    int32_t total = 0;
+    int32_t num;
+
+    do
+    {
+        for (uint8_t i = 0; i < MESHX_BEARER_IP_BATCH_MAX; ++i)
+        {
+            datagrams[i].pdata = buffers[i];
+            datagrams[i].len = MESHX_BEARER_IP_DATAGRAM_MAX_LEN;
+        }
+
+        num = meshx_ip_receive_batch(pbearer->handle, datagrams, MESHX_BEARER_IP_BATCH_MAX);
+        if (num <= 0)
+        {
+            break;
+        }
+
+        uint32_t pdu_num = 0;
+        for (int32_t i = 0; i < num; ++i)
+        {
+            if ((datagrams[i].len < 2) || (datagrams[i].len > MESHX_BEARER_IP_NET_PDU_MAX_LEN + 1) ||
+                (MESHX_BEARER_IP_PKT_TYPE_NET != datagrams[i].pdata[0]))
+            {
+                MESHX_DEBUG("drop invalid datagram: length %d", datagrams[i].len);
+                continue;
+            }
+
+            if (meshx_bearer_ip_peer_find(pbearer, &datagrams[i].addr) < 0)
+            {
+                MESHX_DEBUG("drop datagram from unknown peer");
+                continue;
+            }
+
+            pdus[pdu_num] = datagrams[i].pdata + 1;
+            lens[pdu_num] = datagrams[i].len - 1;
+            pdu_num ++;
+        }
+
+        bearer->stats.received += pdu_num;
+        if ((0 != pdu_num) && (NULL != bearer->net_iface))
+        {
+            total += meshx_net_receive_batch(bearer->net_iface, pdus, lens, pdu_num);
+        }
+    } while (MESHX_BEARER_IP_BATCH_MAX == num);
+
+    return total;
+}
+
+void meshx_bearer_ip_async_handle_poll_timeout(meshx_async_msg_t msg)
+{
+    /* bearer may be deleted before message is handled */
+    if (meshx_bearer_ip_exists(msg.pdata))
+    {
+        meshx_bearer_ip_receive(msg.pdata);
+    }
+}
+
+void meshx_bearer_ip_async_handle_flush(meshx_async_msg_t msg)
+{
+    if (meshx_bearer_ip_exists(msg.pdata))
+    {
+        meshx_bearer_ip_t *pbearer = msg.pdata;
+        pbearer->flush_posted = FALSE;
+        meshx_bearer_ip_retry(pbearer);
+    }
+}
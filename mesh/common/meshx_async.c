@@ -17,6 +17,9 @@
 #include "meshx_trans_internal.h"
 #include "meshx_iv_index_internal.h"
 #include "meshx_proxy_internal.h"
+#include "meshx_security_internal.h"
+#include "meshx_net_internal.h"
+#include "meshx_bearer_internal.h"
 
 static meshx_async_msg_notify_t meshx_async_msg_notify;
 
@@ -97,6 +100,30 @@ int32_t meshx_async_msg_send(const meshx_async_msg_t *pmsg)
     return MESHX_SUCCESS;
 }
 
+void *meshx_async_msg_reserve(void)
+{
+    meshx_async_msg_list_t *pmsg_node = meshx_async_msg_request();
+    if (NULL == pmsg_node)
+    {
+        MESHX_ERROR("reserve async message failed: out of resource");
+    }
+
+    return pmsg_node;
+}
+
+void meshx_async_msg_post(void *preserved, const meshx_async_msg_t *pmsg)
+{
+    meshx_async_msg_list_t *pmsg_node = preserved;
+    pmsg_node->msg = *pmsg;
+    meshx_list_append(&async_msg_active_list, &pmsg_node->node);
+    meshx_async_msg_notify();
+}
+
+void meshx_async_msg_cancel(void *preserved)
+{
+    meshx_async_msg_release(preserved);
+}
+
 void meshx_async_msg_process(void)
 {
     meshx_list_t *pnode = meshx_list_pop(&async_msg_active_list);
@@ -130,6 +157,24 @@ void meshx_async_msg_process(void)
     case MESHX_ASYNC_MSG_TYPE_TIMEOUT_PROXY_SAR:
         meshx_proxy_async_handle_sar_timeout(pmsg->msg);
         break;
+    case MESHX_ASYNC_MSG_TYPE_ECC_JOB_DONE:
+        meshx_ecc_async_handle_job_done(pmsg->msg);
+        break;
+    case MESHX_ASYNC_MSG_TYPE_TIMEOUT_NET_RELAY:
+        meshx_net_async_handle_relay_timeout(pmsg->msg);
+        break;
+    case MESHX_ASYNC_MSG_TYPE_NET_IFACE_TX_READY:
+        meshx_net_iface_async_handle_tx_ready(pmsg->msg);
+        break;
+    case MESHX_ASYNC_MSG_TYPE_TIMEOUT_BEARER_IP_POLL:
+        meshx_bearer_ip_async_handle_poll_timeout(pmsg->msg);
+        break;
+    case MESHX_ASYNC_MSG_TYPE_BEARER_IP_FLUSH:
+        meshx_bearer_ip_async_handle_flush(pmsg->msg);
+        break;
+    case MESHX_ASYNC_MSG_TYPE_TIMEOUT_PROV_KEY_POOL:
+        meshx_prov_async_handle_key_pool_timeout(pmsg->msg);
+        break;
     default:
         MESHX_ERROR("unkonwn message type: %d", pmsg->msg.type);
         break;
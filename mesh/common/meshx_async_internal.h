@@ -19,6 +19,12 @@ MESHX_BEGIN_DECLS
 #define MESHX_ASYNC_MSG_TYPE_TIMEOUT_LOWER_TRANS_RX_INCOMPLETE         4
 #define MESHX_ASYNC_MSG_TYPE_TIMEOUT_IV_INDEX                          5
 #define MESHX_ASYNC_MSG_TYPE_TIMEOUT_PROXY_SAR                         6
+#define MESHX_ASYNC_MSG_TYPE_ECC_JOB_DONE                              7
+#define MESHX_ASYNC_MSG_TYPE_TIMEOUT_NET_RELAY                         8
+#define MESHX_ASYNC_MSG_TYPE_NET_IFACE_TX_READY                        9
+#define MESHX_ASYNC_MSG_TYPE_TIMEOUT_BEARER_IP_POLL                    10
+#define MESHX_ASYNC_MSG_TYPE_BEARER_IP_FLUSH                           11
+#define MESHX_ASYNC_MSG_TYPE_TIMEOUT_PROV_KEY_POOL                     12
 
 typedef struct
 {
@@ -32,6 +38,13 @@ typedef struct
 } meshx_async_msg_t;
 
 MESHX_EXTERN int32_t meshx_async_msg_send(const meshx_async_msg_t *pmsg);
+/**
+ * take message in stack context for result produced in other context, posting reserved
+ * message never fails, message that won't be posted shall be cancelled
+ */
+MESHX_EXTERN void *meshx_async_msg_reserve(void);
+MESHX_EXTERN void meshx_async_msg_post(void *preserved, const meshx_async_msg_t *pmsg);
+MESHX_EXTERN void meshx_async_msg_cancel(void *preserved);
 
 MESHX_END_DECLS
 
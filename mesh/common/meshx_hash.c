@@ -0,0 +1,56 @@
+/**
+ * This file is part of the meshx library.
+ *
+ * Copyright 2019, Huang Yang <elious.huang@gmail.com>. All rights reserved.
+ *
+ * See the COPYING file for the terms of usage and distribution.
+ */
+#include "meshx_hash_internal.h"
+
+uint32_t meshx_hash_u32(uint32_t key)
+{
+    uint32_t hash = key * 0x9e3779b1;
+    hash ^= hash >> 16;
+
+    return hash;
+}
+
+uint32_t meshx_hash_table_size(uint32_t entry_num)
+{
+    uint32_t table_size = 2;
+    while (table_size < 2 * entry_num)
+    {
+        table_size <<= 1;
+    }
+
+    return table_size;
+}
+
+void meshx_hash_table_remove(uint16_t *ptable, uint32_t table_mask, uint32_t slot,
+                             meshx_hash_home_t home, const void *pargs)
+{
+    uint32_t next = slot;
+    for (;;)
+    {
+        ptable[slot] = 0;
+        for (;;)
+        {
+            next = (next + 1) & table_mask;
+            if (0 == ptable[next])
+            {
+                return ;
+            }
+
+            /* value can't move before its home slot */
+            uint32_t home_slot = home(ptable[next], pargs);
+            bool keep = (slot <= next) ? ((slot < home_slot) && (home_slot <= next)) :
+                        ((slot < home_slot) || (home_slot <= next));
+            if (!keep)
+            {
+                break;
+            }
+        }
+        ptable[slot] = ptable[next];
+        slot = next;
+    }
+}
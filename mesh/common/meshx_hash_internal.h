@@ -0,0 +1,32 @@
+/**
+ * This file is part of the meshx library.
+ *
+ * Copyright 2019, Huang Yang <elious.huang@gmail.com>. All rights reserved.
+ *
+ * See the COPYING file for the terms of usage and distribution.
+ */
+#ifndef _MESHX_HASH_INTERNAL_H_
+#define _MESHX_HASH_INTERNAL_H_
+
+#include "meshx_types.h"
+
+MESHX_BEGIN_DECLS
+
+/**
+ * helpers of open addressing hash tables with linear probing, table size is power of 2,
+ * slots store 16 bits value and 0 is empty
+ */
+
+/* home slot of value stored in table */
+typedef uint32_t (*meshx_hash_home_t)(uint16_t value, const void *pargs);
+
+MESHX_EXTERN uint32_t meshx_hash_u32(uint32_t key);
+/* table size that keeps load factor no more than 0.5 */
+MESHX_EXTERN uint32_t meshx_hash_table_size(uint32_t entry_num);
+/* remove slot and move following values back, no tombstone is left */
+MESHX_EXTERN void meshx_hash_table_remove(uint16_t *ptable, uint32_t table_mask, uint32_t slot,
+                                          meshx_hash_home_t home, const void *pargs);
+
+MESHX_END_DECLS
+
+#endif /* _MESHX_HASH_INTERNAL_H_ */
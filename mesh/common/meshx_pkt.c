@@ -0,0 +1,157 @@
+/**
+ * This file is part of the meshx library.
+ *
+ * Copyright 2019, Huang Yang <elious.huang@gmail.com>. All rights reserved.
+ *
+ * See the COPYING file for the terms of usage and distribution.
+ */
+#include <string.h>
+#define MESHX_TRACE_MODULE "MESHX_PKT"
+#include "meshx_trace.h"
+#include "meshx_pkt.h"
+#include "meshx_errno.h"
+#include "meshx_mem.h"
+#include "meshx_assert.h"
+
+static meshx_pkt_t *pkt_array;
+static uint8_t *pkt_buffers;
+static meshx_list_t pkt_idle_list;
+static meshx_pkt_pool_info_t pkt_pool_info;
+
+int32_t meshx_pkt_init(uint16_t pkt_num, uint16_t pkt_size)
+{
+    meshx_list_init_head(&pkt_idle_list);
+    pkt_pool_info.num = 0;
+    pkt_pool_info.size = pkt_size;
+    pkt_pool_info.idle = 0;
+    pkt_pool_info.alloc_failed = 0;
+    if ((0 == pkt_num) || (0 == pkt_size))
+    {
+        return MESHX_SUCCESS;
+    }
+
+    pkt_array = meshx_malloc(pkt_num * sizeof(meshx_pkt_t));
+    pkt_buffers = meshx_malloc(pkt_num * pkt_size);
+    if ((NULL == pkt_array) || (NULL == pkt_buffers))
+    {
+        MESHX_ERROR("initialize packet pool failed: out of memory");
+        if (NULL != pkt_array)
+        {
+            meshx_free(pkt_array);
+            pkt_array = NULL;
+        }
+        if (NULL != pkt_buffers)
+        {
+            meshx_free(pkt_buffers);
+            pkt_buffers = NULL;
+        }
+        return -MESHX_ERR_MEM;
+    }
+
+    memset(pkt_array, 0, pkt_num * sizeof(meshx_pkt_t));
+    for (uint16_t i = 0; i < pkt_num; ++i)
+    {
+        pkt_array[i].pbuf = pkt_buffers + i * pkt_size;
+        meshx_list_append(&pkt_idle_list, &pkt_array[i].node);
+    }
+    pkt_pool_info.num = pkt_num;
+    pkt_pool_info.idle = pkt_num;
+
+    return MESHX_SUCCESS;
+}
+
+meshx_pkt_t *meshx_pkt_alloc(uint16_t headroom)
+{
+    if (headroom > pkt_pool_info.size)
+    {
+        MESHX_ERROR("invalid headroom: %d", headroom);
+        return NULL;
+    }
+
+    meshx_list_t *pnode = meshx_list_pop(&pkt_idle_list);
+    if (NULL == pnode)
+    {
+        MESHX_WARN("allocate packet failed: pool is empty");
+        pkt_pool_info.alloc_failed ++;
+        return NULL;
+    }
+    pkt_pool_info.idle --;
+
+    meshx_pkt_t *ppkt = MESHX_CONTAINER_OF(pnode, meshx_pkt_t, node);
+    ppkt->pdata = ppkt->pbuf + headroom;
+    ppkt->len = 0;
+    ppkt->ref = 1;
+
+    return ppkt;
+}
+
+meshx_pkt_t *meshx_pkt_ref(meshx_pkt_t *ppkt)
+{
+    MESHX_ASSERT(ppkt->ref > 0);
+    ppkt->ref ++;
+
+    return ppkt;
+}
+
+void meshx_pkt_release(meshx_pkt_t *ppkt)
+{
+    MESHX_ASSERT(ppkt->ref > 0);
+    ppkt->ref --;
+    if (0 == ppkt->ref)
+    {
+        meshx_list_append(&pkt_idle_list, &ppkt->node);
+        pkt_pool_info.idle ++;
+    }
+}
+
+uint16_t meshx_pkt_headroom(const meshx_pkt_t *ppkt)
+{
+    return ppkt->pdata - ppkt->pbuf;
+}
+
+uint16_t meshx_pkt_tailroom(const meshx_pkt_t *ppkt)
+{
+    return pkt_pool_info.size - meshx_pkt_headroom(ppkt) - ppkt->len;
+}
+
+uint8_t *meshx_pkt_push(meshx_pkt_t *ppkt, uint16_t len)
+{
+    if (len > meshx_pkt_headroom(ppkt))
+    {
+        MESHX_ERROR("push packet failed: headroom %d, need %d", meshx_pkt_headroom(ppkt), len);
+        return NULL;
+    }
+
+    ppkt->pdata -= len;
+    ppkt->len += len;
+
+    return ppkt->pdata;
+}
+
+uint8_t *meshx_pkt_pull(meshx_pkt_t *ppkt, uint16_t len)
+{
+    MESHX_ASSERT(len <= ppkt->len);
+    ppkt->pdata += len;
+    ppkt->len -= len;
+
+    return ppkt->pdata;
+}
+
+uint8_t *meshx_pkt_put(meshx_pkt_t *ppkt, uint16_t len)
+{
+    if (len > meshx_pkt_tailroom(ppkt))
+    {
+        MESHX_ERROR("put packet failed: tailroom %d, need %d", meshx_pkt_tailroom(ppkt), len);
+        return NULL;
+    }
+
+    uint8_t *ptail = ppkt->pdata + ppkt->len;
+    ppkt->len += len;
+
+    return ptail;
+}
+
+meshx_pkt_pool_info_t meshx_pkt_pool_info_get(void)
+{
+    return pkt_pool_info;
+}
@@ -154,6 +154,10 @@ static void meshx_run_actions(void)
             /* remove node and add to idle list */
             meshx_list_remove(pnode);
             meshx_list_append(&gap_action_list_idle, pnode);
+            if (MESHX_GAP_ACTION_TYPE_ADV == paction->gap_action.action_type)
+            {
+                meshx_bearer_tx_ready(meshx_bearer_adv_get());
+            }
         }
     }
 }
@@ -261,6 +265,11 @@ int32_t meshx_gap_add_action(const meshx_gap_action_t *paction)
     return ret;
 }
 
+uint16_t meshx_gap_action_pending_num(void)
+{
+    return meshx_list_length(&gap_action_list_active);
+}
+
 int32_t meshx_gap_handle_adv_report(const uint8_t *pdata, uint16_t len,
                                     const meshx_adv_metadata_t *padv_metadata)
 {
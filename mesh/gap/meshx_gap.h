@@ -101,6 +101,8 @@ MESHX_EXTERN int32_t meshx_gap_start(void);
 MESHX_EXTERN void meshx_gap_stop(void);
 MESHX_EXTERN int32_t meshx_gap_handle_bt_status(const meshx_gap_bt_status_t *pstatus);
 MESHX_EXTERN int32_t meshx_gap_add_action(const meshx_gap_action_t *paction);
+/* number of actions waiting to be executed */
+MESHX_EXTERN uint16_t meshx_gap_action_pending_num(void);
 MESHX_EXTERN int32_t meshx_gap_handle_adv_report(const uint8_t *pdata, uint16_t len,
                                                  const meshx_adv_metadata_t *padv_metadata);
 MESHX_EXTERN void meshx_gap_adv_done(void);
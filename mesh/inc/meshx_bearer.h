@@ -9,6 +9,7 @@
 #define _MESHX_BEARER_H_
 
 #include "meshx_gap.h"
+#include "meshx_ip_wrapper.h"
 
 MESHX_BEGIN_DECLS
 
@@ -26,17 +27,46 @@ MESHX_BEGIN_DECLS
                                                          (type == MESHX_BEARER_GATT_PKT_TYPE_BEACON) || \
                                                          (type == MESHX_BEARER_GATT_PKT_TYPE_PROV))
 
+/* first byte of ip bearer datagram */
+#define MESHX_BEARER_IP_PKT_TYPE_NET                    0
 
 
 typedef struct _meshx_bearer *meshx_bearer_t;
 
+typedef struct
+{
+    uint32_t sent; /* network pdus accepted by bearer */
+    uint32_t busy; /* network pdus rejected for bearer is busy */
+    uint32_t failed; /* network pdus bearer failed to send */
+    uint32_t received; /* pdus received from bearer */
+} meshx_bearer_stats_t;
+
 MESHX_EXTERN int32_t meshx_bearer_init(void);
 MESHX_EXTERN meshx_bearer_t meshx_bearer_adv_create(void);
 MESHX_EXTERN meshx_bearer_t meshx_bearer_gatt_create(uint16_t conn_handle);
+/**
+ * create backbone bearer that carries network pdus in udp or unix datagrams, pdus are sent
+ * to every peer, datagrams from other addresses are dropped
+ */
+MESHX_EXTERN meshx_bearer_t meshx_bearer_ip_create(const meshx_ip_addr_t *plocal);
 MESHX_EXTERN void meshx_bearer_delete(meshx_bearer_t bearer);
 MESHX_EXTERN uint8_t meshx_bearer_type_get(meshx_bearer_t bearer);
 MESHX_EXTERN meshx_bearer_t meshx_bearer_adv_get(void);
 MESHX_EXTERN meshx_bearer_t meshx_bearer_gatt_get(uint16_t conn_handle);
+/* bearer can accept more data, pdus queued by network interface will be sent */
+MESHX_EXTERN void meshx_bearer_tx_ready(meshx_bearer_t bearer);
+
+/* send network pdu through operations that bearer registers */
+MESHX_EXTERN int32_t meshx_bearer_send(meshx_bearer_t bearer, const uint8_t *pdata,
+                                       uint16_t len);
+MESHX_EXTERN uint16_t meshx_bearer_mtu_get(meshx_bearer_t bearer);
+MESHX_EXTERN uint16_t meshx_bearer_pending_get(meshx_bearer_t bearer);
+/* FALSE if bearer is busy and hasn't reported ready */
+MESHX_EXTERN bool meshx_bearer_is_writable(meshx_bearer_t bearer);
+/* TRUE if pdu received from bearer shall also be relayed to other peers of the bearer */
+MESHX_EXTERN bool meshx_bearer_is_multi_peer(meshx_bearer_t bearer);
+MESHX_EXTERN meshx_bearer_stats_t meshx_bearer_stats_get(meshx_bearer_t bearer);
+MESHX_EXTERN void meshx_bearer_stats_reset(meshx_bearer_t bearer);
 
 MESHX_EXTERN int32_t meshx_bearer_adv_send(meshx_bearer_t bearer, uint8_t pkt_type,
                                            const uint8_t *pdata, uint8_t len);
@@ -51,6 +81,16 @@ MESHX_EXTERN int32_t meshx_bearer_gatt_send(meshx_bearer_t bearer, uint16_t char
 MESHX_EXTERN int32_t meshx_bearer_gatt_receive(meshx_bearer_t bearer, uint16_t char_value_handle,
                                                const uint8_t *pdata, uint16_t len);
 
+MESHX_EXTERN int32_t meshx_bearer_ip_peer_add(meshx_bearer_t bearer, const meshx_ip_addr_t *ppeer);
+MESHX_EXTERN int32_t meshx_bearer_ip_peer_remove(meshx_bearer_t bearer,
+                                                 const meshx_ip_addr_t *ppeer);
+/**
+ * receive datagrams that have arrived, it is called by poll timer, or by application
+ * when socket is readable
+ * @return number of network pdus passed to network interface
+ */
+MESHX_EXTERN int32_t meshx_bearer_ip_receive(meshx_bearer_t bearer);
+
 MESHX_END_DECLS
 
 #endif /* _MESHX_BEARER_H_ */
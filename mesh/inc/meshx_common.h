@@ -10,6 +10,7 @@
 
 #include "meshx_types.h"
 #include "meshx_gap_wrapper.h"
+#include "meshx_security_wrapper.h"
 
 MESHX_BEGIN_DECLS
 
@@ -32,11 +33,11 @@ typedef enum
 #define MESHX_ADDRESS_ALL_PRXIES                     0xFFFC
 #define MESHX_ADDRESS_ALL_FRIENDS                    0xFFFD
 #define MESHX_ADDRESS_ALL_RELAYS                     0xFFFE
-#define MESHX_ADDRESS_ALL_NODES                      0xFFFF　
+#define MESHX_ADDRESS_ALL_NODES                      0xFFFF
 #define MESHX_ADDRESS_IS_UNASSIGNED(address)         ((address) == MESHX_ADDRESS_UNASSIGNED)
 #define MESHX_ADDRESS_IS_UNICAST(address)            ((((address) & 0x8000) == 0) && (((address) != MESHX_ADDRESS_UNASSIGNED)))
-#define MESHX_ADDRESS_IS_VIRTUAL(address)            (((address) & 0xC000) == 0x8000))
-#define MESHX_ADDRESS_IS_GROUP(address)              (((address) & 0xC000) == 0xC000))
+#define MESHX_ADDRESS_IS_VIRTUAL(address)            (((address) & 0xC000) == 0x8000)
+#define MESHX_ADDRESS_IS_GROUP(address)              (((address) & 0xC000) == 0xC000)
 #define MESHX_ADDRESS_IS_RFU(address)                (((address) >= 0xFF00) && ((address) <= 0xFFFB))
 #define MESHX_ADDRESS_IS_VALID(address)              ((0 != (address)) && (!MESHX_ADDRESS_IS_RFU(address)))
 
@@ -64,6 +65,10 @@ typedef struct
     meshx_key_t encryption_key;
     meshx_key_t privacy_key;
     meshx_net_id_t net_id;
+    /* expanded keys, calculated when key is added or updated */
+    meshx_aes_cmac_ctx_t beacon_key_ctx;
+    meshx_aes128_ctx_t encryption_key_ctx;
+    meshx_aes128_ctx_t privacy_key_ctx;
 } meshx_net_key_value_t;
 
 typedef struct
@@ -77,6 +82,7 @@ typedef struct
 {
     meshx_key_t app_key;
     uint8_t aid; /* least significant 6 bits */
+    meshx_aes128_ctx_t app_key_ctx;
 } meshx_app_key_value_t;
 
 typedef struct
@@ -92,6 +98,7 @@ typedef struct
     uint16_t primary_addr;
     uint8_t element_num;
     meshx_key_t dev_key;
+    meshx_aes128_ctx_t dev_key_ctx;
 } meshx_device_key_t;
 
 typedef void *meshx_net_iface_t;
@@ -124,8 +131,8 @@ typedef struct
             uint8_t aid : 6;
             union
             {
-                const meshx_key_t *papp_key;
-                const meshx_key_t *pdev_key;
+                const meshx_app_key_value_t *papp_key;
+                const meshx_device_key_t *pdev_key;
             };
         };
 
@@ -142,6 +149,7 @@ typedef struct
 #define MESHX_BEARER_TYPE_INVALID           0
 #define MESHX_BEARER_TYPE_ADV               1
 #define MESHX_BEARER_TYPE_GATT              2
+#define MESHX_BEARER_TYPE_IP                3
 
 typedef struct
 {
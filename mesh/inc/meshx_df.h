@@ -0,0 +1,59 @@
+/**
+ * This file is part of the meshx library.
+ *
+ * Copyright 2019, Huang Yang <elious.huang@gmail.com>. All rights reserved.
+ *
+ * See the COPYING file for the terms of usage and distribution.
+ */
+#ifndef _MESHX_DF_H_
+#define _MESHX_DF_H_
+
+#include "meshx_common.h"
+
+MESHX_BEGIN_DECLS
+
+/* transport control opcodes of directed forwarding */
+#define MESHX_DF_OPCODE_PATH_REQUEST          0x0B
+#define MESHX_DF_OPCODE_PATH_REPLY            0x0C
+#define MESHX_DF_OPCODE_PATH_CONFIRMATION     0x0D
+
+#define MESHX_DF_OPCODE_IS_VALID(opcode)      (((opcode) >= MESHX_DF_OPCODE_PATH_REQUEST) && \
+                                               ((opcode) <= MESHX_DF_OPCODE_PATH_CONFIRMATION))
+
+/* relay decision of network pdu sent to unicast address */
+#define MESHX_DF_RELAY_FLOOD                  0 /* no path, relay as managed flooding */
+#define MESHX_DF_RELAY_FORWARD                1 /* node is on the path */
+#define MESHX_DF_RELAY_SUPPRESS               2 /* path exists and node is not on it */
+
+typedef struct
+{
+    uint32_t requests; /* path requests originated or forwarded */
+    uint32_t replies; /* path replies originated or forwarded */
+    uint32_t confirmations; /* path confirmations originated or forwarded */
+    uint32_t forwarded; /* pdus relayed along established path */
+    uint32_t suppressed; /* pdus not relayed for node is off the path */
+    uint32_t flooded; /* pdus relayed by fallback flooding */
+    uint32_t table_full; /* paths that can't be recorded */
+} meshx_df_info_t;
+
+MESHX_EXTERN int32_t meshx_df_init(void);
+MESHX_EXTERN void meshx_df_deinit(void);
+MESHX_EXTERN void meshx_df_clear(void);
+/**
+ * start path discovery if there is no path from source to destination, called before
+ * access message is sent
+ */
+MESHX_EXTERN void meshx_df_path_check(const meshx_msg_ctx_t *pmsg_tx_ctx);
+/**
+ * decide whether network pdu sent to other unicast address is relayed, only called for pdu
+ * that can be relayed
+ * @return MESHX_DF_RELAY_xxx
+ */
+MESHX_EXTERN uint8_t meshx_df_relay_check(uint16_t src, uint16_t dst);
+MESHX_EXTERN int32_t meshx_df_receive(const uint8_t *pdata, uint16_t len,
+                                      const meshx_msg_ctx_t *pmsg_rx_ctx);
+MESHX_EXTERN meshx_df_info_t meshx_df_info_get(void);
+
+MESHX_END_DECLS
+
+#endif /* _MESHX_DF_H_ */
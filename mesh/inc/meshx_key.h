@@ -25,6 +25,16 @@ MESHX_EXTERN int32_t meshx_app_key_delte(uint16_t net_key_index, uint16_t app_ke
 MESHX_EXTERN void meshx_app_key_clear(void);
 MESHX_EXTERN int32_t meshx_app_key_state_transit(uint16_t net_key_index,
                                                  meshx_key_state_t key_state);
+/**
+ * traverse app key values that aid matches, key values bound to the net key that
+ * pnet_key belongs to are the first
+ */
+MESHX_EXTERN void meshx_app_key_aid_traverse_start(uint8_t aid,
+                                                   const meshx_net_key_value_t *pnet_key,
+                                                   const meshx_app_key_value_t **ptraverse_key);
+MESHX_EXTERN void meshx_app_key_aid_traverse_continue(uint8_t aid,
+                                                      const meshx_net_key_value_t *pnet_key,
+                                                      const meshx_app_key_value_t **ptraverse_key);
 
 MESHX_EXTERN int32_t meshx_net_key_init(void);
 MESHX_EXTERN const meshx_net_key_t *meshx_net_key_get(uint16_t net_key_index);
@@ -34,6 +44,15 @@ MESHX_EXTERN void meshx_net_key_traverse_continue(meshx_net_key_t **ptraverse_ke
 MESHX_EXTERN int32_t meshx_net_key_add(uint16_t net_key_index, meshx_key_t net_key);
 MESHX_EXTERN int32_t meshx_net_key_update(uint16_t net_key_index, meshx_key_t net_key);
 MESHX_EXTERN int32_t meshx_net_key_delete(uint16_t net_key_index);
+MESHX_EXTERN int32_t meshx_net_key_state_transit(uint16_t net_key_index,
+                                                 meshx_key_state_t key_state);
+/**
+ * traverse net key values that nid matches, the most recently hit key value is the first
+ */
+MESHX_EXTERN void meshx_net_key_nid_traverse_start(uint8_t nid,
+                                                   const meshx_net_key_value_t **ptraverse_key);
+MESHX_EXTERN void meshx_net_key_nid_traverse_continue(const meshx_net_key_value_t **ptraverse_key);
+MESHX_EXTERN void meshx_net_key_nid_hit(const meshx_net_key_value_t *pkey_value);
 MESHX_EXTERN void meshx_net_key_clear(void);
 
 MESHX_EXTERN int32_t meshx_dev_key_init(void);
@@ -16,6 +16,11 @@ MESHX_BEGIN_DECLS
 MESHX_EXTERN int32_t meshx_lower_trans_init(void);
 MESHX_EXTERN int32_t meshx_lower_trans_send(const uint8_t *pupper_trans_pdu, uint16_t len,
                                             meshx_msg_ctx_t *pmsg_tx_ctx);
+/**
+ * send upper transport pdu in packet buffer, lower transport header is pushed into headroom,
+ * segmented message holds a reference of the packet until it is acknowledged or timeout
+ */
+MESHX_EXTERN int32_t meshx_lower_trans_send_pkt(meshx_pkt_t *ppkt, meshx_msg_ctx_t *pmsg_tx_ctx);
 MESHX_EXTERN int32_t meshx_lower_trans_receive(uint8_t *pdata, uint8_t len,
                                                meshx_msg_ctx_t *pmsg_rx_ctx);
 
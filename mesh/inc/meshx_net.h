@@ -9,6 +9,7 @@
 #define _MESHX_NET_H_
 
 #include "meshx_bearer.h"
+#include "meshx_pkt.h"
 
 MESHX_BEGIN_DECLS
 
@@ -18,10 +19,17 @@ MESHX_BEGIN_DECLS
 #define MESHX_NET_IFACE_TYPE_ADV               1
 #define MESHX_NET_IFACE_TYPE_GATT              2
 #define MESHX_NET_IFACE_TYPE_LOOPBACK          3
+#define MESHX_NET_IFACE_TYPE_BEARER            4 /* other bearers that registered operations */
+
+#define MESHX_NET_PROXY_FILTER_TYPE_ACCEPT     0 /* white list */
+#define MESHX_NET_PROXY_FILTER_TYPE_REJECT     1 /* black list */
 
 
 typedef struct
 {
+    const uint8_t *pdata; /* raw network pdu */
+    uint8_t len;
+    const meshx_adv_metadata_t *padv_metadata; /* NULL if pdu is not received by advertising */
 } meshx_net_iface_ifilter_data_t;
 
 typedef struct
@@ -36,7 +44,37 @@ typedef struct
     uint32_t filtered_receive;
     uint32_t total_send;
     uint32_t filtered_send;
-} meshx_net_iface_filter_info_t;;
+    uint32_t queued_send; /* pdus queued for bearer is busy */
+    uint32_t dropped_send; /* pdus dropped for tx queue is full */
+    uint32_t blocked_send; /* times that tx queue reached high watermark */
+} meshx_net_iface_filter_info_t;
+
+/* counters of network layer pipeline on interface */
+typedef struct
+{
+    uint32_t received; /* pdus received from bearer */
+    uint32_t filtered; /* pdus dropped by input filter */
+    uint32_t low_rssi; /* advertising reports below rssi floor */
+    uint32_t adv_duplicated; /* advertising reports whose payload is seen recently */
+    uint32_t invalid_length;
+    uint32_t no_nid_match; /* no net key matches nid */
+    uint32_t decrypt_failed; /* no net key that matches nid can authenticate pdu */
+    uint32_t invalid_address;
+    uint32_t duplicated; /* pdus found in network message cache or replay protection list */
+    uint32_t delivered; /* pdus delivered to lower transport */
+    uint32_t relay_candidates; /* pdus handed to relay */
+    uint32_t sent; /* pdus accepted by bearer */
+    uint32_t bearer_error; /* pdus that bearer failed to send */
+} meshx_net_iface_stats_t;
+
+typedef struct
+{
+    uint32_t relayed; /* pdus that have been relayed */
+    uint32_t ttl_dropped; /* pdus that can't be relayed for ttl is less than 2 */
+    uint32_t queue_full; /* pdus that dropped for relay queue is full */
+    uint32_t held; /* relay transmits postponed for bearer backlog */
+    uint32_t mtu_exceeded; /* relay transmits skipped for pdu exceeds bearer mtu */
+} meshx_net_relay_info_t;
 
 
 /**
@@ -59,16 +97,54 @@ MESHX_EXTERN void meshx_net_iface_disconnect(meshx_net_iface_t net_iface);
 MESHX_EXTERN bool meshx_net_iface_is_connect(meshx_net_iface_t net_iface);
 MESHX_EXTERN meshx_net_iface_t meshx_net_iface_get(meshx_bearer_t bearer);
 MESHX_EXTERN uint8_t meshx_net_iface_type(meshx_net_iface_t net_iface);
+MESHX_EXTERN meshx_bearer_t meshx_net_iface_get_bearer(meshx_net_iface_t net_iface);
 MESHX_EXTERN void meshx_net_iface_traverse_start(meshx_net_iface_t *ptraverse_net_iface);
 MESHX_EXTERN void meshx_net_iface_traverse_continue(meshx_net_iface_t *ptraverse_net_iface);
 
+/**
+ * receive network pdu from advertising report, metadata is passed to input filter, reports
+ * below rssi floor and repeated payloads are dropped before network processing
+ */
+MESHX_EXTERN int32_t meshx_net_receive_adv(meshx_net_iface_t net_iface, const uint8_t *pdata,
+                                           uint8_t len, const meshx_adv_metadata_t *padv_metadata);
 MESHX_EXTERN int32_t meshx_net_receive(meshx_net_iface_t net_iface, const uint8_t *pdata,
                                        uint8_t len);
+/**
+ * receive several network pdus, privacy and decryption of pdus are processed together,
+ * pdus are delivered to lower transport layer in arrival order
+ * @return number of pdus that have been received by network layer
+ */
+MESHX_EXTERN int32_t meshx_net_receive_batch(meshx_net_iface_t net_iface,
+                                             const uint8_t *const pdata[], const uint8_t len[],
+                                             uint32_t num);
+/* times that network pdu failed to decrypt with net key whose nid matches */
+MESHX_EXTERN uint32_t meshx_net_decrypt_failed_count_get(void);
+MESHX_EXTERN meshx_net_relay_info_t meshx_net_relay_info_get(void);
 MESHX_EXTERN int32_t meshx_net_send(const uint8_t *ptrans_pdu, uint8_t trans_pdu_len,
                                     const meshx_msg_ctx_t *pmsg_tx_ctx);
+/**
+ * send transport pdu in packet buffer, net header and net mic are added to the packet,
+ * encryption and obfuscation are done in place
+ */
+MESHX_EXTERN int32_t meshx_net_send_pkt(meshx_pkt_t *ppkt, const meshx_msg_ctx_t *pmsg_tx_ctx);
 
 MESHX_EXTERN meshx_net_iface_filter_info_t meshx_net_iface_get_filter_info(
     meshx_net_iface_t net_iface);
+MESHX_EXTERN meshx_net_iface_stats_t meshx_net_iface_stats_get(meshx_net_iface_t net_iface);
+MESHX_EXTERN void meshx_net_iface_stats_reset(meshx_net_iface_t net_iface);
+
+/**
+ * proxy filter of gatt network interface, pdus whose destination doesn't pass the filter
+ * are dropped before sent to bearer. filter is reset to empty accept list when bearer is
+ * connected, so nothing is sent until proxy client adds addresses
+ */
+MESHX_EXTERN int32_t meshx_net_iface_proxy_filter_type_set(meshx_net_iface_t net_iface,
+                                                           uint8_t filter_type);
+MESHX_EXTERN uint8_t meshx_net_iface_proxy_filter_type_get(meshx_net_iface_t net_iface);
+MESHX_EXTERN int32_t meshx_net_iface_proxy_filter_add(meshx_net_iface_t net_iface, uint16_t addr);
+MESHX_EXTERN int32_t meshx_net_iface_proxy_filter_remove(meshx_net_iface_t net_iface,
+                                                         uint16_t addr);
+MESHX_EXTERN uint16_t meshx_net_iface_proxy_filter_size(meshx_net_iface_t net_iface);
 
 MESHX_END_DECLS
 
@@ -16,6 +16,7 @@ typedef struct
 {
     uint16_t src;
     uint32_t seq;
+    uint32_t iv_index;
 } meshx_nmc_t;
 
 MESHX_EXTERN int32_t meshx_nmc_init(void);
@@ -23,6 +24,11 @@ MESHX_EXTERN void meshx_nmc_deinit(void);
 MESHX_EXTERN int32_t meshx_nmc_add(meshx_nmc_t nmc);
 MESHX_EXTERN void meshx_nmc_clear(void);
 MESHX_EXTERN bool meshx_nmc_check(meshx_nmc_t nmc);
+/**
+ * check and add message to cache in one lookup
+ * @return TRUE: message is not cached and has been added, FALSE: message is cached
+ */
+MESHX_EXTERN bool meshx_nmc_check_add(meshx_nmc_t nmc);
 
 MESHX_END_DECLS
 
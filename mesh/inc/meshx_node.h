@@ -19,15 +19,41 @@ typedef struct
     meshx_dev_uuid_t dev_uuid;
     bool adv_bearer_enable;
     bool gatt_bearer_enable;
+    uint8_t element_num; /* elements use continuous unicast addresses from node address */
     uint16_t net_key_num;
     uint16_t app_key_num;
     uint16_t dev_key_num;
     uint16_t nmc_size;
     uint16_t rpl_size;
+    bool rpl_full_iv_update; /* start iv update when replay protection list evicts source */
     uint8_t gap_task_num;
     uint8_t trans_tx_task_num;
     uint8_t trans_rx_task_num;
     uint8_t trans_tx_retry_times;
+    uint8_t crypto_worker_num; /* 0 means ecc is processed in stack thread */
+    uint8_t prov_key_pool_size; /* pre-generated provision key pairs, not used with sample data */
+    uint8_t relay_queue_size; /* network pdus waiting to be relayed */
+    uint16_t relay_delay_max; /* maximum random delay before relay, unit is ms */
+    bool loopback_fast_path; /* deliver pdus sent to myself without encryption */
+    uint16_t pkt_num; /* packet buffers shared by network and transport layer */
+    uint16_t pkt_size; /* include MESHX_PKT_HEADROOM */
+    uint16_t sub_group_num; /* subscribed group addresses */
+    uint8_t sub_virtual_num; /* subscribed label uuids */
+    uint16_t proxy_filter_size; /* addresses in proxy filter of each gatt interface */
+    uint8_t net_tx_queue_size; /* pdus waiting for busy bearer on each interface */
+    uint8_t net_tx_high_watermark; /* interface would block when queued pdus reach it */
+    uint8_t net_tx_low_watermark; /* interface is writable again when queued pdus fall to it */
+    int8_t adv_rssi_floor; /* advertising reports with lower rssi are dropped */
+    uint8_t adv_dedup_size; /* recently received payloads remembered by advertising interface */
+    uint16_t adv_dedup_window; /* ms, repeated payload is dropped within the window */
+    bool ip_bearer_enable;
+    uint8_t ip_peer_num; /* peers of each ip bearer */
+    uint16_t ip_poll_interval; /* ms, 0 means application calls meshx_bearer_ip_receive */
+    bool df_enable; /* directed forwarding, only nodes on the path relay unicast pdus */
+    uint16_t df_table_size; /* paths remembered by directed forwarding */
+    bool df_flood_fallback; /* flood unicast pdus that have no established path */
+    uint16_t df_path_lifetime; /* unit is second */
+    uint16_t df_discovery_timeout; /* ms, path is discovered again after timeout */
 } meshx_node_config_t;
 
 /* parameters can be changed in runtime */
@@ -39,6 +65,9 @@ typedef struct
     uint32_t snb_interval; /* unit is 100ms */
     uint8_t trans_retrans_count;
     uint8_t default_ttl;
+    bool relay_enable;
+    uint8_t relay_retrans_count;
+    uint16_t relay_retrans_interval; /* unit is ms */
 } meshx_node_param_t;
 
 typedef enum
@@ -48,6 +77,9 @@ typedef enum
     MESHX_NODE_PARAM_TYPE_SNB_INTERVAL,
     MESHX_NODE_PARAM_TYPE_TRANS_RETRANS_COUNT,
     MESHX_NODE_PARAM_TYPE_DEFAULT_TTL,
+    MESHX_NODE_PARAM_TYPE_RELAY_ENABLE,
+    MESHX_NODE_PARAM_TYPE_RELAY_RETRANS_COUNT,
+    MESHX_NODE_PARAM_TYPE_RELAY_RETRANS_INTERVAL,
 } meshx_node_param_type_t;
 
 
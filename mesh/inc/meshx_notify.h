@@ -29,6 +29,7 @@ typedef enum
     MESHX_PROV_NOTIFY_DATA, /* @ref meshx_prov_data_t */
     MESHX_PROV_NOTIFY_COMPLETE, /* @ref NULL */
     MESHX_PROV_NOTIFY_FAILED, /* @ref meshx provisison failed error code macros */
+    MESHX_PROV_NOTIFY_LOCAL_PUBLIC_KEY, /* @ref meshx_prov_public_key_t */
 } meshx_prov_notify_type_t;
 
 typedef struct
@@ -0,0 +1,58 @@
+/**
+ * This file is part of the meshx library.
+ *
+ * Copyright 2019, Huang Yang <elious.huang@gmail.com>. All rights reserved.
+ *
+ * See the COPYING file for the terms of usage and distribution.
+ */
+#ifndef _MESHX_PKT_H_
+#define _MESHX_PKT_H_
+
+#include "meshx_types.h"
+#include "meshx_list.h"
+
+MESHX_BEGIN_DECLS
+
+/**
+ * packet buffer shared by layers, lower layers push their headers into headroom and
+ * upper layers put their data and mic into tailroom, buffer is returned to pool when
+ * the last reference is released
+ */
+typedef struct
+{
+    uint8_t *pdata; /* first byte of valid data */
+    uint16_t len; /* length of valid data */
+    uint8_t ref;
+    uint8_t *pbuf;
+    meshx_list_t node;
+} meshx_pkt_t;
+
+typedef struct
+{
+    uint16_t num;
+    uint16_t size;
+    uint16_t idle;
+    uint32_t alloc_failed;
+} meshx_pkt_pool_info_t;
+
+MESHX_EXTERN int32_t meshx_pkt_init(uint16_t pkt_num, uint16_t pkt_size);
+/**
+ * allocate packet buffer with empty data and reserved headroom
+ * @return NULL if pool is empty
+ */
+MESHX_EXTERN meshx_pkt_t *meshx_pkt_alloc(uint16_t headroom);
+MESHX_EXTERN meshx_pkt_t *meshx_pkt_ref(meshx_pkt_t *ppkt);
+MESHX_EXTERN void meshx_pkt_release(meshx_pkt_t *ppkt);
+MESHX_EXTERN uint16_t meshx_pkt_headroom(const meshx_pkt_t *ppkt);
+MESHX_EXTERN uint16_t meshx_pkt_tailroom(const meshx_pkt_t *ppkt);
+/* extend data at head, return new data start, NULL if headroom is not enough */
+MESHX_EXTERN uint8_t *meshx_pkt_push(meshx_pkt_t *ppkt, uint16_t len);
+/* remove data from head, return new data start */
+MESHX_EXTERN uint8_t *meshx_pkt_pull(meshx_pkt_t *ppkt, uint16_t len);
+/* extend data at tail, return start of extended data, NULL if tailroom is not enough */
+MESHX_EXTERN uint8_t *meshx_pkt_put(meshx_pkt_t *ppkt, uint16_t len);
+MESHX_EXTERN meshx_pkt_pool_info_t meshx_pkt_pool_info_get(void);
+
+MESHX_END_DECLS
+
+#endif /* _MESHX_PKT_H_ */
@@ -233,6 +233,14 @@ typedef struct
 
 typedef struct _meshx_prov_dev *meshx_prov_dev_t;
 
+typedef struct
+{
+    uint8_t size;
+    uint8_t ready; /* key pairs can be used now */
+    uint32_t hit;
+    uint32_t miss; /* key pair is generated on demand */
+} meshx_prov_key_pool_info_t;
+
 MESHX_EXTERN int32_t meshx_prov_init(void);
 
 MESHX_EXTERN meshx_prov_dev_t meshx_prov_create_device(meshx_bearer_t bearer,
@@ -240,6 +248,7 @@ MESHX_EXTERN meshx_prov_dev_t meshx_prov_create_device(meshx_bearer_t bearer,
 MESHX_EXTERN uint8_t meshx_prov_get_device_id(meshx_prov_dev_t prov_dev);
 
 MESHX_EXTERN int32_t meshx_prov_make_key(meshx_prov_dev_t prov_dev);
+MESHX_EXTERN meshx_prov_key_pool_info_t meshx_prov_key_pool_info_get(void);
 MESHX_EXTERN bool meshx_prov_validate_public_key(const meshx_prov_public_key_t *pkey);
 MESHX_EXTERN int32_t meshx_prov_get_local_public_key(meshx_prov_dev_t prov_dev,
                                                      meshx_prov_public_key_t *pkey);
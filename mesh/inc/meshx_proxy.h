@@ -17,6 +17,11 @@ MESHX_BEGIN_DECLS
 #define MESHX_PROXY_MSG_TYPE_PROXY_CFG          2
 #define MESHX_PROXY_MSG_TYPE_PROV               3
 
+#define MESHX_PROXY_CFG_OPCODE_SET_FILTER_TYPE  0x00
+#define MESHX_PROXY_CFG_OPCODE_ADD_ADDR         0x01
+#define MESHX_PROXY_CFG_OPCODE_REMOVE_ADDR      0x02
+#define MESHX_PROXY_CFG_OPCODE_FILTER_STATUS    0x03
+
 int32_t meshx_proxy_init(void);
 int32_t meshx_proxy_send(meshx_bearer_t bearer, uint8_t msg_type, const uint8_t *pdata,
                          uint16_t len);
@@ -6,7 +6,7 @@
  * See the COPYING file for the terms of usage and distribution.
  */
 #ifndef _MESHX_RPL_H_
-#define _MESHX_RPLH_
+#define _MESHX_RPL_H_
 
 #include "meshx_types.h"
 
@@ -24,7 +24,16 @@ MESHX_EXTERN void meshx_rpl_deinit(void);
 MESHX_EXTERN int32_t meshx_rpl_update(meshx_rpl_t rpl);
 MESHX_EXTERN void meshx_rpl_clear(void);
 MESHX_EXTERN bool meshx_rpl_check(meshx_rpl_t rpl);
+/**
+ * check and update replay protection list in one lookup
+ * @return TRUE: message is not replayed and list has been updated
+ */
+MESHX_EXTERN bool meshx_rpl_check_update(meshx_rpl_t rpl);
 MESHX_EXTERN bool meshx_rpl_is_full(void);
+/* number of sources evicted because list is full */
+MESHX_EXTERN uint32_t meshx_rpl_evict_count_get(void);
+/* number of iv update procedures failed to start because list is full */
+MESHX_EXTERN uint32_t meshx_rpl_iv_update_fail_count_get(void);
 
 MESHX_END_DECLS
 
@@ -17,9 +17,9 @@ MESHX_BEGIN_DECLS
 
 MESHX_EXTERN int32_t meshx_seq_init(uint8_t element_num);
 MESHX_EXTERN void meshx_seq_deinit(void);
-MESHX_EXTERN uint32_t meshx_seq_get(uint8_t element_index);
-MESHX_EXTERN uint32_t meshx_seq_set(uint8_t element_index, uint32_t seq);
-MESHX_EXTERN uint32_t meshx_seq_use(uint8_t element_index);
+MESHX_EXTERN uint32_t meshx_seq_get(uint16_t element_index);
+MESHX_EXTERN uint32_t meshx_seq_set(uint16_t element_index, uint32_t seq);
+MESHX_EXTERN uint32_t meshx_seq_use(uint16_t element_index);
 MESHX_EXTERN void meshx_seq_clear(void);
 
 MESHX_END_DECLS
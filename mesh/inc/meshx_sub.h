@@ -0,0 +1,38 @@
+/**
+ * This file is part of the meshx library.
+ *
+ * Copyright 2019, Huang Yang <elious.huang@gmail.com>. All rights reserved.
+ *
+ * See the COPYING file for the terms of usage and distribution.
+ */
+#ifndef _MESHX_SUB_H_
+#define _MESHX_SUB_H_
+
+#include "meshx_types.h"
+
+MESHX_BEGIN_DECLS
+
+MESHX_EXTERN int32_t meshx_sub_init(void);
+MESHX_EXTERN void meshx_sub_deinit(void);
+/* subscriptions are reference counted, the same address can be added by several models */
+MESHX_EXTERN int32_t meshx_sub_group_add(uint16_t group_addr);
+MESHX_EXTERN int32_t meshx_sub_group_remove(uint16_t group_addr);
+MESHX_EXTERN int32_t meshx_sub_virtual_add(const uint8_t label_uuid[16], uint16_t *pvirtual_addr);
+MESHX_EXTERN int32_t meshx_sub_virtual_remove(const uint8_t label_uuid[16]);
+MESHX_EXTERN void meshx_sub_clear(void);
+/**
+ * check whether group or virtual address is subscribed
+ * @note fixed group addresses are not included
+ */
+MESHX_EXTERN bool meshx_sub_is_subscribed(uint16_t addr);
+/**
+ * traverse subscribed label uuids that virtual address matches
+ */
+MESHX_EXTERN void meshx_sub_label_traverse_start(uint16_t virtual_addr,
+                                                 const uint8_t **ptraverse_label);
+MESHX_EXTERN void meshx_sub_label_traverse_continue(uint16_t virtual_addr,
+                                                    const uint8_t **ptraverse_label);
+
+MESHX_END_DECLS
+
+#endif /* _MESHX_SUB_H_ */
@@ -24,6 +24,14 @@
 
 /* network interface */
 #define MESHX_NET_IFACE_MAX_NUM                    9
+/* network pdus processed together by meshx_net_receive_batch */
+#define MESHX_NET_RECEIVE_BATCH_MAX                16
+/* packet buffer headroom for network and lower transport headers */
+#define MESHX_PKT_HEADROOM                         16
+/* hot counters are aligned to cache line */
+#define MESHX_CACHE_LINE_SIZE                      64
+/* network pdus sent or received by ip bearer in one batch */
+#define MESHX_BEARER_IP_BATCH_MAX                  16
 
 #define MESHX_REDUNDANCY_CHECK                     1
 
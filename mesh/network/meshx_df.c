@@ -0,0 +1,458 @@
+/**
+ * This file is part of the meshx library.
+ *
+ * Copyright 2019, Huang Yang <elious.huang@gmail.com>. All rights reserved.
+ *
+ * See the COPYING file for the terms of usage and distribution.
+ */
+#include <string.h>
+#define MESHX_TRACE_MODULE "MESHX_DF"
+#include "meshx_df.h"
+#include "meshx_trace.h"
+#include "meshx_errno.h"
+#include "meshx_mem.h"
+#include "meshx_misc.h"
+#include "meshx_seq.h"
+#include "meshx_iv_index.h"
+#include "meshx_endianness.h"
+#include "meshx_lower_trans.h"
+#include "meshx_node_internal.h"
+#include "meshx_hash_internal.h"
+#include "meshx_net_internal.h"
+
+/**
+ * directed forwarding: origin floods path request hop by hop, every node remembers the
+ * neighbor it heard the request from, target answers with path reply which goes back
+ * through remembered neighbors and marks them on the path, then origin floods path
+ * confirmation so that nodes off the path know the path exists and stop relaying.
+ * control messages are sent with ttl 0 and re-originated by each node.
+ *
+ * paths are stored in open addressing hash table with linear probing keyed by
+ * (origin, target), slot whose origin is unassigned has never been used and ends probing,
+ * expired paths are reused by insertion but kept in probe sequence
+ */
+#define MESHX_DF_PATH_STATE_FREE              0
+#define MESHX_DF_PATH_STATE_DISCOVERING       1
+#define MESHX_DF_PATH_STATE_ESTABLISHED       2
+
+typedef struct
+{
+    uint16_t origin;
+    uint16_t target;
+    uint16_t upstream; /* neighbor that path request is received from */
+    uint8_t forwarding_number;
+    uint8_t state : 2;
+    uint8_t on_path : 1;
+    uint32_t expire; /* ms */
+} meshx_df_path_t;
+
+typedef struct
+{
+    uint16_t origin;
+    uint16_t target;
+    uint8_t forwarding_number;
+} __PACKED meshx_df_path_pdu_t;
+
+static meshx_df_path_t *df_table;
+static uint32_t df_table_mask;
+static uint8_t df_forwarding_number;
+static meshx_df_info_t df_info;
+
+int32_t meshx_df_init(void)
+{
+    if (NULL != df_table)
+    {
+        MESHX_ERROR("directed forwarding already initialized");
+        return -MESHX_ERR_ALREADY;
+    }
+
+    if (!meshx_node_params.config.df_enable)
+    {
+        return MESHX_SUCCESS;
+    }
+
+    uint16_t path_num = meshx_node_params.config.df_table_size;
+    if (0 == path_num)
+    {
+        MESHX_ERROR("initialize directed forwarding failed: invalid table size");
+        return -MESHX_ERR_INVAL;
+    }
+
+    uint32_t table_size = meshx_hash_table_size(path_num);
+
+    df_table = meshx_malloc(table_size * sizeof(meshx_df_path_t));
+    if (NULL == df_table)
+    {
+        MESHX_ERROR("initialize directed forwarding failed: out of memory");
+        return -MESHX_ERR_MEM;
+    }
+    df_table_mask = table_size - 1;
+    meshx_df_clear();
+    MESHX_INFO("initialize directed forwarding success: paths %d", path_num);
+
+    return MESHX_SUCCESS;
+}
+
+void meshx_df_deinit(void)
+{
+    if (NULL != df_table)
+    {
+        meshx_free(df_table);
+        df_table = NULL;
+    }
+    df_table_mask = 0;
+}
+
+void meshx_df_clear(void)
+{
+    if (NULL != df_table)
+    {
+        memset(df_table, 0, (df_table_mask + 1) * sizeof(meshx_df_path_t));
+    }
+    memset(&df_info, 0, sizeof(meshx_df_info_t));
+}
+
+static uint32_t meshx_df_hash(uint16_t origin, uint16_t target)
+{
+    return meshx_hash_u32(((uint32_t)target << 16) | origin) & df_table_mask;
+}
+
+static bool meshx_df_path_is_alive(const meshx_df_path_t *ppath, uint32_t now)
+{
+    /* time wraps, compare difference */
+    return (MESHX_DF_PATH_STATE_FREE != ppath->state) && ((int32_t)(ppath->expire - now) > 0);
+}
+
+static meshx_df_path_t *meshx_df_path_find(uint16_t origin, uint16_t target, uint32_t now)
+{
+    uint32_t slot = meshx_df_hash(origin, target);
+    for (uint32_t i = 0; i <= df_table_mask; ++i)
+    {
+        meshx_df_path_t *ppath = &df_table[slot];
+        if (MESHX_ADDRESS_UNASSIGNED == ppath->origin)
+        {
+            break;
+        }
+
+        if ((origin == ppath->origin) && (target == ppath->target))
+        {
+            return meshx_df_path_is_alive(ppath, now) ? ppath : NULL;
+        }
+        slot = (slot + 1) & df_table_mask;
+    }
+
+    return NULL;
+}
+
+/**
+ * @return slot of the path if it is in table, otherwise first unused or expired slot
+ */
+static meshx_df_path_t *meshx_df_path_alloc(uint16_t origin, uint16_t target, uint32_t now)
+{
+    meshx_df_path_t *pidle = NULL;
+    uint32_t slot = meshx_df_hash(origin, target);
+    for (uint32_t i = 0; i <= df_table_mask; ++i)
+    {
+        meshx_df_path_t *ppath = &df_table[slot];
+        if (MESHX_ADDRESS_UNASSIGNED == ppath->origin)
+        {
+            return (NULL == pidle) ? ppath : pidle;
+        }
+
+        if ((origin == ppath->origin) && (target == ppath->target))
+        {
+            return ppath;
+        }
+
+        if ((NULL == pidle) && !meshx_df_path_is_alive(ppath, now))
+        {
+            pidle = ppath;
+        }
+        slot = (slot + 1) & df_table_mask;
+    }
+
+    if (NULL == pidle)
+    {
+        df_info.table_full ++;
+        MESHX_WARN("directed forwarding table is full, drop path 0x%04x -> 0x%04x", origin, target);
+    }
+    return pidle;
+}
+
+static int32_t meshx_df_send(uint8_t opcode, uint16_t dst, const meshx_df_path_t *ppath,
+                             const meshx_net_key_value_t *pnet_key)
+{
+    meshx_df_path_pdu_t pdu;
+    pdu.origin = MESHX_HOST_TO_BE16(ppath->origin);
+    pdu.target = MESHX_HOST_TO_BE16(ppath->target);
+    pdu.forwarding_number = ppath->forwarding_number;
+
+    /* each node re-originates control messages, so they only reach neighbors */
+    meshx_msg_ctx_t msg_tx_ctx;
+    memset(&msg_tx_ctx, 0, sizeof(msg_tx_ctx));
+    msg_tx_ctx.src = meshx_node_params.param.node_addr;
+    msg_tx_ctx.dst = dst;
+    msg_tx_ctx.seg = 0;
+    msg_tx_ctx.ttl = 0;
+    msg_tx_ctx.ctl = 1;
+    msg_tx_ctx.iv_index = meshx_iv_index_tx_get();
+    msg_tx_ctx.pnet_key = pnet_key;
+    msg_tx_ctx.opcode = opcode;
+    msg_tx_ctx.seq = meshx_seq_use(MESHX_NODE_ELEMENT_INDEX(msg_tx_ctx.src));
+
+    MESHX_INFO("directed forwarding send: opcode 0x%02x, dst 0x%04x, path 0x%04x -> 0x%04x, forwarding number %d",
+               opcode, dst, ppath->origin, ppath->target, ppath->forwarding_number);
+    return meshx_lower_trans_send((const uint8_t *)&pdu, sizeof(pdu), &msg_tx_ctx);
+}
+
+void meshx_df_path_check(const meshx_msg_ctx_t *pmsg_tx_ctx)
+{
+    if ((NULL == df_table) || !MESHX_ADDRESS_IS_UNICAST(pmsg_tx_ctx->dst) ||
+        meshx_node_is_my_address(pmsg_tx_ctx->dst) || meshx_net_iface_is_proxy_client(pmsg_tx_ctx->dst))
+    {
+        return ;
+    }
+
+    uint32_t now = meshx_time_get();
+    if (NULL != meshx_df_path_find(pmsg_tx_ctx->src, pmsg_tx_ctx->dst, now))
+    {
+        /* path is established or being discovered */
+        return ;
+    }
+
+    meshx_df_path_t *ppath = meshx_df_path_alloc(pmsg_tx_ctx->src, pmsg_tx_ctx->dst, now);
+    if (NULL == ppath)
+    {
+        return ;
+    }
+
+    ppath->origin = pmsg_tx_ctx->src;
+    ppath->target = pmsg_tx_ctx->dst;
+    ppath->upstream = MESHX_ADDRESS_UNASSIGNED;
+    df_forwarding_number ++;
+    ppath->forwarding_number = df_forwarding_number;
+    ppath->state = MESHX_DF_PATH_STATE_DISCOVERING;
+    ppath->on_path = TRUE;
+    ppath->expire = now + meshx_node_params.config.df_discovery_timeout;
+
+    df_info.requests ++;
+    meshx_df_send(MESHX_DF_OPCODE_PATH_REQUEST, MESHX_ADDRESS_ALL_NODES, ppath,
+                  pmsg_tx_ctx->pnet_key);
+}
+
+uint8_t meshx_df_relay_check(uint16_t src, uint16_t dst)
+{
+    /* echo of pdu sent by myself is dropped by relay */
+    if ((NULL == df_table) || meshx_node_is_my_address(src))
+    {
+        return MESHX_DF_RELAY_FLOOD;
+    }
+
+    uint32_t now = meshx_time_get();
+    const meshx_df_path_t *ppath = meshx_df_path_find(src, dst, now);
+    if (NULL == ppath)
+    {
+        /* response goes back along the same path */
+        ppath = meshx_df_path_find(dst, src, now);
+    }
+
+    if ((NULL != ppath) && (MESHX_DF_PATH_STATE_ESTABLISHED == ppath->state))
+    {
+        if (ppath->on_path)
+        {
+            df_info.forwarded ++;
+            return MESHX_DF_RELAY_FORWARD;
+        }
+
+        df_info.suppressed ++;
+        return MESHX_DF_RELAY_SUPPRESS;
+    }
+
+    if (meshx_node_params.config.df_flood_fallback)
+    {
+        df_info.flooded ++;
+        return MESHX_DF_RELAY_FLOOD;
+    }
+
+    df_info.suppressed ++;
+    return MESHX_DF_RELAY_SUPPRESS;
+}
+
+static bool meshx_df_is_newer(uint8_t forwarding_number, const meshx_df_path_t *ppath,
+                              uint32_t now)
+{
+    if (!meshx_df_path_is_alive(ppath, now))
+    {
+        return TRUE;
+    }
+
+    return ((int8_t)(forwarding_number - ppath->forwarding_number) > 0);
+}
+
+static void meshx_df_receive_request(const meshx_df_path_pdu_t *ppdu,
+                                     const meshx_msg_ctx_t *pmsg_rx_ctx, uint32_t now)
+{
+    if (meshx_node_is_my_address(ppdu->origin))
+    {
+        /* request forwarded by neighbor */
+        return ;
+    }
+
+    meshx_df_path_t *ppath = meshx_df_path_alloc(ppdu->origin, ppdu->target, now);
+    if ((NULL == ppath) || !meshx_df_is_newer(ppdu->forwarding_number, ppath, now))
+    {
+        return ;
+    }
+
+    /* first copy of request decides upstream, proxy answers for its clients that can't
+       receive request sent with ttl 0 */
+    bool is_target = meshx_node_is_my_address(ppdu->target) ||
+                     meshx_net_iface_is_proxy_client(ppdu->target);
+    ppath->origin = ppdu->origin;
+    ppath->target = ppdu->target;
+    ppath->upstream = pmsg_rx_ctx->src;
+    ppath->forwarding_number = ppdu->forwarding_number;
+    ppath->state = MESHX_DF_PATH_STATE_DISCOVERING;
+    ppath->on_path = is_target;
+    ppath->expire = now + meshx_node_params.config.df_discovery_timeout;
+
+    if (is_target)
+    {
+        df_info.replies ++;
+        meshx_df_send(MESHX_DF_OPCODE_PATH_REPLY, ppath->upstream, ppath, pmsg_rx_ctx->pnet_key);
+    }
+    else
+    {
+        df_info.requests ++;
+        meshx_df_send(MESHX_DF_OPCODE_PATH_REQUEST, MESHX_ADDRESS_ALL_NODES, ppath,
+                      pmsg_rx_ctx->pnet_key);
+    }
+}
+
+static void meshx_df_receive_reply(const meshx_df_path_pdu_t *ppdu,
+                                   const meshx_msg_ctx_t *pmsg_rx_ctx, uint32_t now)
+{
+    meshx_df_path_t *ppath = meshx_df_path_find(ppdu->origin, ppdu->target, now);
+    if ((NULL == ppath) || (MESHX_DF_PATH_STATE_DISCOVERING != ppath->state) ||
+        (ppdu->forwarding_number != ppath->forwarding_number))
+    {
+        MESHX_DEBUG("ignore path reply: 0x%04x -> 0x%04x", ppdu->origin, ppdu->target);
+        return ;
+    }
+
+    if (meshx_node_is_my_address(ppdu->origin))
+    {
+        MESHX_INFO("path established: 0x%04x -> 0x%04x", ppdu->origin, ppdu->target);
+        ppath->state = MESHX_DF_PATH_STATE_ESTABLISHED;
+        ppath->expire = now + meshx_node_params.config.df_path_lifetime * 1000;
+        df_info.confirmations ++;
+        meshx_df_send(MESHX_DF_OPCODE_PATH_CONFIRMATION, MESHX_ADDRESS_ALL_NODES, ppath,
+                      pmsg_rx_ctx->pnet_key);
+        return ;
+    }
+
+    if (ppath->on_path)
+    {
+        /* reply already forwarded */
+        return ;
+    }
+
+    ppath->on_path = TRUE;
+    df_info.replies ++;
+    meshx_df_send(MESHX_DF_OPCODE_PATH_REPLY, ppath->upstream, ppath, pmsg_rx_ctx->pnet_key);
+}
+
+static void meshx_df_receive_confirmation(const meshx_df_path_pdu_t *ppdu,
+                                          const meshx_msg_ctx_t *pmsg_rx_ctx, uint32_t now)
+{
+    if (meshx_node_is_my_address(ppdu->origin))
+    {
+        return ;
+    }
+
+    meshx_df_path_t *ppath = meshx_df_path_alloc(ppdu->origin, ppdu->target, now);
+    if (NULL == ppath)
+    {
+        return ;
+    }
+
+    if (meshx_df_is_newer(ppdu->forwarding_number, ppath, now))
+    {
+        /* node didn't take part in discovery, it is off the path */
+        ppath->origin = ppdu->origin;
+        ppath->target = ppdu->target;
+        ppath->upstream = MESHX_ADDRESS_UNASSIGNED;
+        ppath->forwarding_number = ppdu->forwarding_number;
+        ppath->on_path = FALSE;
+    }
+    else if ((ppdu->forwarding_number != ppath->forwarding_number) ||
+             (MESHX_DF_PATH_STATE_ESTABLISHED == ppath->state))
+    {
+        /* old or repeated confirmation */
+        return ;
+    }
+
+    MESHX_INFO("path confirmed: 0x%04x -> 0x%04x, on path %d", ppath->origin, ppath->target,
+               ppath->on_path);
+    ppath->state = MESHX_DF_PATH_STATE_ESTABLISHED;
+    ppath->expire = now + meshx_node_params.config.df_path_lifetime * 1000;
+    df_info.confirmations ++;
+    meshx_df_send(MESHX_DF_OPCODE_PATH_CONFIRMATION, MESHX_ADDRESS_ALL_NODES, ppath,
+                  pmsg_rx_ctx->pnet_key);
+}
+
+int32_t meshx_df_receive(const uint8_t *pdata, uint16_t len, const meshx_msg_ctx_t *pmsg_rx_ctx)
+{
+    if (NULL == df_table)
+    {
+        return MESHX_SUCCESS;
+    }
+
+    if (sizeof(meshx_df_path_pdu_t) != len)
+    {
+        MESHX_WARN("invalid directed forwarding pdu length: %d", len);
+        return -MESHX_ERR_LENGTH;
+    }
+
+    if (meshx_node_is_my_address(pmsg_rx_ctx->src))
+    {
+        return MESHX_SUCCESS;
+    }
+
+    const meshx_df_path_pdu_t *ppdu = (const meshx_df_path_pdu_t *)pdata;
+    meshx_df_path_pdu_t pdu;
+    pdu.origin = MESHX_BE16_TO_HOST(ppdu->origin);
+    pdu.target = MESHX_BE16_TO_HOST(ppdu->target);
+    pdu.forwarding_number = ppdu->forwarding_number;
+    if (!MESHX_ADDRESS_IS_UNICAST(pdu.origin) || !MESHX_ADDRESS_IS_UNICAST(pdu.target))
+    {
+        MESHX_WARN("invalid path: 0x%04x -> 0x%04x", pdu.origin, pdu.target);
+        return -MESHX_ERR_INVAL;
+    }
+
+    MESHX_DEBUG("directed forwarding receive: opcode 0x%02x, src 0x%04x, path 0x%04x -> 0x%04x, forwarding number %d",
+                pmsg_rx_ctx->opcode, pmsg_rx_ctx->src, pdu.origin, pdu.target, pdu.forwarding_number);
+    uint32_t now = meshx_time_get();
+    switch (pmsg_rx_ctx->opcode)
+    {
+    case MESHX_DF_OPCODE_PATH_REQUEST:
+        meshx_df_receive_request(&pdu, pmsg_rx_ctx, now);
+        break;
+    case MESHX_DF_OPCODE_PATH_REPLY:
+        meshx_df_receive_reply(&pdu, pmsg_rx_ctx, now);
+        break;
+    case MESHX_DF_OPCODE_PATH_CONFIRMATION:
+        meshx_df_receive_confirmation(&pdu, pmsg_rx_ctx, now);
+        break;
+    default:
+        MESHX_WARN("unknown directed forwarding opcode: 0x%02x", pmsg_rx_ctx->opcode);
+        return -MESHX_ERR_INVAL;
+    }
+
+    return MESHX_SUCCESS;
+}
+
+meshx_df_info_t meshx_df_info_get(void)
+{
+    return df_info;
+}
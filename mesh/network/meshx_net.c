@@ -20,10 +20,15 @@
 #include "meshx_security.h"
 #include "meshx_endianness.h"
 #include "meshx_nmc.h"
+#include "meshx_df.h"
 #include "meshx_rpl.h"
 #include "meshx_key.h"
 #include "meshx_lower_trans.h"
 #include "meshx_proxy.h"
+#include "meshx_timer.h"
+#include "meshx_mem.h"
+#include "meshx_misc.h"
+#include "meshx_list.h"
 
 #define MESHX_NET_TRANS_PDU_MAX_LEN         20
 #define MESHX_NET_ENCRYPT_OFFSET            7
@@ -48,87 +53,197 @@ typedef struct
 } __PACKED meshx_net_pdu_t;
 
 
+/* ccm decryption failed with net key whose nid matches */
+static uint32_t net_decrypt_failed_count;
+
+typedef struct
+{
+    meshx_net_pdu_t net_pdu;
+    uint8_t len;
+    uint16_t src;
+    uint16_t dst;
+    meshx_net_iface_t net_iface; /* interface that pdu is received from */
+    uint8_t transmits;
+    uint8_t holds; /* times that transmit has been held back for bearer backlog */
+    meshx_timer_t timer;
+    meshx_list_t node;
+} meshx_net_relay_task_t;
+
+/* relay transmit is held back at most these times, then sent anyway */
+#define MESHX_NET_RELAY_HOLD_MAX                3
+
+static meshx_list_t net_relay_task_idle;
+static meshx_list_t net_relay_task_active;
+static meshx_net_relay_info_t net_relay_info;
+
+static void meshx_net_relay_timeout_handler(void *pargs)
+{
+    meshx_async_msg_t msg;
+    msg.type = MESHX_ASYNC_MSG_TYPE_TIMEOUT_NET_RELAY;
+    msg.pdata = pargs;
+    msg.data_len = 0;
+    meshx_async_msg_send(&msg);
+}
+
+static int32_t meshx_net_relay_init(void)
+{
+    meshx_list_init_head(&net_relay_task_idle);
+    meshx_list_init_head(&net_relay_task_active);
+    uint8_t task_num = meshx_node_params.config.relay_queue_size;
+    if (0 == task_num)
+    {
+        return MESHX_SUCCESS;
+    }
+
+    meshx_net_relay_task_t *ptasks = meshx_malloc(task_num * sizeof(meshx_net_relay_task_t));
+    if (NULL == ptasks)
+    {
+        MESHX_ERROR("initialize net relay queue failed: out of memory");
+        return -MESHX_ERR_MEM;
+    }
+    memset(ptasks, 0, task_num * sizeof(meshx_net_relay_task_t));
+
+    for (uint8_t i = 0; i < task_num; ++i)
+    {
+        if (MESHX_SUCCESS != meshx_timer_create(&ptasks[i].timer, MESHX_TIMER_MODE_SINGLE_SHOT,
+                                                meshx_net_relay_timeout_handler, &ptasks[i]))
+        {
+            MESHX_ERROR("initialize net relay queue failed: create timer failed");
+            for (uint8_t j = 0; j < i; ++j)
+            {
+                meshx_timer_delete(ptasks[j].timer);
+            }
+            meshx_free(ptasks);
+            meshx_list_init_head(&net_relay_task_idle);
+            return -MESHX_ERR_RESOURCE;
+        }
+        meshx_list_append(&net_relay_task_idle, &ptasks[i].node);
+    }
+
+    return MESHX_SUCCESS;
+}
+
 int32_t meshx_net_init(void)
 {
     meshx_net_iface_init();
-    return MESHX_SUCCESS;
+    return meshx_net_relay_init();
+}
+
+static int32_t meshx_net_relay(meshx_net_iface_t net_iface, const meshx_net_pdu_t *pnet_pdu,
+                               uint8_t len, uint32_t iv_index,
+                               const meshx_net_key_value_t *pkey_value);
+
+/**
+ * network nonce or proxy nonce, proxy nonce has the same layout except that ctl and ttl
+ * are padding
+ */
+static void meshx_net_nonce_init(meshx_net_nonce_t *pnet_nonce, const meshx_net_pdu_t *pnet_pdu,
+                                 uint32_t iv_index, uint8_t nonce_type)
+{
+    pnet_nonce->nonce_type = nonce_type;
+    if (MESHX_NONCE_TYPE_PROXY == nonce_type)
+    {
+        pnet_nonce->ctl = 0;
+        pnet_nonce->ttl = 0;
+    }
+    else
+    {
+        pnet_nonce->ctl = pnet_pdu->net_metadata.ctl;
+        pnet_nonce->ttl = pnet_pdu->net_metadata.ttl;
+    }
+    pnet_nonce->seq[0] = pnet_pdu->net_metadata.seq[0];
+    pnet_nonce->seq[1] = pnet_pdu->net_metadata.seq[1];
+    pnet_nonce->seq[2] = pnet_pdu->net_metadata.seq[2];
+    pnet_nonce->src = pnet_pdu->net_metadata.src;
+    pnet_nonce->pad = 0;
+    pnet_nonce->iv_index = MESHX_HOST_TO_BE32(iv_index);
+    MESHX_DEBUG("net nonce:");
+    MESHX_DUMP_DEBUG(pnet_nonce, sizeof(meshx_net_nonce_t));
 }
 
 static void meshx_net_encrypt(meshx_net_pdu_t *pnet_pdu, uint8_t trans_pdu_len,
-                              uint32_t iv_index, const meshx_net_key_value_t *pnet_key)
+                              uint32_t iv_index, const meshx_net_key_value_t *pnet_key,
+                              uint8_t nonce_type)
 {
     meshx_net_nonce_t net_nonce;
-    net_nonce.nonce_type = MESHX_NONCE_TYPE_NET;
-    net_nonce.ctl = pnet_pdu->net_metadata.ctl;
-    net_nonce.ttl = pnet_pdu->net_metadata.ttl;
-    net_nonce.seq[0] = pnet_pdu->net_metadata.seq[0];
-    net_nonce.seq[1] = pnet_pdu->net_metadata.seq[1];
-    net_nonce.seq[2] = pnet_pdu->net_metadata.seq[2];
-    net_nonce.src = pnet_pdu->net_metadata.src;
-    net_nonce.pad = 0;
-    net_nonce.iv_index = MESHX_HOST_TO_BE32(iv_index);
-    MESHX_DEBUG("net nonce:");
-    MESHX_DUMP_DEBUG(&net_nonce, sizeof(meshx_net_nonce_t));
+    meshx_net_nonce_init(&net_nonce, pnet_pdu, iv_index, nonce_type);
 
     uint8_t net_mic_len = pnet_pdu->net_metadata.ctl ? 8 : 4;
     /* encrypt data */
-    meshx_aes_ccm_encrypt(pnet_key->encryption_key, (const uint8_t *)&net_nonce,
-                          sizeof(meshx_net_nonce_t),
-                          NULL, 0, (const uint8_t *)pnet_pdu + MESHX_NET_ENCRYPT_OFFSET,
-                          sizeof(pnet_pdu->net_metadata.dst) + trans_pdu_len,
-                          (uint8_t *)pnet_pdu + MESHX_NET_ENCRYPT_OFFSET, pnet_pdu->pdu + trans_pdu_len, net_mic_len);
+    meshx_aes_ccm_ctx_encrypt(&pnet_key->encryption_key_ctx, (const uint8_t *)&net_nonce,
+                              sizeof(meshx_net_nonce_t),
+                              NULL, 0, (const uint8_t *)pnet_pdu + MESHX_NET_ENCRYPT_OFFSET,
+                              sizeof(pnet_pdu->net_metadata.dst) + trans_pdu_len,
+                              (uint8_t *)pnet_pdu + MESHX_NET_ENCRYPT_OFFSET, pnet_pdu->pdu + trans_pdu_len, net_mic_len);
     MESHX_DEBUG("encrypt and auth trans pdu:");
     MESHX_DUMP_DEBUG((uint8_t *)pnet_pdu + MESHX_NET_ENCRYPT_OFFSET,
                      sizeof(pnet_pdu->net_metadata.dst) + trans_pdu_len + net_mic_len);
 }
 
-static void meshx_net_obfuscation(meshx_net_pdu_t *pnet_pdu, uint32_t iv_index,
-                                  const meshx_net_key_value_t *pnet_key)
+static void meshx_net_privacy_plaintext(const meshx_net_pdu_t *pnet_pdu, uint32_t iv_index,
+                                        uint8_t privacy_plaintext[16])
 {
     iv_index = MESHX_HOST_TO_BE32(iv_index);
-    uint8_t privacy_plaintext[16];
     memset(privacy_plaintext, 0, 5);
     memcpy(privacy_plaintext + 5, &iv_index, 4);
     memcpy(privacy_plaintext + 9, (const uint8_t *)pnet_pdu + MESHX_NET_ENCRYPT_OFFSET, 7);
-    MESHX_DEBUG("privacy plaintext:");
-    MESHX_DUMP_DEBUG(privacy_plaintext, 16);
-    meshx_e(privacy_plaintext, pnet_key->privacy_key, privacy_plaintext);
-    MESHX_DEBUG("PECB:");
-    MESHX_DUMP_DEBUG(privacy_plaintext, 16);
+}
+
+static void meshx_net_obfuscation_apply(meshx_net_pdu_t *pnet_pdu, const uint8_t pecb[16])
+{
     uint8_t *pdata = (uint8_t *)pnet_pdu + MESHX_NET_OBFUSCATION_OFFSET;
     for (uint8_t i = 0; i < MESHX_NET_OBFUSCATION_SIZE; ++i)
     {
-        *pdata = *pdata ^ privacy_plaintext[i];
+        *pdata = *pdata ^ pecb[i];
         pdata ++;
     }
+}
+
+static void meshx_net_obfuscation(meshx_net_pdu_t *pnet_pdu, uint32_t iv_index,
+                                  const meshx_net_key_value_t *pnet_key)
+{
+    uint8_t privacy_plaintext[16];
+    meshx_net_privacy_plaintext(pnet_pdu, iv_index, privacy_plaintext);
+    MESHX_DEBUG("privacy plaintext:");
+    MESHX_DUMP_DEBUG(privacy_plaintext, 16);
+    meshx_aes128_ctx_encrypt(&pnet_key->privacy_key_ctx, privacy_plaintext, privacy_plaintext);
+    MESHX_DEBUG("PECB:");
+    MESHX_DUMP_DEBUG(privacy_plaintext, 16);
+    meshx_net_obfuscation_apply(pnet_pdu, privacy_plaintext);
     MESHX_DEBUG("obfuscation net header:");
     MESHX_DUMP_DEBUG((uint8_t *)pnet_pdu + MESHX_NET_OBFUSCATION_OFFSET,
                      MESHX_NET_OBFUSCATION_SIZE);
 }
 
+/**
+ * get transport pdu length from restored header,
+ * return 0 if length is not enough to hold net mic
+ */
+static uint8_t meshx_net_trans_pdu_len(const meshx_net_pdu_t *pnet_pdu, uint8_t len)
+{
+    uint8_t net_mic_len = pnet_pdu->net_metadata.ctl ? 8 : 4;
+    if (len <= sizeof(meshx_net_metadata_t) + net_mic_len)
+    {
+        return 0;
+    }
+
+    return len - sizeof(meshx_net_metadata_t) - net_mic_len;
+}
+
 static int32_t meshx_net_decrypt(meshx_net_pdu_t *pnet_pdu, uint8_t trans_pdu_len,
-                                 uint32_t iv_index, const meshx_net_key_value_t *pnet_key)
+                                 uint32_t iv_index, const meshx_net_key_value_t *pnet_key,
+                                 uint8_t nonce_type)
 {
     meshx_net_nonce_t net_nonce;
-    net_nonce.nonce_type = MESHX_NONCE_TYPE_NET;
-    net_nonce.ctl = pnet_pdu->net_metadata.ctl;
-    net_nonce.ttl = pnet_pdu->net_metadata.ttl;
-    net_nonce.seq[0] = pnet_pdu->net_metadata.seq[0];
-    net_nonce.seq[1] = pnet_pdu->net_metadata.seq[1];
-    net_nonce.seq[2] = pnet_pdu->net_metadata.seq[2];
-    net_nonce.src = pnet_pdu->net_metadata.src;
-    net_nonce.pad = 0;
-    net_nonce.iv_index = MESHX_HOST_TO_BE32(iv_index);
-    MESHX_DEBUG("net nonce:");
-    MESHX_DUMP_DEBUG(&net_nonce, sizeof(meshx_net_nonce_t));
+    meshx_net_nonce_init(&net_nonce, pnet_pdu, iv_index, nonce_type);
 
     uint8_t net_mic_len = pnet_pdu->net_metadata.ctl ? 8 : 4;
     /* decrypt data */
-    int32_t ret = meshx_aes_ccm_decrypt(pnet_key->encryption_key, (const uint8_t *)&net_nonce,
-                                        sizeof(meshx_net_nonce_t),
-                                        NULL, 0, (const uint8_t *)pnet_pdu + MESHX_NET_ENCRYPT_OFFSET,
-                                        sizeof(pnet_pdu->net_metadata.dst) + trans_pdu_len,
-                                        (uint8_t *)pnet_pdu + MESHX_NET_ENCRYPT_OFFSET, pnet_pdu->pdu + trans_pdu_len, net_mic_len);
+    int32_t ret = meshx_aes_ccm_ctx_decrypt(&pnet_key->encryption_key_ctx,
+                                            (const uint8_t *)&net_nonce, sizeof(meshx_net_nonce_t),
+                                            NULL, 0, (const uint8_t *)pnet_pdu + MESHX_NET_ENCRYPT_OFFSET,
+                                            sizeof(pnet_pdu->net_metadata.dst) + trans_pdu_len,
+                                            (uint8_t *)pnet_pdu + MESHX_NET_ENCRYPT_OFFSET, pnet_pdu->pdu + trans_pdu_len, net_mic_len);
     if (MESHX_SUCCESS == ret)
     {
         MESHX_DEBUG("dencrypt trans pdu:");
@@ -143,139 +258,412 @@ static int32_t meshx_net_decrypt(meshx_net_pdu_t *pnet_pdu, uint8_t trans_pdu_le
     return ret;
 }
 
-int32_t meshx_net_receive(meshx_net_iface_t net_iface, const uint8_t *pdata, uint8_t len)
+/**
+ * filter and copy received data, choose iv index by ivi
+ */
+static int32_t meshx_net_receive_prepare(meshx_net_iface_t net_iface, const uint8_t *pdata,
+                                         uint8_t len, const meshx_adv_metadata_t *padv_metadata,
+                                         meshx_net_pdu_t *pnet_pdu, uint32_t *piv_index)
 {
-    MESHX_DEBUG("receive net data:");
-    MESHX_DUMP_DEBUG(pdata, len);
-
-#if MESHX_REDUNDANCY_CHECK
-    if (NULL == net_iface)
-    {
-        MESHX_ERROR("net interface is NULL");
-        return -MESHX_ERR_INVAL;
-    }
-#endif
-
     /* filter data */
-    /* TODO: add input filter data, use adv information? */
-    meshx_net_iface_ifilter_data_t filter_data = {};
+    meshx_net_iface_ifilter_data_t filter_data = {.pdata = pdata, .len = len, .padv_metadata = padv_metadata};
     if (!meshx_net_iface_ifilter(net_iface, &filter_data))
     {
         MESHX_WARN("net data has been filtered!");
         return -MESHX_ERR_FILTER;
     }
 
+    if ((len > sizeof(meshx_net_pdu_t)) || (len <= sizeof(meshx_net_metadata_t) + 4))
+    {
+        MESHX_NET_IFACE_STATS_INC(net_iface, invalid_length);
+        MESHX_ERROR("invalid net pdu length: %d", len);
+        return -MESHX_ERR_LENGTH;
+    }
+
     /* copy data */
-    uint32_t iv_index = meshx_iv_index_get();
-    meshx_net_pdu_t net_pdu = *(const meshx_net_pdu_t *)pdata;
+    memcpy(pnet_pdu, pdata, len);
 
     /* check ivi to choose correct iv index */
-    if ((iv_index & 0x01) !=  net_pdu.net_metadata.ivi)
+    uint32_t iv_index = meshx_iv_index_get();
+    if ((iv_index & 0x01) !=  pnet_pdu->net_metadata.ivi)
     {
         iv_index = iv_index - 1;
     }
+    *piv_index = iv_index;
 
-    /* get net key */
-    int32_t ret = MESHX_SUCCESS;
-    uint8_t net_mic_len, trans_pdu_len;
-    meshx_net_key_t *pnet_key = NULL;
-    const meshx_net_key_value_t *pkey_value = NULL;
-    meshx_net_key_traverse_start(&pnet_key);
-    while (NULL != pnet_key)
+    return MESHX_SUCCESS;
+}
+
+static uint32_t meshx_net_pdu_seq(const meshx_net_pdu_t *pnet_pdu)
+{
+    uint32_t seq = pnet_pdu->net_metadata.seq[0];
+    seq <<= 8;
+    seq |= pnet_pdu->net_metadata.seq[1];
+    seq <<= 8;
+    seq |= pnet_pdu->net_metadata.seq[2];
+
+    return seq;
+}
+
+/**
+ * check restored header against nmc before ccm decryption, so that duplicated pdus only cost
+ * one aes block. replay protection list is checked too if relay is disabled, in which case
+ * only pdus sent to me are accepted. nothing is added here, cache is updated after the pdu
+ * has been authenticated
+ */
+static bool meshx_net_receive_is_duplicate(const meshx_net_pdu_t *pnet_pdu, uint32_t iv_index)
+{
+    uint16_t src = MESHX_BE16_TO_HOST(pnet_pdu->net_metadata.src);
+    uint32_t seq = meshx_net_pdu_seq(pnet_pdu);
+    meshx_nmc_t nmc = {.src = src, .seq = seq, .iv_index = iv_index};
+    if (!meshx_nmc_check(nmc))
     {
-        uint8_t loop = 1;
-        if ((MESHX_KEY_STATE_PHASE1 == pnet_key->key_state) ||
-            (MESHX_KEY_STATE_PHASE2 == pnet_key->key_state))
+        return TRUE;
+    }
+
+    if (!meshx_node_params.param.relay_enable)
+    {
+        meshx_rpl_t rpl = {.src = src, .seq = seq, .iv_index = iv_index};
+        if (!meshx_rpl_check(rpl))
         {
-            loop = 2;
+            return TRUE;
         }
+    }
+
+    return FALSE;
+}
 
-        for (uint8_t i = 0; i < loop; ++i)
+/**
+ * try all net keys that match nid, header is restored from origin data for each key,
+ * key value in *ppkey_value has been tried by caller and is skipped
+ */
+static int32_t meshx_net_receive_decrypt(meshx_net_iface_t net_iface, const uint8_t *pdata,
+                                         uint8_t len, uint32_t iv_index,
+                                         meshx_net_pdu_t *pnet_pdu,
+                                         const meshx_net_key_value_t **ppkey_value)
+{
+    uint8_t nid = pnet_pdu->net_metadata.nid;
+    uint8_t trans_pdu_len;
+    const meshx_net_key_value_t *ptried_key = *ppkey_value;
+    const meshx_net_key_value_t *pkey_value = NULL;
+    meshx_net_key_nid_traverse_start(nid, &pkey_value);
+    if (NULL == pkey_value)
+    {
+        MESHX_NET_IFACE_STATS_INC(net_iface, no_nid_match);
+        MESHX_ERROR("can't decrypt pdu with net key that nid is 0x%x", nid);
+        return -MESHX_ERR_KEY;
+    }
+
+    while (NULL != pkey_value)
+    {
+        if (pkey_value != ptried_key)
         {
-            if (pnet_key->key_value[i].nid == net_pdu.net_metadata.nid)
+            /* restore header */
+            memcpy(pnet_pdu, pdata, len);
+            meshx_net_obfuscation(pnet_pdu, iv_index, pkey_value);
+            if (meshx_net_receive_is_duplicate(pnet_pdu, iv_index))
             {
-                /* restore header */
-                meshx_net_obfuscation(&net_pdu, iv_index, &pnet_key->key_value[i]);
-
-                /* decrypt transport layer data */
-                net_mic_len = net_pdu.net_metadata.ctl ? 8 : 4;
-                trans_pdu_len = len - sizeof(meshx_net_metadata_t) - net_mic_len;
-                ret = meshx_net_decrypt(&net_pdu, trans_pdu_len, iv_index, &pnet_key->key_value[i]);
-                if (MESHX_SUCCESS == ret)
+                MESHX_NET_IFACE_STATS_INC(net_iface, duplicated);
+                return -MESHX_ERR_FAIL;
+            }
+
+            /* decrypt transport layer data */
+            trans_pdu_len = meshx_net_trans_pdu_len(pnet_pdu, len);
+            if (0 != trans_pdu_len)
+            {
+                if (MESHX_SUCCESS == meshx_net_decrypt(pnet_pdu, trans_pdu_len, iv_index, pkey_value,
+                                                       MESHX_NONCE_TYPE_NET))
                 {
-                    pkey_value = &pnet_key->key_value[i];
-                    goto FINISH;
+                    meshx_net_key_nid_hit(pkey_value);
+                    *ppkey_value = pkey_value;
+                    return MESHX_SUCCESS;
                 }
+                net_decrypt_failed_count ++;
             }
         }
 
-        meshx_net_key_traverse_continue(&pnet_key);
-    }
-
-FINISH:
-    if (NULL == pnet_key)
-    {
-        MESHX_ERROR("can't decrypt pdu with net key that nid is 0x%x", net_pdu.net_metadata.nid);
-        return -MESHX_ERR_KEY;
+        meshx_net_key_nid_traverse_continue(&pkey_value);
     }
 
+    MESHX_NET_IFACE_STATS_INC(net_iface, decrypt_failed);
+    MESHX_ERROR("can't decrypt pdu with net key that nid is 0x%x", nid);
+    return -MESHX_ERR_KEY;
+}
 
-    /* TODO: check nmc, rpl and relay or loopback interface */
-    uint16_t src = MESHX_BE16_TO_HOST(net_pdu.net_metadata.src);
-    uint16_t dst = MESHX_BE16_TO_HOST(net_pdu.net_metadata.dst);
+/**
+ * check decrypted pdu and deliver it to lower transport layer
+ */
+static int32_t meshx_net_receive_dispatch(meshx_net_iface_t net_iface,
+                                          meshx_net_pdu_t *pnet_pdu, uint8_t len,
+                                          uint32_t iv_index, const meshx_net_key_value_t *pkey_value)
+{
+    int32_t ret = MESHX_SUCCESS;
+    uint8_t trans_pdu_len = meshx_net_trans_pdu_len(pnet_pdu, len);
+    uint16_t src = MESHX_BE16_TO_HOST(pnet_pdu->net_metadata.src);
+    uint16_t dst = MESHX_BE16_TO_HOST(pnet_pdu->net_metadata.dst);
     if (!MESHX_ADDRESS_IS_VALID(src) || !MESHX_ADDRESS_IS_VALID(dst))
     {
+        MESHX_NET_IFACE_STATS_INC(net_iface, invalid_address);
         MESHX_ERROR("invalid address: src 0x%04x, dst 0x%04x", src, dst);
         return -MESHX_ERR_INVAL;
     }
-    uint32_t seq = net_pdu.net_metadata.seq[0];
-    seq <<= 8;
-    seq |= net_pdu.net_metadata.seq[1];
-    seq <<= 8;
-    seq |= net_pdu.net_metadata.seq[2];
+    uint32_t seq = meshx_net_pdu_seq(pnet_pdu);
 
-    /* check nmc */
-    meshx_nmc_t nmc = {.src = src, .seq = seq};
-    if (!meshx_nmc_check(nmc))
+    /* add to nmc, pdu has been authenticated */
+    meshx_nmc_t nmc = {.src = src, .seq = seq, .iv_index = iv_index};
+    if (!meshx_nmc_check_add(nmc))
     {
         /* message already cached, ignore */
+        MESHX_NET_IFACE_STATS_INC(net_iface, duplicated);
         return -MESHX_ERR_FAIL;
     }
-
-    meshx_nmc_add(nmc);
+    meshx_net_iface_proxy_filter_src(net_iface, src);
 
     MESHX_INFO("receive network pdu: ctl %d, ttl %d, src 0x%04x, dst 0x%04x, seq 0x%06x, iv_index 0x%08x",
-               net_pdu.net_metadata.ctl,
-               net_pdu.net_metadata.ttl, src, dst, seq, iv_index);
-    MESHX_DUMP_INFO(net_pdu.pdu, trans_pdu_len);
-
-
-    if (meshx_node_is_my_address(dst))
-    {
-        /* message send to me */
-        /* send data to lower transport lower */
-        meshx_msg_ctx_t msg_ctx;
-        memset(&msg_ctx, 0, sizeof(meshx_msg_ctx_t));
-        msg_ctx.ctl = net_pdu.net_metadata.ctl;
-        msg_ctx.ttl = net_pdu.net_metadata.ttl;
-        msg_ctx.src = src;
-        msg_ctx.dst = dst;
-        msg_ctx.iv_index = iv_index;
-        msg_ctx.seq = seq;
-        msg_ctx.pnet_key = pkey_value;
-        msg_ctx.net_iface = net_iface;
-        ret = meshx_lower_trans_receive(net_pdu.pdu, trans_pdu_len, &msg_ctx);
+               pnet_pdu->net_metadata.ctl,
+               pnet_pdu->net_metadata.ttl, src, dst, seq, iv_index);
+    MESHX_DUMP_INFO(pnet_pdu->pdu, trans_pdu_len);
+
+
+    if (!meshx_node_is_accept_address(dst))
+    {
+        MESHX_NET_IFACE_STATS_INC(net_iface, relay_candidates);
+        return meshx_net_relay(net_iface, pnet_pdu, len, iv_index, pkey_value);
     }
-    else
+
+    if (!MESHX_ADDRESS_IS_UNICAST(dst))
     {
-        MESHX_INFO("message need to relay");
-        /* message need to relay */
-        /* TODO: check ttl and relay*/
+        /* group and virtual address are also relayed, queue the copy before lower transport
+           processes the pdu */
+        MESHX_NET_IFACE_STATS_INC(net_iface, relay_candidates);
+        meshx_net_relay(net_iface, pnet_pdu, len, iv_index, pkey_value);
     }
 
+    /* send data to lower transport lower */
+    meshx_msg_ctx_t msg_ctx;
+    memset(&msg_ctx, 0, sizeof(meshx_msg_ctx_t));
+    msg_ctx.ctl = pnet_pdu->net_metadata.ctl;
+    msg_ctx.ttl = pnet_pdu->net_metadata.ttl;
+    msg_ctx.src = src;
+    msg_ctx.dst = dst;
+    msg_ctx.iv_index = iv_index;
+    msg_ctx.seq = seq;
+    msg_ctx.pnet_key = pkey_value;
+    msg_ctx.net_iface = net_iface;
+    MESHX_NET_IFACE_STATS_INC(net_iface, delivered);
+    ret = meshx_lower_trans_receive(pnet_pdu->pdu, trans_pdu_len, &msg_ctx);
+
     return ret;
 }
 
+static int32_t meshx_net_receive_pdu(meshx_net_iface_t net_iface, const uint8_t *pdata,
+                                     uint8_t len, const meshx_adv_metadata_t *padv_metadata)
+{
+    MESHX_DEBUG("receive net data:");
+    MESHX_DUMP_DEBUG(pdata, len);
+
+#if MESHX_REDUNDANCY_CHECK
+    if (NULL == net_iface)
+    {
+        MESHX_ERROR("net interface is NULL");
+        return -MESHX_ERR_INVAL;
+    }
+#endif
+
+    meshx_net_pdu_t net_pdu;
+    uint32_t iv_index;
+    int32_t ret = meshx_net_receive_prepare(net_iface, pdata, len, padv_metadata, &net_pdu,
+                                            &iv_index);
+    if (MESHX_SUCCESS != ret)
+    {
+        return ret;
+    }
+
+    /* get net key */
+    const meshx_net_key_value_t *pkey_value = NULL;
+    ret = meshx_net_receive_decrypt(net_iface, pdata, len, iv_index, &net_pdu, &pkey_value);
+    if (MESHX_SUCCESS != ret)
+    {
+        return ret;
+    }
+
+    return meshx_net_receive_dispatch(net_iface, &net_pdu, len, iv_index, pkey_value);
+}
+
+int32_t meshx_net_receive(meshx_net_iface_t net_iface, const uint8_t *pdata, uint8_t len)
+{
+    return meshx_net_receive_pdu(net_iface, pdata, len, NULL);
+}
+
+int32_t meshx_net_receive_adv(meshx_net_iface_t net_iface, const uint8_t *pdata, uint8_t len,
+                              const meshx_adv_metadata_t *padv_metadata)
+{
+    return meshx_net_receive_pdu(net_iface, pdata, len, padv_metadata);
+}
+
+/**
+ * receive pdus in three stages: privacy of all pdus, decryption of all pdus, and then
+ * deliver in arrival order, pdus that failed with the first candidate key fall back to
+ * single pdu decryption
+ */
+static uint32_t meshx_net_receive_batch_once(meshx_net_iface_t net_iface,
+                                             const uint8_t *const pdata[], const uint8_t len[],
+                                             uint32_t num)
+{
+    meshx_net_pdu_t net_pdu[MESHX_NET_RECEIVE_BATCH_MAX];
+    uint32_t iv_index[MESHX_NET_RECEIVE_BATCH_MAX];
+    const meshx_net_key_value_t *pkey_value[MESHX_NET_RECEIVE_BATCH_MAX];
+    int32_t ret[MESHX_NET_RECEIVE_BATCH_MAX];
+    uint8_t pecb[MESHX_NET_RECEIVE_BATCH_MAX][16];
+    meshx_net_nonce_t net_nonce[MESHX_NET_RECEIVE_BATCH_MAX];
+    meshx_aes_ccm_job_t jobs[MESHX_NET_RECEIVE_BATCH_MAX];
+    uint8_t job_index[MESHX_NET_RECEIVE_BATCH_MAX];
+    const meshx_aes128_ctx_t *pctx[MESHX_NET_RECEIVE_BATCH_MAX];
+    const uint8_t *pinput[MESHX_NET_RECEIVE_BATCH_MAX];
+    uint8_t *poutput[MESHX_NET_RECEIVE_BATCH_MAX];
+    uint32_t pecb_num = 0;
+    uint32_t job_num = 0;
+
+    /* filter, copy and find candidate key */
+    for (uint32_t i = 0; i < num; ++i)
+    {
+        pkey_value[i] = NULL;
+        ret[i] = meshx_net_receive_prepare(net_iface, pdata[i], len[i], NULL, &net_pdu[i],
+                                           &iv_index[i]);
+        if (MESHX_SUCCESS != ret[i])
+        {
+            continue;
+        }
+
+        meshx_net_key_nid_traverse_start(net_pdu[i].net_metadata.nid, &pkey_value[i]);
+        if (NULL == pkey_value[i])
+        {
+            MESHX_NET_IFACE_STATS_INC(net_iface, no_nid_match);
+            MESHX_ERROR("can't decrypt pdu with net key that nid is 0x%x",
+                        net_pdu[i].net_metadata.nid);
+            ret[i] = -MESHX_ERR_KEY;
+            continue;
+        }
+
+        meshx_net_privacy_plaintext(&net_pdu[i], iv_index[i], pecb[i]);
+        pctx[pecb_num] = &pkey_value[i]->privacy_key_ctx;
+        pinput[pecb_num] = pecb[i];
+        poutput[pecb_num ++] = pecb[i];
+    }
+
+    /* restore header of all pdus */
+    meshx_aes128_ctx_encrypt_multi(pctx, pinput, poutput, pecb_num);
+
+    for (uint32_t i = 0; i < num; ++i)
+    {
+        job_index[i] = MESHX_NET_RECEIVE_BATCH_MAX;
+        if (NULL == pkey_value[i])
+        {
+            continue;
+        }
+
+        meshx_net_obfuscation_apply(&net_pdu[i], pecb[i]);
+        if (meshx_net_receive_is_duplicate(&net_pdu[i], iv_index[i]))
+        {
+            MESHX_NET_IFACE_STATS_INC(net_iface, duplicated);
+            pkey_value[i] = NULL;
+            ret[i] = -MESHX_ERR_FAIL;
+            continue;
+        }
+
+        uint8_t trans_pdu_len = meshx_net_trans_pdu_len(&net_pdu[i], len[i]);
+        if (0 == trans_pdu_len)
+        {
+            continue;
+        }
+
+        meshx_net_nonce_init(&net_nonce[i], &net_pdu[i], iv_index[i], MESHX_NONCE_TYPE_NET);
+        uint8_t *pencrypt = (uint8_t *)&net_pdu[i] + MESHX_NET_ENCRYPT_OFFSET;
+        jobs[job_num].pctx = &pkey_value[i]->encryption_key_ctx;
+        jobs[job_num].piv = (const uint8_t *)&net_nonce[i];
+        jobs[job_num].pinput = pencrypt;
+        jobs[job_num].poutput = pencrypt;
+        jobs[job_num].ptag = net_pdu[i].pdu + trans_pdu_len;
+        jobs[job_num].length = sizeof(net_pdu[i].net_metadata.dst) + trans_pdu_len;
+        jobs[job_num].tag_len = net_pdu[i].net_metadata.ctl ? 8 : 4;
+        job_index[i] = job_num ++;
+    }
+
+    /* decrypt all pdus */
+    meshx_aes_ccm_ctx_decrypt_multi(jobs, job_num);
+
+    /* deliver in arrival order */
+    uint32_t receive_num = 0;
+    for (uint32_t i = 0; i < num; ++i)
+    {
+        if (NULL == pkey_value[i])
+        {
+            continue;
+        }
+
+        if ((MESHX_NET_RECEIVE_BATCH_MAX != job_index[i]) &&
+            (MESHX_SUCCESS == jobs[job_index[i]].result))
+        {
+            meshx_net_key_nid_hit(pkey_value[i]);
+        }
+        else
+        {
+            if (MESHX_NET_RECEIVE_BATCH_MAX != job_index[i])
+            {
+                net_decrypt_failed_count ++;
+            }
+            /* maybe other net key has the same nid, first candidate has been tried */
+            ret[i] = meshx_net_receive_decrypt(net_iface, pdata[i], len[i], iv_index[i],
+                                               &net_pdu[i], &pkey_value[i]);
+            if (MESHX_SUCCESS != ret[i])
+            {
+                continue;
+            }
+        }
+
+        ret[i] = meshx_net_receive_dispatch(net_iface, &net_pdu[i], len[i], iv_index[i],
+                                            pkey_value[i]);
+        if (MESHX_SUCCESS == ret[i])
+        {
+            receive_num ++;
+        }
+    }
+
+    return receive_num;
+}
+
+int32_t meshx_net_receive_batch(meshx_net_iface_t net_iface, const uint8_t *const pdata[],
+                                const uint8_t len[], uint32_t num)
+{
+#if MESHX_REDUNDANCY_CHECK
+    if ((NULL == net_iface) || (NULL == pdata) || (NULL == len))
+    {
+        MESHX_ERROR("invalid parameter");
+        return -MESHX_ERR_INVAL;
+    }
+#endif
+
+    uint32_t receive_num = 0;
+    uint32_t batch_num;
+    for (uint32_t offset = 0; offset < num; offset += batch_num)
+    {
+        batch_num = num - offset;
+        if (batch_num > MESHX_NET_RECEIVE_BATCH_MAX)
+        {
+            batch_num = MESHX_NET_RECEIVE_BATCH_MAX;
+        }
+        receive_num += meshx_net_receive_batch_once(net_iface, pdata + offset, len + offset,
+                                                    batch_num);
+    }
+
+    return receive_num;
+}
+
+uint32_t meshx_net_decrypt_failed_count_get(void)
+{
+    return net_decrypt_failed_count;
+}
+
 static int32_t meshx_net_loopback(const uint8_t *pdata, uint8_t len,
                                   const meshx_msg_ctx_t *pmsg_tx_ctx)
 {
@@ -307,31 +695,229 @@ static int32_t meshx_net_send_to_bearer(const uint8_t *pdata, uint8_t len,
         return -MESHX_ERR_FILTER;
     }
 
-    meshx_bearer_t bearer = piface->bearer;
-    if (NULL == bearer)
+    /* send data out */
+    return meshx_net_iface_tx(piface, pdata, len);
+}
+
+static void meshx_net_relay_task_send(meshx_net_relay_task_t *ptask)
+{
+    meshx_msg_ctx_t msg_ctx;
+    memset(&msg_ctx, 0, sizeof(meshx_msg_ctx_t));
+    msg_ctx.src = ptask->src;
+    msg_ctx.dst = ptask->dst;
+
+    meshx_list_t *pnode = NULL;
+    meshx_net_iface_info_t *piface;
+    meshx_list_foreach(pnode, &meshx_net_iface_list)
+    {
+        piface = MESHX_CONTAINER_OF(pnode, meshx_net_iface_info_t, node);
+        if (MESHX_NET_IFACE_TYPE_LOOPBACK == piface->type)
+        {
+            continue;
+        }
+
+        /* advertising bearer is a broadcast medium and multi-peer bearer forwards to other
+           peers, relay on them even if pdu comes from them */
+        if ((ptask->net_iface == piface) && (MESHX_NET_IFACE_TYPE_ADV != piface->type) &&
+            !meshx_bearer_is_multi_peer(piface->bearer))
+        {
+            continue;
+        }
+
+        if (ptask->len > meshx_bearer_mtu_get(piface->bearer))
+        {
+            net_relay_info.mtu_exceeded ++;
+            continue;
+        }
+        meshx_net_send_to_bearer((const uint8_t *)&ptask->net_pdu, ptask->len, &msg_ctx, piface);
+    }
+}
+
+/**
+ * relayed pdus yield to local traffic when any bearer that they go to has queued as many
+ * pdus as would block its interface
+ */
+static bool meshx_net_relay_bearer_congested(const meshx_net_relay_task_t *ptask)
+{
+    uint8_t watermark = meshx_node_params.config.net_tx_high_watermark;
+    if (0 == watermark)
     {
-        MESHX_WARN("net interface(0x%08x) hasn't been connected to any bearer", piface);
-        return -MESHX_ERR_CONNECT;
+        return FALSE;
     }
 
-    /* send data out */
-    int32_t ret = MESHX_SUCCESS;
-    if (MESHX_BEARER_TYPE_ADV == bearer->type)
+    meshx_list_t *pnode = NULL;
+    meshx_net_iface_info_t *piface;
+    meshx_list_foreach(pnode, &meshx_net_iface_list)
     {
-        ret = meshx_bearer_adv_send(bearer, MESHX_BEARER_ADV_PKT_TYPE_MESH_MSG, pdata, len);
+        piface = MESHX_CONTAINER_OF(pnode, meshx_net_iface_info_t, node);
+        if (meshx_bearer_pending_get(piface->bearer) >= watermark)
+        {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+void meshx_net_async_handle_relay_timeout(meshx_async_msg_t msg)
+{
+    meshx_net_relay_task_t *ptask = msg.pdata;
+    if ((ptask->holds < MESHX_NET_RELAY_HOLD_MAX) && meshx_net_relay_bearer_congested(ptask))
+    {
+        ptask->holds ++;
+        net_relay_info.held ++;
+        meshx_timer_start(ptask->timer, meshx_node_params.param.relay_retrans_interval);
+        return ;
+    }
+
+    meshx_net_relay_task_send(ptask);
+    ptask->transmits --;
+    if (ptask->transmits > 0)
+    {
+        meshx_timer_start(ptask->timer, meshx_node_params.param.relay_retrans_interval);
     }
     else
     {
-        ret = meshx_proxy_send(bearer, MESHX_PROXY_MSG_TYPE_NET, pdata, len);
+        net_relay_info.relayed ++;
+        meshx_list_remove(&ptask->node);
+        meshx_list_append(&net_relay_task_idle, &ptask->node);
     }
+}
 
-    return ret;
+/**
+ * decrease ttl, encrypt and obfuscate pdu with the key that it is received with, and
+ * relay it after a random delay
+ */
+static int32_t meshx_net_relay(meshx_net_iface_t net_iface, const meshx_net_pdu_t *pnet_pdu,
+                               uint8_t len, uint32_t iv_index,
+                               const meshx_net_key_value_t *pkey_value)
+{
+    if (!meshx_node_params.param.relay_enable)
+    {
+        return MESHX_SUCCESS;
+    }
+
+    if (MESHX_NET_IFACE_TYPE_LOOPBACK == meshx_net_iface_type(net_iface))
+    {
+        return MESHX_SUCCESS;
+    }
+
+    uint16_t src = MESHX_BE16_TO_HOST(pnet_pdu->net_metadata.src);
+    if (meshx_node_is_my_address(src))
+    {
+        /* echo of pdu sent by myself */
+        return MESHX_SUCCESS;
+    }
+
+    if (pnet_pdu->net_metadata.ttl < 2)
+    {
+        MESHX_DEBUG("pdu can't be relayed: ttl %d", pnet_pdu->net_metadata.ttl);
+        net_relay_info.ttl_dropped ++;
+        return MESHX_SUCCESS;
+    }
+
+    /* pdu to proxy client connected to this node always goes out on its gatt interface */
+    uint16_t dst = MESHX_BE16_TO_HOST(pnet_pdu->net_metadata.dst);
+    if (MESHX_ADDRESS_IS_UNICAST(dst) && !meshx_net_iface_is_proxy_client(dst) &&
+        (MESHX_DF_RELAY_SUPPRESS == meshx_df_relay_check(src, dst)))
+    {
+        /* directed forwarding path exists and this node is not on it */
+        return MESHX_SUCCESS;
+    }
+
+    meshx_list_t *pnode = meshx_list_pop(&net_relay_task_idle);
+    if (NULL == pnode)
+    {
+        MESHX_WARN("relay queue is full, drop pdu from 0x%04x", src);
+        net_relay_info.queue_full ++;
+        return -MESHX_ERR_RESOURCE;
+    }
+    meshx_net_relay_task_t *ptask = MESHX_CONTAINER_OF(pnode, meshx_net_relay_task_t, node);
+
+    ptask->net_pdu = *pnet_pdu;
+    ptask->net_pdu.net_metadata.ttl --;
+    ptask->len = len;
+    ptask->src = src;
+    ptask->dst = dst;
+    ptask->net_iface = net_iface;
+    ptask->transmits = meshx_node_params.param.relay_retrans_count + 1;
+    ptask->holds = 0;
+    meshx_net_encrypt(&ptask->net_pdu, meshx_net_trans_pdu_len(pnet_pdu, len), iv_index, pkey_value,
+                      MESHX_NONCE_TYPE_NET);
+    meshx_net_obfuscation(&ptask->net_pdu, iv_index, pkey_value);
+    meshx_list_append(&net_relay_task_active, &ptask->node);
+
+    uint32_t delay = MESHX_ABS(meshx_rand());
+    delay %= (meshx_node_params.config.relay_delay_max + 1);
+    MESHX_INFO("relay pdu from 0x%04x to 0x%04x after %dms", ptask->src, ptask->dst, delay);
+    if (0 == delay)
+    {
+        meshx_net_relay_timeout_handler(ptask);
+    }
+    else
+    {
+        meshx_timer_start(ptask->timer, delay);
+    }
+
+    return MESHX_SUCCESS;
 }
 
-int32_t meshx_net_send(const uint8_t *ptrans_pdu, uint8_t trans_pdu_len,
-                       const meshx_msg_ctx_t *pmsg_tx_ctx)
+meshx_net_relay_info_t meshx_net_relay_info_get(void)
+{
+    return net_relay_info;
+}
+
+/**
+ * deliver plaintext transport pdu sent to myself to lower transport layer directly,
+ * network message cache is updated as the pdu has been received on loopback interface
+ */
+static int32_t meshx_net_loopback_fast(uint8_t *ptrans_pdu, uint8_t trans_pdu_len,
+                                       const meshx_msg_ctx_t *pmsg_tx_ctx)
+{
+    meshx_net_iface_t loopback_iface = meshx_net_iface_get(NULL);
+    if (NULL == loopback_iface)
+    {
+        MESHX_ERROR("loopback interface is not found");
+        return -MESHX_ERR_NOT_FOUND;
+    }
+
+    meshx_net_iface_ofilter_data_t filter_data = {.src_addr = pmsg_tx_ctx->src, .dst_addr = pmsg_tx_ctx->dst};
+    if (!meshx_net_iface_ofilter(loopback_iface, &filter_data))
+    {
+        MESHX_INFO("network data has been filtered");
+        return -MESHX_ERR_FILTER;
+    }
+
+    meshx_net_iface_ifilter_data_t ifilter_data;
+    memset(&ifilter_data, 0, sizeof(meshx_net_iface_ifilter_data_t));
+    if (!meshx_net_iface_ifilter(loopback_iface, &ifilter_data))
+    {
+        MESHX_WARN("net data has been filtered!");
+        return -MESHX_ERR_FILTER;
+    }
+
+    meshx_nmc_t nmc = {.src = pmsg_tx_ctx->src, .seq = pmsg_tx_ctx->seq, .iv_index = pmsg_tx_ctx->iv_index};
+    if (!meshx_nmc_check_add(nmc))
+    {
+        return -MESHX_ERR_FAIL;
+    }
+
+    meshx_msg_ctx_t msg_ctx;
+    memset(&msg_ctx, 0, sizeof(meshx_msg_ctx_t));
+    msg_ctx.ctl = pmsg_tx_ctx->ctl;
+    msg_ctx.ttl = pmsg_tx_ctx->ttl;
+    msg_ctx.src = pmsg_tx_ctx->src;
+    msg_ctx.dst = pmsg_tx_ctx->dst;
+    msg_ctx.iv_index = pmsg_tx_ctx->iv_index;
+    msg_ctx.seq = pmsg_tx_ctx->seq;
+    msg_ctx.pnet_key = pmsg_tx_ctx->pnet_key;
+    msg_ctx.net_iface = loopback_iface;
+    return meshx_lower_trans_receive(ptrans_pdu, trans_pdu_len, &msg_ctx);
+}
+
+static int32_t meshx_net_check_trans_pdu_len(uint8_t trans_pdu_len,
+                                             const meshx_msg_ctx_t *pmsg_tx_ctx)
 {
-#if MESHX_REDUNDANCY_CHECK
     if (trans_pdu_len > MESHX_NET_TRANS_PDU_MAX_LEN)
     {
         return -MESHX_ERR_LENGTH;
@@ -353,33 +939,63 @@ int32_t meshx_net_send(const uint8_t *ptrans_pdu, uint8_t trans_pdu_len,
             return -MESHX_ERR_LENGTH;
         }
     }
-#endif
 
+    return MESHX_SUCCESS;
+}
+
+/**
+ * fill net header, encrypt and obfuscate in place
+ * @return length of network pdu
+ */
+static uint8_t meshx_net_pdu_seal(meshx_net_pdu_t *pnet_pdu, uint8_t trans_pdu_len,
+                                  const meshx_msg_ctx_t *pmsg_tx_ctx, uint8_t nonce_type)
+{
     uint32_t seq = pmsg_tx_ctx->seq;
-    meshx_net_pdu_t net_pdu = {0};
-    net_pdu.net_metadata.ivi = (pmsg_tx_ctx->iv_index & 0x01);
-    net_pdu.net_metadata.nid = pmsg_tx_ctx->pnet_key->nid;
-    net_pdu.net_metadata.ctl = pmsg_tx_ctx->ctl;
-    net_pdu.net_metadata.ttl = pmsg_tx_ctx->ttl;
-    net_pdu.net_metadata.seq[0] = seq >> 16;
-    net_pdu.net_metadata.seq[1] = seq >> 8;
-    net_pdu.net_metadata.seq[2] = seq;
-    net_pdu.net_metadata.src = MESHX_HOST_TO_BE16(pmsg_tx_ctx->src);
-    net_pdu.net_metadata.dst = MESHX_HOST_TO_BE16(pmsg_tx_ctx->dst);
-    memcpy(net_pdu.pdu, ptrans_pdu, trans_pdu_len);
+    pnet_pdu->net_metadata.ivi = (pmsg_tx_ctx->iv_index & 0x01);
+    pnet_pdu->net_metadata.nid = pmsg_tx_ctx->pnet_key->nid;
+    pnet_pdu->net_metadata.ctl = pmsg_tx_ctx->ctl;
+    pnet_pdu->net_metadata.ttl = pmsg_tx_ctx->ttl;
+    pnet_pdu->net_metadata.seq[0] = seq >> 16;
+    pnet_pdu->net_metadata.seq[1] = seq >> 8;
+    pnet_pdu->net_metadata.seq[2] = seq;
+    pnet_pdu->net_metadata.src = MESHX_HOST_TO_BE16(pmsg_tx_ctx->src);
+    pnet_pdu->net_metadata.dst = MESHX_HOST_TO_BE16(pmsg_tx_ctx->dst);
     uint8_t net_mic_len = pmsg_tx_ctx->ctl ? 8 : 4;
     uint8_t net_pdu_len = sizeof(meshx_net_metadata_t) + trans_pdu_len + net_mic_len;
     MESHX_DEBUG("origin net pdu:");
-    MESHX_DUMP_DEBUG(&net_pdu, net_pdu_len);
+    MESHX_DUMP_DEBUG(pnet_pdu, net_pdu_len);
 
     /* encrypt dst field and trans pdu */
-    meshx_net_encrypt(&net_pdu, trans_pdu_len, pmsg_tx_ctx->iv_index, pmsg_tx_ctx->pnet_key);
+    meshx_net_encrypt(pnet_pdu, trans_pdu_len, pmsg_tx_ctx->iv_index, pmsg_tx_ctx->pnet_key,
+                      nonce_type);
 
     /* obfuscation ctl, ttl, seq, src fields */
-    meshx_net_obfuscation(&net_pdu, pmsg_tx_ctx->iv_index, pmsg_tx_ctx->pnet_key);
+    meshx_net_obfuscation(pnet_pdu, pmsg_tx_ctx->iv_index, pmsg_tx_ctx->pnet_key);
 
     MESHX_DEBUG("encrypt and obsfucation net pdu:");
-    MESHX_DUMP_DEBUG(&net_pdu, net_pdu_len);
+    MESHX_DUMP_DEBUG(pnet_pdu, net_pdu_len);
+
+    return net_pdu_len;
+}
+
+/**
+ * transport pdu has been placed in pnet_pdu->pdu, fill net header, encrypt and obfuscate
+ * in place, then send it out, buffer must have room for net mic after transport pdu
+ */
+static int32_t meshx_net_send_pdu(meshx_net_pdu_t *pnet_pdu, uint8_t trans_pdu_len,
+                                  const meshx_msg_ctx_t *pmsg_tx_ctx)
+{
+    if (meshx_node_params.config.loopback_fast_path)
+    {
+        if (((NULL == pmsg_tx_ctx->net_iface) && meshx_node_is_my_address(pmsg_tx_ctx->dst)) ||
+            (MESHX_NET_IFACE_TYPE_LOOPBACK == meshx_net_iface_type(pmsg_tx_ctx->net_iface)))
+        {
+            return meshx_net_loopback_fast(pnet_pdu->pdu, trans_pdu_len, pmsg_tx_ctx);
+        }
+    }
+
+    uint8_t net_pdu_len = meshx_net_pdu_seal(pnet_pdu, trans_pdu_len, pmsg_tx_ctx,
+                                             MESHX_NONCE_TYPE_NET);
 
     int32_t ret = MESHX_SUCCESS;
     if (NULL == pmsg_tx_ctx->net_iface)
@@ -387,12 +1003,18 @@ int32_t meshx_net_send(const uint8_t *ptrans_pdu, uint8_t trans_pdu_len,
         /* TODO: check wheter is lpn addr? */
         if (meshx_node_is_my_address(pmsg_tx_ctx->dst))
         {
-            ret = meshx_net_loopback((const uint8_t *)&net_pdu, net_pdu_len, pmsg_tx_ctx);
+            ret = meshx_net_loopback((const uint8_t *)pnet_pdu, net_pdu_len, pmsg_tx_ctx);
         }
         else
         {
-            /* code */
+            /**
+             * pdu is sent if any interface accepts it, and caller shall pause if any
+             * interface would block
+             */
             bool valid_iface = FALSE;
+            bool sent = FALSE;
+            bool would_block = FALSE;
+            int32_t iface_ret;
             meshx_list_t *pnode = NULL;
             meshx_net_iface_info_t *piface;
             meshx_list_foreach(pnode, &meshx_net_iface_list)
@@ -402,7 +1024,20 @@ int32_t meshx_net_send(const uint8_t *ptrans_pdu, uint8_t trans_pdu_len,
                 {
                     continue;
                 }
-                meshx_net_send_to_bearer((const uint8_t *)&net_pdu, net_pdu_len, pmsg_tx_ctx, piface);
+                iface_ret = meshx_net_send_to_bearer((const uint8_t *)pnet_pdu, net_pdu_len, pmsg_tx_ctx,
+                                                     piface);
+                if (MESHX_SUCCESS == iface_ret)
+                {
+                    sent = TRUE;
+                }
+                else if (-MESHX_ERR_AGAIN == iface_ret)
+                {
+                    would_block = TRUE;
+                }
+                else
+                {
+                    ret = iface_ret;
+                }
                 valid_iface = TRUE;
             }
 
@@ -411,6 +1046,15 @@ int32_t meshx_net_send(const uint8_t *ptrans_pdu, uint8_t trans_pdu_len,
                 MESHX_ERROR("no invalid network interface!");
                 return -MESHX_ERR_INVAL_NET_IFACE;
             }
+
+            if (would_block)
+            {
+                ret = -MESHX_ERR_AGAIN;
+            }
+            else if (sent)
+            {
+                ret = MESHX_SUCCESS;
+            }
         }
     }
     else
@@ -419,13 +1063,134 @@ int32_t meshx_net_send(const uint8_t *ptrans_pdu, uint8_t trans_pdu_len,
         meshx_net_iface_info_t *piface = (meshx_net_iface_info_t *)pmsg_tx_ctx->net_iface;
         if (MESHX_NET_IFACE_TYPE_LOOPBACK == piface->type)
         {
-            ret = meshx_net_loopback((const uint8_t *)&net_pdu, net_pdu_len, pmsg_tx_ctx);
+            ret = meshx_net_loopback((const uint8_t *)pnet_pdu, net_pdu_len, pmsg_tx_ctx);
         }
         else
         {
-            ret = meshx_net_send_to_bearer((const uint8_t *)&net_pdu, net_pdu_len, pmsg_tx_ctx, piface);
+            ret = meshx_net_send_to_bearer((const uint8_t *)pnet_pdu, net_pdu_len, pmsg_tx_ctx, piface);
         }
     }
 
     return ret;
 }
+
+int32_t meshx_net_send(const uint8_t *ptrans_pdu, uint8_t trans_pdu_len,
+                       const meshx_msg_ctx_t *pmsg_tx_ctx)
+{
+#if MESHX_REDUNDANCY_CHECK
+    int32_t ret = meshx_net_check_trans_pdu_len(trans_pdu_len, pmsg_tx_ctx);
+    if (MESHX_SUCCESS != ret)
+    {
+        return ret;
+    }
+#endif
+
+    meshx_net_pdu_t net_pdu;
+    memcpy(net_pdu.pdu, ptrans_pdu, trans_pdu_len);
+
+    return meshx_net_send_pdu(&net_pdu, trans_pdu_len, pmsg_tx_ctx);
+}
+
+int32_t meshx_net_send_pkt(meshx_pkt_t *ppkt, const meshx_msg_ctx_t *pmsg_tx_ctx)
+{
+#if MESHX_REDUNDANCY_CHECK
+    int32_t ret = meshx_net_check_trans_pdu_len(ppkt->len, pmsg_tx_ctx);
+    if (MESHX_SUCCESS != ret)
+    {
+        return ret;
+    }
+#endif
+
+    uint8_t trans_pdu_len = ppkt->len;
+    uint8_t net_mic_len = pmsg_tx_ctx->ctl ? 8 : 4;
+    if ((NULL == meshx_pkt_put(ppkt, net_mic_len)) ||
+        (NULL == meshx_pkt_push(ppkt, sizeof(meshx_net_metadata_t))))
+    {
+        return -MESHX_ERR_LENGTH;
+    }
+
+    return meshx_net_send_pdu((meshx_net_pdu_t *)ppkt->pdata, trans_pdu_len, pmsg_tx_ctx);
+}
+
+int32_t meshx_net_proxy_cfg_receive(meshx_net_iface_t net_iface, const uint8_t *pdata, uint8_t len,
+                                    uint8_t *ptrans_pdu, uint8_t *ptrans_pdu_len,
+                                    meshx_msg_ctx_t *pmsg_rx_ctx)
+{
+    meshx_net_pdu_t net_pdu;
+    uint32_t iv_index;
+    int32_t ret = meshx_net_receive_prepare(net_iface, pdata, len, NULL, &net_pdu, &iv_index);
+    if (MESHX_SUCCESS != ret)
+    {
+        return ret;
+    }
+
+    const meshx_net_key_value_t *pkey_value = NULL;
+    meshx_net_key_nid_traverse_start(net_pdu.net_metadata.nid, &pkey_value);
+    while (NULL != pkey_value)
+    {
+        memcpy(&net_pdu, pdata, len);
+        meshx_net_obfuscation(&net_pdu, iv_index, pkey_value);
+        uint8_t trans_pdu_len = meshx_net_trans_pdu_len(&net_pdu, len);
+        /* proxy configuration message is control message with ttl 0 */
+        if (net_pdu.net_metadata.ctl && (0 == net_pdu.net_metadata.ttl) && (0 != trans_pdu_len) &&
+            (MESHX_SUCCESS == meshx_net_decrypt(&net_pdu, trans_pdu_len, iv_index, pkey_value,
+                                                MESHX_NONCE_TYPE_PROXY)))
+        {
+            if (MESHX_ADDRESS_UNASSIGNED != MESHX_BE16_TO_HOST(net_pdu.net_metadata.dst))
+            {
+                MESHX_WARN("invalid proxy configuration message destination");
+                return -MESHX_ERR_INVAL;
+            }
+
+            uint16_t src = MESHX_BE16_TO_HOST(net_pdu.net_metadata.src);
+            uint32_t seq = meshx_net_pdu_seq(&net_pdu);
+            meshx_nmc_t nmc = {.src = src, .seq = seq, .iv_index = iv_index};
+            if (!meshx_nmc_check_add(nmc))
+            {
+                return -MESHX_ERR_FAIL;
+            }
+
+            memset(pmsg_rx_ctx, 0, sizeof(meshx_msg_ctx_t));
+            pmsg_rx_ctx->ctl = 1;
+            pmsg_rx_ctx->src = src;
+            pmsg_rx_ctx->seq = seq;
+            pmsg_rx_ctx->iv_index = iv_index;
+            pmsg_rx_ctx->pnet_key = pkey_value;
+            pmsg_rx_ctx->net_iface = net_iface;
+            memcpy(ptrans_pdu, net_pdu.pdu, trans_pdu_len);
+            *ptrans_pdu_len = trans_pdu_len;
+            meshx_net_iface_proxy_filter_src(net_iface, src);
+            return MESHX_SUCCESS;
+        }
+        meshx_net_key_nid_traverse_continue(&pkey_value);
+    }
+
+    MESHX_WARN("can't decrypt proxy configuration message");
+    return -MESHX_ERR_KEY;
+}
+
+int32_t meshx_net_proxy_cfg_send(const uint8_t *ptrans_pdu, uint8_t trans_pdu_len,
+                                 const meshx_msg_ctx_t *pmsg_tx_ctx)
+{
+    meshx_net_iface_info_t *piface = (meshx_net_iface_info_t *)pmsg_tx_ctx->net_iface;
+    if ((NULL == piface) || (MESHX_NET_IFACE_TYPE_GATT != piface->type) || (NULL == piface->bearer))
+    {
+        MESHX_ERROR("proxy configuration message can only be sent on gatt interface");
+        return -MESHX_ERR_INVAL_NET_IFACE;
+    }
+
+    if (trans_pdu_len > MESHX_NET_TRANS_PDU_MAX_LEN - 8)
+    {
+        MESHX_ERROR("invalid proxy configuration message length: %d", trans_pdu_len);
+        return -MESHX_ERR_LENGTH;
+    }
+
+    meshx_net_pdu_t net_pdu;
+    memcpy(net_pdu.pdu, ptrans_pdu, trans_pdu_len);
+    uint8_t net_pdu_len = meshx_net_pdu_seal(&net_pdu, trans_pdu_len, pmsg_tx_ctx,
+                                             MESHX_NONCE_TYPE_PROXY);
+
+    /* proxy configuration message is not filtered */
+    return meshx_proxy_send(piface->bearer, MESHX_PROXY_MSG_TYPE_PROXY_CFG,
+                            (const uint8_t *)&net_pdu, net_pdu_len);
+}
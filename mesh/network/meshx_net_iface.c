@@ -14,6 +14,10 @@
 #include "meshx_net_internal.h"
 #include "meshx_bearer_internal.h"
 #include "meshx_list.h"
+#include "meshx_node_internal.h"
+#include "meshx_trans_internal.h"
+#include "meshx_misc.h"
+#include "meshx_hash_internal.h"
 
 meshx_list_t meshx_net_iface_list;
 
@@ -31,6 +35,214 @@ static bool meshx_net_default_ofilter(meshx_net_iface_t net_iface,
     return TRUE;
 }
 
+static uint32_t meshx_net_proxy_filter_hash(const meshx_net_proxy_filter_t *pfilter, uint16_t addr)
+{
+    return meshx_hash_u32(addr) & pfilter->table_mask;
+}
+
+static uint32_t meshx_net_proxy_filter_home(uint16_t value, const void *pargs)
+{
+    return meshx_net_proxy_filter_hash(pargs, value);
+}
+
+/**
+ * @return slot of address or empty slot that address can be inserted
+ */
+static uint32_t meshx_net_proxy_filter_find(const meshx_net_proxy_filter_t *pfilter, uint16_t addr)
+{
+    uint32_t slot = meshx_net_proxy_filter_hash(pfilter, addr);
+    while ((MESHX_ADDRESS_UNASSIGNED != pfilter->ptable[slot]) && (pfilter->ptable[slot] != addr))
+    {
+        slot = (slot + 1) & pfilter->table_mask;
+    }
+
+    return slot;
+}
+
+static int32_t meshx_net_proxy_filter_alloc(meshx_net_proxy_filter_t *pfilter)
+{
+    uint16_t filter_size = meshx_node_params.config.proxy_filter_size;
+    pfilter->type = MESHX_NET_PROXY_FILTER_TYPE_ACCEPT;
+    pfilter->num = 0;
+    if (0 == filter_size)
+    {
+        pfilter->ptable = NULL;
+        pfilter->table_mask = 0;
+        return MESHX_SUCCESS;
+    }
+
+    uint32_t table_size = meshx_hash_table_size(filter_size);
+
+    pfilter->ptable = meshx_malloc(table_size * sizeof(uint16_t));
+    if (NULL == pfilter->ptable)
+    {
+        MESHX_ERROR("allocate proxy filter failed: out of memory");
+        return -MESHX_ERR_MEM;
+    }
+    memset(pfilter->ptable, 0, table_size * sizeof(uint16_t));
+    pfilter->table_mask = table_size - 1;
+
+    return MESHX_SUCCESS;
+}
+
+static void meshx_net_proxy_filter_free(meshx_net_proxy_filter_t *pfilter)
+{
+    if (NULL != pfilter->ptable)
+    {
+        meshx_free(pfilter->ptable);
+        pfilter->ptable = NULL;
+    }
+    pfilter->num = 0;
+}
+
+static bool meshx_net_proxy_filter_pass(const meshx_net_proxy_filter_t *pfilter, uint16_t dst)
+{
+    bool in_list = FALSE;
+    if (0 != pfilter->num)
+    {
+        in_list = (dst == pfilter->ptable[meshx_net_proxy_filter_find(pfilter, dst)]);
+    }
+
+    return (MESHX_NET_PROXY_FILTER_TYPE_ACCEPT == pfilter->type) ? in_list : !in_list;
+}
+
+static int32_t meshx_net_adv_dedup_alloc(meshx_net_adv_dedup_t *pdedup)
+{
+    uint8_t dedup_size = meshx_node_params.config.adv_dedup_size;
+    pdedup->next = 0;
+    pdedup->pentries = NULL;
+    if ((0 == dedup_size) || (0 == meshx_node_params.config.adv_dedup_window))
+    {
+        return MESHX_SUCCESS;
+    }
+
+    pdedup->pentries = meshx_malloc(dedup_size * sizeof(meshx_net_adv_dedup_entry_t));
+    if (NULL == pdedup->pentries)
+    {
+        MESHX_ERROR("allocate adv dedup cache failed: out of memory");
+        return -MESHX_ERR_MEM;
+    }
+    memset(pdedup->pentries, 0, dedup_size * sizeof(meshx_net_adv_dedup_entry_t));
+
+    return MESHX_SUCCESS;
+}
+
+static void meshx_net_adv_dedup_free(meshx_net_adv_dedup_t *pdedup)
+{
+    if (NULL != pdedup->pentries)
+    {
+        meshx_free(pdedup->pentries);
+        pdedup->pentries = NULL;
+    }
+}
+
+/* fnv-1a */
+static uint32_t meshx_net_adv_payload_hash(const uint8_t *pdata, uint8_t len)
+{
+    uint32_t hash = 0x811c9dc5;
+    for (uint8_t i = 0; i < len; ++i)
+    {
+        hash ^= pdata[i];
+        hash *= 0x01000193;
+    }
+
+    return hash;
+}
+
+/**
+ * @return TRUE if the same payload has been received in window, payload is remembered
+ *         otherwise
+ */
+static bool meshx_net_adv_dedup_check_add(meshx_net_adv_dedup_t *pdedup, const uint8_t *pdata,
+                                          uint8_t len)
+{
+    if (NULL == pdedup->pentries)
+    {
+        return FALSE;
+    }
+
+    uint32_t hash = meshx_net_adv_payload_hash(pdata, len);
+    uint32_t now = meshx_time_get();
+    meshx_net_adv_dedup_entry_t *pentry;
+    for (uint8_t i = 0; i < meshx_node_params.config.adv_dedup_size; ++i)
+    {
+        pentry = &pdedup->pentries[i];
+        if ((len == pentry->len) && (hash == pentry->hash) &&
+            ((uint32_t)(now - pentry->time) < meshx_node_params.config.adv_dedup_window))
+        {
+            return TRUE;
+        }
+    }
+
+    /* replace the oldest one */
+    pentry = &pdedup->pentries[pdedup->next];
+    pentry->hash = hash;
+    pentry->time = now;
+    pentry->len = len;
+    pdedup->next ++;
+    if (pdedup->next >= meshx_node_params.config.adv_dedup_size)
+    {
+        pdedup->next = 0;
+    }
+
+    return FALSE;
+}
+
+/**
+ * pdus that bearer can't accept are kept in order and sent when bearer notifies it is ready,
+ * interface stays blocked from high watermark until queue drains to low watermark, so
+ * lower transport can pause segments instead of losing them
+ */
+static int32_t meshx_net_tx_queue_alloc(meshx_net_tx_queue_t *pqueue)
+{
+    uint8_t queue_size = meshx_node_params.config.net_tx_queue_size;
+    meshx_list_init_head(&pqueue->idle);
+    meshx_list_init_head(&pqueue->pending);
+    pqueue->depth = 0;
+    pqueue->blocked = FALSE;
+    pqueue->ready_posted = FALSE;
+    pqueue->flushing = FALSE;
+    pqueue->pentries = NULL;
+    if (0 == queue_size)
+    {
+        return MESHX_SUCCESS;
+    }
+
+    pqueue->pentries = meshx_malloc(queue_size * sizeof(meshx_net_tx_entry_t));
+    if (NULL == pqueue->pentries)
+    {
+        MESHX_ERROR("allocate net tx queue failed: out of memory");
+        return -MESHX_ERR_MEM;
+    }
+
+    for (uint8_t i = 0; i < queue_size; ++i)
+    {
+        meshx_list_append(&pqueue->idle, &pqueue->pentries[i].node);
+    }
+
+    return MESHX_SUCCESS;
+}
+
+static void meshx_net_tx_queue_free(meshx_net_tx_queue_t *pqueue)
+{
+    bool blocked = pqueue->blocked;
+    if (NULL != pqueue->pentries)
+    {
+        meshx_free(pqueue->pentries);
+        pqueue->pentries = NULL;
+    }
+    meshx_list_init_head(&pqueue->idle);
+    meshx_list_init_head(&pqueue->pending);
+    pqueue->depth = 0;
+    pqueue->blocked = FALSE;
+
+    if (blocked)
+    {
+        /* segments paused by this interface can go on other interfaces */
+        meshx_lower_trans_tx_resume();
+    }
+}
+
 static meshx_net_iface_info_t *meshx_request_net_iface(void)
 {
     if (meshx_list_length(&meshx_net_iface_list) >= MESHX_NET_IFACE_MAX_NUM)
@@ -39,7 +251,8 @@ static meshx_net_iface_info_t *meshx_request_net_iface(void)
         return NULL;
     }
 
-    return meshx_malloc(sizeof(meshx_net_iface_info_t));
+    /* keep statistics on their own cache line */
+    return meshx_malloc_aligned(MESHX_CACHE_LINE_SIZE, sizeof(meshx_net_iface_info_t));
 }
 
 static void meshx_release_net_iface(meshx_net_iface_info_t *piface)
@@ -49,6 +262,9 @@ static void meshx_release_net_iface(meshx_net_iface_info_t *piface)
     {
         piface->bearer->net_iface = NULL;
     }
+    meshx_net_proxy_filter_free(&piface->proxy_filter);
+    meshx_net_adv_dedup_free(&piface->adv_dedup);
+    meshx_net_tx_queue_free(&piface->tx_queue);
     meshx_free(piface);
 }
 
@@ -86,7 +302,9 @@ meshx_net_iface_t meshx_net_iface_create(void)
         MESHX_ERROR("create net interface failed");
         return NULL;
     }
-    memset(piface, 0, sizeof(meshx_net_iface_t));
+    memset(piface, 0, sizeof(meshx_net_iface_info_t));
+    meshx_list_init_head(&piface->tx_queue.idle);
+    meshx_list_init_head(&piface->tx_queue.pending);
     meshx_list_append(&meshx_net_iface_list, &piface->node);
 
     MESHX_INFO("create net interface(0x%08x) success", piface);
@@ -128,14 +346,33 @@ int32_t meshx_net_iface_connect(meshx_net_iface_t net_iface, meshx_bearer_t bear
         return -MESHX_ERR_ALREADY;
     }
 
+    if (MESHX_SUCCESS != meshx_net_tx_queue_alloc(&piface->tx_queue))
+    {
+        return -MESHX_ERR_MEM;
+    }
+
     if (MESHX_BEARER_TYPE_ADV == bearer->type)
     {
+        if (MESHX_SUCCESS != meshx_net_adv_dedup_alloc(&piface->adv_dedup))
+        {
+            meshx_net_tx_queue_free(&piface->tx_queue);
+            return -MESHX_ERR_MEM;
+        }
         piface->type = MESHX_NET_IFACE_TYPE_ADV;
     }
-    else
+    else if (MESHX_BEARER_TYPE_GATT == bearer->type)
     {
+        if (MESHX_SUCCESS != meshx_net_proxy_filter_alloc(&piface->proxy_filter))
+        {
+            meshx_net_tx_queue_free(&piface->tx_queue);
+            return -MESHX_ERR_MEM;
+        }
         piface->type = MESHX_NET_IFACE_TYPE_GATT;
     }
+    else
+    {
+        piface->type = MESHX_NET_IFACE_TYPE_BEARER;
+    }
 
     piface->bearer = bearer;
     bearer->net_iface = piface;
@@ -178,6 +415,10 @@ void meshx_net_iface_disconnect(meshx_net_iface_t net_iface)
     }
     piface->bearer = NULL;
     memset(&piface->filter_info, 0, sizeof(meshx_net_iface_filter_info_t));
+    memset(&piface->stats, 0, sizeof(meshx_net_iface_stats_t));
+    meshx_net_proxy_filter_free(&piface->proxy_filter);
+    meshx_net_adv_dedup_free(&piface->adv_dedup);
+    meshx_net_tx_queue_free(&piface->tx_queue);
     piface->ifilter = NULL;
     piface->ofilter = NULL;
 }
@@ -211,6 +452,24 @@ bool meshx_net_iface_ifilter(meshx_net_iface_t net_iface,
     meshx_net_iface_info_t *piface = (meshx_net_iface_info_t *)net_iface;
 
     piface->filter_info.total_receive ++;
+    if (NULL != pdata->padv_metadata)
+    {
+        /* built-in filter of advertising reports, run before user filter */
+        if (pdata->padv_metadata->rssi < meshx_node_params.config.adv_rssi_floor)
+        {
+            piface->stats.low_rssi ++;
+            piface->filter_info.filtered_receive ++;
+            return FALSE;
+        }
+
+        if (meshx_net_adv_dedup_check_add(&piface->adv_dedup, pdata->pdata, pdata->len))
+        {
+            piface->stats.adv_duplicated ++;
+            piface->filter_info.filtered_receive ++;
+            return FALSE;
+        }
+    }
+
     if (!piface->ifilter(piface, pdata))
     {
         piface->filter_info.filtered_receive ++;
@@ -227,7 +486,9 @@ bool meshx_net_iface_ofilter(meshx_net_iface_t net_iface,
     meshx_net_iface_info_t *piface = (meshx_net_iface_info_t *)net_iface;
 
     piface->filter_info.total_send ++;
-    if (!piface->ofilter(piface, pdata))
+    if (!piface->ofilter(piface, pdata) ||
+        ((MESHX_NET_IFACE_TYPE_GATT == piface->type) &&
+         !meshx_net_proxy_filter_pass(&piface->proxy_filter, pdata->dst_addr)))
     {
         piface->filter_info.filtered_send ++;
         return FALSE;
@@ -236,6 +497,158 @@ bool meshx_net_iface_ofilter(meshx_net_iface_t net_iface,
     return TRUE;
 }
 
+static int32_t meshx_net_iface_bearer_send(meshx_net_iface_info_t *piface, const uint8_t *pdata,
+                                           uint8_t len)
+{
+    meshx_bearer_t bearer = piface->bearer;
+    if (NULL == bearer)
+    {
+        MESHX_WARN("net interface(0x%08x) hasn't been connected to any bearer", piface);
+        return -MESHX_ERR_CONNECT;
+    }
+
+    int32_t ret = meshx_bearer_send(bearer, pdata, len);
+    if (MESHX_SUCCESS == ret)
+    {
+        piface->stats.sent ++;
+    }
+    else if (-MESHX_ERR_BUSY != ret)
+    {
+        /* busy bearer is accounted by tx queue */
+        piface->stats.bearer_error ++;
+    }
+
+    return ret;
+}
+
+static void meshx_net_iface_tx_flush(meshx_net_iface_info_t *piface)
+{
+    meshx_net_tx_queue_t *pqueue = &piface->tx_queue;
+    if (pqueue->flushing)
+    {
+        return ;
+    }
+
+    if (!meshx_bearer_is_writable(piface->bearer))
+    {
+        return ;
+    }
+
+    pqueue->flushing = TRUE;
+    meshx_list_t *pnode;
+    while (NULL != (pnode = meshx_list_pop(&pqueue->pending)))
+    {
+        meshx_net_tx_entry_t *pentry = MESHX_CONTAINER_OF(pnode, meshx_net_tx_entry_t, node);
+        if (-MESHX_ERR_BUSY == meshx_net_iface_bearer_send(piface, pentry->data, pentry->len))
+        {
+            meshx_list_prepend(&pqueue->pending, pnode);
+            break;
+        }
+        meshx_list_append(&pqueue->idle, pnode);
+        pqueue->depth --;
+    }
+    pqueue->flushing = FALSE;
+
+    if (pqueue->blocked && (pqueue->depth <= meshx_node_params.config.net_tx_low_watermark))
+    {
+        pqueue->blocked = FALSE;
+        MESHX_DEBUG("net interface(0x%08x) is writable", piface);
+        meshx_lower_trans_tx_resume();
+    }
+}
+
+int32_t meshx_net_iface_tx(meshx_net_iface_t net_iface, const uint8_t *pdata, uint8_t len)
+{
+    MESHX_ASSERT(NULL != net_iface);
+    meshx_net_iface_info_t *piface = (meshx_net_iface_info_t *)net_iface;
+    meshx_net_tx_queue_t *pqueue = &piface->tx_queue;
+
+    /* don't queue pdu that bearer never accepts */
+    if ((NULL != piface->bearer) && (len > meshx_bearer_mtu_get(piface->bearer)))
+    {
+        MESHX_ERROR("net interface(0x%08x) send failed: length %d exceeds mtu", piface, len);
+        piface->stats.bearer_error ++;
+        return -MESHX_ERR_LENGTH;
+    }
+
+    if (0 != pqueue->depth)
+    {
+        meshx_net_iface_tx_flush(piface);
+    }
+
+    /* pdu is queued directly if bearer hasn't recovered from busy */
+    if ((0 == pqueue->depth) &&
+        ((NULL == pqueue->pentries) || meshx_bearer_is_writable(piface->bearer)))
+    {
+        int32_t ret = meshx_net_iface_bearer_send(piface, pdata, len);
+        if ((-MESHX_ERR_BUSY != ret) || (NULL == pqueue->pentries))
+        {
+            return ret;
+        }
+    }
+
+    meshx_list_t *pnode = meshx_list_pop(&pqueue->idle);
+    if (NULL == pnode)
+    {
+        MESHX_WARN("net interface(0x%08x) tx queue is full, drop pdu", piface);
+        piface->filter_info.dropped_send ++;
+        return -MESHX_ERR_BUSY;
+    }
+
+    meshx_net_tx_entry_t *pentry = MESHX_CONTAINER_OF(pnode, meshx_net_tx_entry_t, node);
+    memcpy(pentry->data, pdata, len);
+    pentry->len = len;
+    meshx_list_append(&pqueue->pending, pnode);
+    pqueue->depth ++;
+    piface->filter_info.queued_send ++;
+
+    if (!pqueue->blocked && (pqueue->depth >= meshx_node_params.config.net_tx_high_watermark))
+    {
+        pqueue->blocked = TRUE;
+        piface->filter_info.blocked_send ++;
+        MESHX_DEBUG("net interface(0x%08x) would block: %d pdus queued", piface, pqueue->depth);
+    }
+
+    return pqueue->blocked ? -MESHX_ERR_AGAIN : MESHX_SUCCESS;
+}
+
+void meshx_net_iface_tx_ready(meshx_net_iface_t net_iface)
+{
+    meshx_net_iface_info_t *piface = (meshx_net_iface_info_t *)net_iface;
+    if ((NULL == piface) || (0 == piface->tx_queue.depth) || piface->tx_queue.ready_posted)
+    {
+        return ;
+    }
+
+    meshx_async_msg_t msg;
+    msg.type = MESHX_ASYNC_MSG_TYPE_NET_IFACE_TX_READY;
+    msg.pdata = piface;
+    msg.data_len = 0;
+    /* message may be handled before send returns */
+    piface->tx_queue.ready_posted = TRUE;
+    if (MESHX_SUCCESS != meshx_async_msg_send(&msg))
+    {
+        piface->tx_queue.ready_posted = FALSE;
+    }
+}
+
+void meshx_net_iface_async_handle_tx_ready(meshx_async_msg_t msg)
+{
+    /* interface may be deleted before message is handled */
+    meshx_list_t *pnode;
+    meshx_net_iface_info_t *piface;
+    meshx_list_foreach(pnode, &meshx_net_iface_list)
+    {
+        piface = MESHX_CONTAINER_OF(pnode, meshx_net_iface_info_t, node);
+        if (piface == msg.pdata)
+        {
+            piface->tx_queue.ready_posted = FALSE;
+            meshx_net_iface_tx_flush(piface);
+            break;
+        }
+    }
+}
+
 meshx_net_iface_filter_info_t meshx_net_iface_get_filter_info(meshx_net_iface_t net_iface)
 {
     meshx_net_iface_filter_info_t filter_info;
@@ -249,6 +662,34 @@ meshx_net_iface_filter_info_t meshx_net_iface_get_filter_info(meshx_net_iface_t
     return piface->filter_info;
 }
 
+meshx_net_iface_stats_t meshx_net_iface_stats_get(meshx_net_iface_t net_iface)
+{
+    meshx_net_iface_stats_t stats;
+    memset(&stats, 0, sizeof(meshx_net_iface_stats_t));
+    meshx_net_iface_info_t *piface = (meshx_net_iface_info_t *)net_iface;
+    if (NULL == piface)
+    {
+        return stats;
+    }
+
+    /* received and filtered pdus are counted by input filter */
+    stats = piface->stats;
+    stats.received = piface->filter_info.total_receive;
+    stats.filtered = piface->filter_info.filtered_receive;
+
+    return stats;
+}
+
+void meshx_net_iface_stats_reset(meshx_net_iface_t net_iface)
+{
+    meshx_net_iface_info_t *piface = (meshx_net_iface_info_t *)net_iface;
+    if (NULL != piface)
+    {
+        memset(&piface->stats, 0, sizeof(meshx_net_iface_stats_t));
+        memset(&piface->filter_info, 0, sizeof(meshx_net_iface_filter_info_t));
+    }
+}
+
 meshx_net_iface_t meshx_net_iface_get(meshx_bearer_t bearer)
 {
     if (NULL == bearer)
@@ -307,3 +748,167 @@ void meshx_net_iface_traverse_continue(meshx_net_iface_t *ptraverse_net_iface)
         break;
     }
 }
+
+static meshx_net_proxy_filter_t *meshx_net_iface_proxy_filter_get(meshx_net_iface_t net_iface)
+{
+    meshx_net_iface_info_t *piface = (meshx_net_iface_info_t *)net_iface;
+    if ((NULL == piface) || (MESHX_NET_IFACE_TYPE_GATT != piface->type))
+    {
+        MESHX_ERROR("invalid proxy filter interface: 0x%08x", net_iface);
+        return NULL;
+    }
+
+    return &piface->proxy_filter;
+}
+
+int32_t meshx_net_iface_proxy_filter_type_set(meshx_net_iface_t net_iface, uint8_t filter_type)
+{
+    meshx_net_proxy_filter_t *pfilter = meshx_net_iface_proxy_filter_get(net_iface);
+    if (NULL == pfilter)
+    {
+        return -MESHX_ERR_INVAL_NET_IFACE;
+    }
+
+    if ((MESHX_NET_PROXY_FILTER_TYPE_ACCEPT != filter_type) &&
+        (MESHX_NET_PROXY_FILTER_TYPE_REJECT != filter_type))
+    {
+        MESHX_ERROR("invalid proxy filter type: %d", filter_type);
+        return -MESHX_ERR_INVAL;
+    }
+
+    /* list is cleared when filter type is set */
+    pfilter->type = filter_type;
+    pfilter->num = 0;
+    if (NULL != pfilter->ptable)
+    {
+        memset(pfilter->ptable, 0, (pfilter->table_mask + 1) * sizeof(uint16_t));
+    }
+    MESHX_INFO("set proxy filter type of interface(0x%08x): %d", net_iface, filter_type);
+
+    return MESHX_SUCCESS;
+}
+
+uint8_t meshx_net_iface_proxy_filter_type_get(meshx_net_iface_t net_iface)
+{
+    meshx_net_proxy_filter_t *pfilter = meshx_net_iface_proxy_filter_get(net_iface);
+    if (NULL == pfilter)
+    {
+        return MESHX_NET_PROXY_FILTER_TYPE_ACCEPT;
+    }
+
+    return pfilter->type;
+}
+
+int32_t meshx_net_iface_proxy_filter_add(meshx_net_iface_t net_iface, uint16_t addr)
+{
+    meshx_net_proxy_filter_t *pfilter = meshx_net_iface_proxy_filter_get(net_iface);
+    if (NULL == pfilter)
+    {
+        return -MESHX_ERR_INVAL_NET_IFACE;
+    }
+
+    if (MESHX_ADDRESS_IS_UNASSIGNED(addr))
+    {
+        MESHX_ERROR("invalid proxy filter address: 0x%04x", addr);
+        return -MESHX_ERR_INVAL;
+    }
+
+    if (0 == pfilter->table_mask)
+    {
+        return -MESHX_ERR_RESOURCE;
+    }
+
+    uint32_t slot = meshx_net_proxy_filter_find(pfilter, addr);
+    if (addr == pfilter->ptable[slot])
+    {
+        return MESHX_SUCCESS;
+    }
+
+    if (pfilter->num >= meshx_node_params.config.proxy_filter_size)
+    {
+        MESHX_WARN("proxy filter is full, ignore address 0x%04x", addr);
+        return -MESHX_ERR_RESOURCE;
+    }
+
+    pfilter->ptable[slot] = addr;
+    pfilter->num ++;
+    MESHX_DEBUG("add address 0x%04x to proxy filter", addr);
+
+    return MESHX_SUCCESS;
+}
+
+int32_t meshx_net_iface_proxy_filter_remove(meshx_net_iface_t net_iface, uint16_t addr)
+{
+    meshx_net_proxy_filter_t *pfilter = meshx_net_iface_proxy_filter_get(net_iface);
+    if (NULL == pfilter)
+    {
+        return -MESHX_ERR_INVAL_NET_IFACE;
+    }
+
+    if ((0 == pfilter->num) || MESHX_ADDRESS_IS_UNASSIGNED(addr))
+    {
+        return -MESHX_ERR_NOT_FOUND;
+    }
+
+    uint32_t slot = meshx_net_proxy_filter_find(pfilter, addr);
+    if (addr != pfilter->ptable[slot])
+    {
+        return -MESHX_ERR_NOT_FOUND;
+    }
+
+    meshx_hash_table_remove(pfilter->ptable, pfilter->table_mask, slot,
+                            meshx_net_proxy_filter_home, pfilter);
+    pfilter->num --;
+    MESHX_DEBUG("remove address 0x%04x from proxy filter", addr);
+
+    return MESHX_SUCCESS;
+}
+
+uint16_t meshx_net_iface_proxy_filter_size(meshx_net_iface_t net_iface)
+{
+    meshx_net_proxy_filter_t *pfilter = meshx_net_iface_proxy_filter_get(net_iface);
+    if (NULL == pfilter)
+    {
+        return 0;
+    }
+
+    return pfilter->num;
+}
+
+void meshx_net_iface_proxy_filter_src(meshx_net_iface_t net_iface, uint16_t src)
+{
+    meshx_net_iface_info_t *piface = (meshx_net_iface_info_t *)net_iface;
+    if ((MESHX_NET_IFACE_TYPE_GATT != piface->type) || !MESHX_ADDRESS_IS_UNICAST(src))
+    {
+        return ;
+    }
+
+    /* messages sent by proxy client shall be sent back to it */
+    if (MESHX_NET_PROXY_FILTER_TYPE_ACCEPT == piface->proxy_filter.type)
+    {
+        meshx_net_iface_proxy_filter_add(net_iface, src);
+    }
+    else
+    {
+        meshx_net_iface_proxy_filter_remove(net_iface, src);
+    }
+}
+
+bool meshx_net_iface_is_proxy_client(uint16_t addr)
+{
+    meshx_list_t *pnode = NULL;
+    meshx_net_iface_info_t *piface;
+    meshx_list_foreach(pnode, &meshx_net_iface_list)
+    {
+        piface = MESHX_CONTAINER_OF(pnode, meshx_net_iface_info_t, node);
+        if ((MESHX_NET_IFACE_TYPE_GATT == piface->type) &&
+            (MESHX_NET_PROXY_FILTER_TYPE_ACCEPT == piface->proxy_filter.type) &&
+            (0 != piface->proxy_filter.num) &&
+            (addr == piface->proxy_filter.ptable[meshx_net_proxy_filter_find(&piface->proxy_filter, addr)]))
+        {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
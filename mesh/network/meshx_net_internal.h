@@ -9,12 +9,64 @@
 #define _MESHX_NET_INTERNAL_H_
 
 #include "meshx_common.h"
+#include "meshx_config.h"
 #include "meshx_net.h"
 #include "meshx_bearer.h"
 #include "meshx_list.h"
+#include "meshx_async_internal.h"
 
 MESHX_BEGIN_DECLS
 
+#define MESHX_NET_PDU_MAX_LEN               29
+
+/**
+ * addresses are stored in open addressing hash table with linear probing,
+ * 0 is empty slot as unassigned address can't be added
+ */
+typedef struct
+{
+    uint8_t type;
+    uint16_t num;
+    uint16_t *ptable;
+    uint16_t table_mask;
+} meshx_net_proxy_filter_t;
+
+/* payload recently received by advertising interface */
+typedef struct
+{
+    uint32_t hash;
+    uint32_t time;
+    uint8_t len; /* 0 for unused entry */
+} meshx_net_adv_dedup_entry_t;
+
+/**
+ * ring of recently received payloads, repeated advertisement is dropped before any aes
+ * work, entries expire after configured window
+ */
+typedef struct
+{
+    meshx_net_adv_dedup_entry_t *pentries;
+    uint8_t next;
+} meshx_net_adv_dedup_t;
+
+/* network pdu waiting for bearer */
+typedef struct
+{
+    uint8_t data[MESHX_NET_PDU_MAX_LEN];
+    uint8_t len;
+    meshx_list_t node;
+} meshx_net_tx_entry_t;
+
+typedef struct
+{
+    meshx_net_tx_entry_t *pentries;
+    meshx_list_t idle;
+    meshx_list_t pending;
+    uint8_t depth;
+    bool blocked; /* depth has reached high watermark and not fallen to low watermark */
+    bool ready_posted;
+    bool flushing; /* bearer may notify ready synchronously while queue is being flushed */
+} meshx_net_tx_queue_t;
 
 typedef struct
 {
@@ -23,6 +75,11 @@ typedef struct
     meshx_net_iface_ifilter_t ifilter;
     meshx_net_iface_ofilter_t ofilter;
     meshx_net_iface_filter_info_t filter_info;
+    /* incremented on every pdu, kept away from fields that are only read */
+    meshx_net_iface_stats_t stats __ALIGNED(MESHX_CACHE_LINE_SIZE);
+    meshx_net_proxy_filter_t proxy_filter;
+    meshx_net_adv_dedup_t adv_dedup;
+    meshx_net_tx_queue_t tx_queue;
     meshx_list_t node;
 } meshx_net_iface_info_t;
 
@@ -33,7 +90,33 @@ MESHX_EXTERN bool meshx_net_iface_ifilter(meshx_net_iface_t net_iface,
                                           const meshx_net_iface_ifilter_data_t *pdata);
 MESHX_EXTERN bool meshx_net_iface_ofilter(meshx_net_iface_t net_iface,
                                           const meshx_net_iface_ofilter_data_t *pdata);
-meshx_bearer_t meshx_net_iface_get_bearer(meshx_net_iface_t net_iface);
+#define MESHX_NET_IFACE_STATS_INC(net_iface, field)   (((meshx_net_iface_info_t *)(net_iface))->stats.field ++)
+/**
+ * send network pdu to bearer of interface, pdu is queued if bearer is busy
+ * @return MESHX_SUCCESS: pdu is sent or queued
+ *         -MESHX_ERR_AGAIN: pdu is queued, but interface would block until queue drains
+ *         -MESHX_ERR_BUSY: pdu is dropped for tx queue is full
+ */
+MESHX_EXTERN int32_t meshx_net_iface_tx(meshx_net_iface_t net_iface, const uint8_t *pdata,
+                                        uint8_t len);
+/* bearer of interface can accept more pdus, queued pdus are sent in stack context later */
+MESHX_EXTERN void meshx_net_iface_tx_ready(meshx_net_iface_t net_iface);
+MESHX_EXTERN void meshx_net_iface_async_handle_tx_ready(meshx_async_msg_t msg);
+/* update proxy filter by source of pdu received from proxy client */
+MESHX_EXTERN void meshx_net_iface_proxy_filter_src(meshx_net_iface_t net_iface, uint16_t src);
+/* address is in accept list of proxy client that connects to this node */
+MESHX_EXTERN bool meshx_net_iface_is_proxy_client(uint16_t addr);
+MESHX_EXTERN void meshx_net_async_handle_relay_timeout(meshx_async_msg_t msg);
+/**
+ * proxy configuration message is network pdu encrypted with proxy nonce, which is only
+ * exchanged between proxy client and proxy server over gatt interface
+ */
+MESHX_EXTERN int32_t meshx_net_proxy_cfg_receive(meshx_net_iface_t net_iface, const uint8_t *pdata,
+                                                 uint8_t len, uint8_t *ptrans_pdu,
+                                                 uint8_t *ptrans_pdu_len,
+                                                 meshx_msg_ctx_t *pmsg_rx_ctx);
+MESHX_EXTERN int32_t meshx_net_proxy_cfg_send(const uint8_t *ptrans_pdu, uint8_t trans_pdu_len,
+                                              const meshx_msg_ctx_t *pmsg_tx_ctx);
 
 MESHX_END_DECLS
 
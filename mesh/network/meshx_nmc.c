@@ -12,10 +12,17 @@
 #include "meshx_errno.h"
 #include "meshx_mem.h"
 #include "meshx_node_internal.h"
+#include "meshx_hash_internal.h"
 
+/**
+ * cached messages are stored in ring array and evicted in fifo order, an open addressing
+ * hash table with linear probing indexes the ring, slot value is ring index + 1, 0 is empty
+ */
 static meshx_nmc_t *nmc_array;
+static uint16_t *nmc_table;
+static uint32_t nmc_table_mask;
 static uint32_t nmc_index;
-static bool nmc_circle;
+static uint32_t nmc_count;
 static uint32_t nmc_size;
 
 int32_t meshx_nmc_init(void)
@@ -26,18 +33,33 @@ int32_t meshx_nmc_init(void)
         return -MESHX_ERR_ALREADY;
     }
 
-    nmc_array = meshx_malloc(meshx_node_params.config.nmc_size * sizeof(meshx_nmc_t));
-    memset(nmc_array, 0, sizeof(meshx_nmc_t) * meshx_node_params.config.nmc_size);
-    if (NULL == nmc_array)
+    nmc_size = meshx_node_params.config.nmc_size;
+    if (0 == nmc_size)
+    {
+        MESHX_ERROR("initialize nmc failed: invalid size");
+        return -MESHX_ERR_INVAL;
+    }
+
+    uint32_t table_size = meshx_hash_table_size(nmc_size);
+
+    nmc_array = meshx_malloc(nmc_size * sizeof(meshx_nmc_t));
+    nmc_table = meshx_malloc(table_size * sizeof(uint16_t));
+    if ((NULL == nmc_array) || (NULL == nmc_table))
     {
         MESHX_ERROR("initialize nmc failed: out of memory");
+        meshx_free(nmc_array);
+        meshx_free(nmc_table);
+        nmc_array = NULL;
+        nmc_table = NULL;
         return -MESHX_ERR_MEM;
     }
+    memset(nmc_array, 0, sizeof(meshx_nmc_t) * nmc_size);
+    memset(nmc_table, 0, sizeof(uint16_t) * table_size);
 
+    nmc_table_mask = table_size - 1;
     nmc_index = 0;
-    nmc_circle = false;
-    nmc_size = meshx_node_params.config.nmc_size;
-    MESHX_INFO("initialize nmc module success: size %d", meshx_node_params.config.nmc_size);
+    nmc_count = 0;
+    MESHX_INFO("initialize nmc module success: size %d", nmc_size);
     return MESHX_SUCCESS;
 }
 
@@ -49,30 +71,96 @@ void meshx_nmc_deinit(void)
         nmc_array = NULL;
     }
 
+    if (NULL != nmc_table)
+    {
+        meshx_free(nmc_table);
+        nmc_table = NULL;
+    }
+
+    nmc_table_mask = 0;
     nmc_index = 0;
-    nmc_circle = false;
+    nmc_count = 0;
     nmc_size = 0;
     MESHX_INFO("deinitialize nmc module");
 }
 
-int32_t meshx_nmc_add(meshx_nmc_t nmc)
+static uint32_t meshx_nmc_hash(const meshx_nmc_t *pnmc)
 {
-    if (NULL == nmc_array)
+    uint32_t key = pnmc->seq ^ (pnmc->src * 0x85ebca6b) ^ (pnmc->iv_index * 0xc2b2ae35);
+
+    return meshx_hash_u32(key) & nmc_table_mask;
+}
+
+static bool meshx_nmc_equal(const meshx_nmc_t *pnmc1, const meshx_nmc_t *pnmc2)
+{
+    return (pnmc1->src == pnmc2->src) && (pnmc1->seq == pnmc2->seq) &&
+           (pnmc1->iv_index == pnmc2->iv_index);
+}
+
+/**
+ * @return slot of cached message or empty slot that message can be inserted
+ */
+static uint32_t meshx_nmc_find(const meshx_nmc_t *pnmc)
+{
+    uint32_t slot = meshx_nmc_hash(pnmc);
+    while (0 != nmc_table[slot])
     {
-        MESHX_ERROR("initialize nmc module first!");
-        return -MESHX_ERR_INVAL;
+        if (meshx_nmc_equal(&nmc_array[nmc_table[slot] - 1], pnmc))
+        {
+            break;
+        }
+        slot = (slot + 1) & nmc_table_mask;
     }
 
+    return slot;
+}
+
+static uint32_t meshx_nmc_home(uint16_t value, const void *pargs)
+{
+    return meshx_nmc_hash(&nmc_array[value - 1]);
+}
+
+static void meshx_nmc_table_remove(uint32_t slot)
+{
+    meshx_hash_table_remove(nmc_table, nmc_table_mask, slot, meshx_nmc_home, NULL);
+}
+
+static void meshx_nmc_insert(const meshx_nmc_t *pnmc)
+{
     if (nmc_index == nmc_size)
     {
         nmc_index = 0;
-        nmc_circle = TRUE;
     }
 
-    nmc_array[nmc_index] = nmc;
-    MESHX_DEBUG("add nmc: src 0x%04x, seq 0x%06x", nmc.src, nmc.seq);
+    if (nmc_count == nmc_size)
+    {
+        /* evict the oldest message */
+        meshx_nmc_table_remove(meshx_nmc_find(&nmc_array[nmc_index]));
+    }
+    else
+    {
+        nmc_count ++;
+    }
+
+    nmc_array[nmc_index] = *pnmc;
+    nmc_table[meshx_nmc_find(pnmc)] = nmc_index + 1;
+    MESHX_DEBUG("add nmc: src 0x%04x, seq 0x%06x", pnmc->src, pnmc->seq);
 
     nmc_index ++;
+}
+
+int32_t meshx_nmc_add(meshx_nmc_t nmc)
+{
+    if (NULL == nmc_array)
+    {
+        MESHX_ERROR("initialize nmc module first!");
+        return -MESHX_ERR_INVAL;
+    }
+
+    if (0 == nmc_table[meshx_nmc_find(&nmc)])
+    {
+        meshx_nmc_insert(&nmc);
+    }
 
     return MESHX_SUCCESS;
 }
@@ -82,9 +170,10 @@ void meshx_nmc_clear(void)
     if (NULL != nmc_array)
     {
         memset(nmc_array, 0, sizeof(meshx_nmc_t) * nmc_size);
+        memset(nmc_table, 0, sizeof(uint16_t) * (nmc_table_mask + 1));
     }
     nmc_index = 0;
-    nmc_circle = FALSE;
+    nmc_count = 0;
     MESHX_INFO("clear nmc");
 }
 
@@ -96,25 +185,48 @@ bool meshx_nmc_check(meshx_nmc_t nmc)
         return FALSE;
     }
 
-    uint32_t check_length = nmc_index;
-    if (nmc_circle)
+    if (0 != nmc_table[meshx_nmc_find(&nmc)])
+    {
+        MESHX_WARN("nmc check failed: src 0x%04x, seq 0x%06x", nmc.src, nmc.seq);
+        return FALSE;
+    }
+
+    MESHX_DEBUG("nmc check passed");
+
+    return TRUE;
+}
+
+bool meshx_nmc_check_add(meshx_nmc_t nmc)
+{
+    if (NULL == nmc_array)
+    {
+        MESHX_ERROR("initialize nmc module first!");
+        return FALSE;
+    }
+
+    uint32_t slot = meshx_nmc_find(&nmc);
+    if (0 != nmc_table[slot])
     {
-        check_length = nmc_size;
+        MESHX_WARN("nmc check failed: src 0x%04x, seq 0x%06x", nmc.src, nmc.seq);
+        return FALSE;
     }
 
-    bool ret = TRUE;
-    for (uint32_t i = 0; i < check_length; ++i)
+    if (nmc_count < nmc_size)
     {
-        if (0 == memcmp(&nmc_array[i], &nmc, sizeof(meshx_nmc_t)))
+        /* no eviction, empty slot is still valid */
+        if (nmc_index == nmc_size)
         {
-            MESHX_WARN("nmc check failed: %d, src 0x%04x, seq 0x%06x-0x%06x", nmc.src, nmc.seq,
-                       nmc_array[i].seq);
-            ret = FALSE;
+            nmc_index = 0;
         }
-        break;
+        nmc_array[nmc_index] = nmc;
+        nmc_table[slot] = nmc_index + 1;
+        nmc_index ++;
+        nmc_count ++;
+    }
+    else
+    {
+        meshx_nmc_insert(&nmc);
     }
 
-    MESHX_DEBUG("nmc check passed");
-
-    return ret;
-}
\ No newline at end of file
+    return TRUE;
+}
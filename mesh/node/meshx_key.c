@@ -16,15 +16,34 @@
 #include "meshx_node_internal.h"
 
 
+#define MESHX_NET_KEY_NID_NUM               128
+
+typedef struct
+{
+    const meshx_net_key_value_t *pkey_value;
+    meshx_list_t node;
+} meshx_net_key_nid_node_t;
+
 typedef struct
 {
     meshx_net_key_t net_key; /* index 0: new key, index 1: old key*/
+    meshx_net_key_nid_node_t nid_node[2]; /* nid table node of each key value */
     meshx_list_t node;
 } meshx_net_key_info_t;
 
+#define MESHX_APP_KEY_AID_NUM               64
+
+typedef struct
+{
+    const meshx_app_key_value_t *pkey_value;
+    const meshx_net_key_t *pnet_key_bind;
+    meshx_list_t node;
+} meshx_app_key_aid_node_t;
+
 typedef struct
 {
     meshx_app_key_t app_key; /* index 0: new key, index 1: old key */
+    meshx_app_key_aid_node_t aid_node[2]; /* aid table node of each key value */
     meshx_list_t node;
 } meshx_app_key_info_t;
 
@@ -38,6 +57,10 @@ typedef struct
 static meshx_list_t meshx_net_keys;
 static meshx_list_t meshx_app_keys;
 static meshx_list_t meshx_dev_keys;
+/* nid to key values, key value that decrypted pdu successfully most recently is the first */
+static meshx_list_t meshx_net_key_nids[MESHX_NET_KEY_NID_NUM];
+/* aid to app key values */
+static meshx_list_t meshx_app_key_aids[MESHX_APP_KEY_AID_NUM];
 
 
 meshx_net_key_info_t *meshx_find_net_key(uint16_t net_key_index)
@@ -59,9 +82,105 @@ meshx_net_key_info_t *meshx_find_net_key(uint16_t net_key_index)
 int32_t meshx_app_key_init(void)
 {
     meshx_list_init_head(&meshx_app_keys);
+    for (uint8_t i = 0; i < MESHX_APP_KEY_AID_NUM; ++i)
+    {
+        meshx_list_init_head(&meshx_app_key_aids[i]);
+    }
     return MESHX_SUCCESS;
 }
 
+static void meshx_app_key_aid_link(meshx_app_key_info_t *papp_key, uint8_t index)
+{
+    meshx_app_key_aid_node_t *paid_node = &papp_key->aid_node[index];
+    paid_node->pkey_value = &papp_key->app_key.key_value[index];
+    paid_node->pnet_key_bind = papp_key->app_key.pnet_key_bind;
+    meshx_list_append(&meshx_app_key_aids[paid_node->pkey_value->aid & 0x3f], &paid_node->node);
+}
+
+static void meshx_app_key_aid_unlink(meshx_app_key_info_t *papp_key, uint8_t index)
+{
+    meshx_app_key_aid_node_t *paid_node = &papp_key->aid_node[index];
+    if (NULL != paid_node->node.pnext)
+    {
+        meshx_list_remove(&paid_node->node);
+    }
+    paid_node->pkey_value = NULL;
+}
+
+static bool meshx_app_key_aid_is_bound(const meshx_app_key_aid_node_t *paid_node,
+                                       const meshx_net_key_value_t *pnet_key)
+{
+    return (pnet_key == &paid_node->pnet_key_bind->key_value[0]) ||
+           (pnet_key == &paid_node->pnet_key_bind->key_value[1]);
+}
+
+/* find the first node of the pass after pnode, pass 0 is bound keys, pass 1 is other keys */
+static const meshx_app_key_aid_node_t *meshx_app_key_aid_next(const meshx_list_t *phead,
+                                                              const meshx_list_t *pnode,
+                                                              const meshx_net_key_value_t *pnet_key,
+                                                              bool bound)
+{
+    const meshx_app_key_aid_node_t *paid_node;
+    for (pnode = pnode->pnext; pnode != phead; pnode = pnode->pnext)
+    {
+        paid_node = MESHX_CONTAINER_OF(pnode, meshx_app_key_aid_node_t, node);
+        if (bound == meshx_app_key_aid_is_bound(paid_node, pnet_key))
+        {
+            return paid_node;
+        }
+    }
+
+    return NULL;
+}
+
+void meshx_app_key_aid_traverse_start(uint8_t aid, const meshx_net_key_value_t *pnet_key,
+                                      const meshx_app_key_value_t **ptraverse_key)
+{
+    const meshx_list_t *phead = &meshx_app_key_aids[aid & 0x3f];
+    const meshx_app_key_aid_node_t *paid_node = meshx_app_key_aid_next(phead, phead, pnet_key, TRUE);
+    if (NULL == paid_node)
+    {
+        paid_node = meshx_app_key_aid_next(phead, phead, pnet_key, FALSE);
+    }
+    *ptraverse_key = (NULL == paid_node) ? NULL : paid_node->pkey_value;
+}
+
+void meshx_app_key_aid_traverse_continue(uint8_t aid, const meshx_net_key_value_t *pnet_key,
+                                         const meshx_app_key_value_t **ptraverse_key)
+{
+    const meshx_list_t *phead = &meshx_app_key_aids[aid & 0x3f];
+    const meshx_list_t *pnode;
+    const meshx_app_key_aid_node_t *paid_node = NULL;
+    meshx_list_foreach(pnode, phead)
+    {
+        paid_node = MESHX_CONTAINER_OF(pnode, meshx_app_key_aid_node_t, node);
+        if (paid_node->pkey_value == *ptraverse_key)
+        {
+            break;
+        }
+    }
+    *ptraverse_key = NULL;
+    if (pnode == phead)
+    {
+        return ;
+    }
+
+    if (meshx_app_key_aid_is_bound(paid_node, pnet_key))
+    {
+        paid_node = meshx_app_key_aid_next(phead, pnode, pnet_key, TRUE);
+        if (NULL == paid_node)
+        {
+            /* bound keys are finished, start other keys */
+            paid_node = meshx_app_key_aid_next(phead, phead, pnet_key, FALSE);
+        }
+    }
+    else
+    {
+        paid_node = meshx_app_key_aid_next(phead, pnode, pnet_key, FALSE);
+    }
+    *ptraverse_key = (NULL == paid_node) ? NULL : paid_node->pkey_value;
+}
+
 const meshx_app_key_t *meshx_app_key_get(uint16_t app_key_index)
 {
     meshx_list_t *pnode;
@@ -122,6 +241,7 @@ static void meshx_app_key_derive(meshx_app_key_value_t *papp_key)
 {
     meshx_k4(papp_key->app_key, &papp_key->aid);
     MESHX_INFO("aid: 0x%x", papp_key->aid);
+    meshx_aes128_ctx_init(&papp_key->app_key_ctx, papp_key->app_key);
 }
 
 int32_t meshx_app_key_add(uint16_t net_key_index, uint16_t app_key_index,
@@ -166,6 +286,10 @@ int32_t meshx_app_key_add(uint16_t net_key_index, uint16_t app_key_index,
     MESHX_INFO("application key add: index %d-%d", app_key_index, net_key_index);
     MESHX_DUMP_INFO(&papp_key->app_key.key_value[0], sizeof(meshx_key_t));
     meshx_app_key_derive(&papp_key->app_key.key_value[0]);
+    meshx_list_init_node(&papp_key->aid_node[0].node);
+    meshx_list_init_node(&papp_key->aid_node[1].node);
+    papp_key->aid_node[1].pkey_value = NULL;
+    meshx_app_key_aid_link(papp_key, 0);
     meshx_list_append(&meshx_app_keys, &papp_key->node);
 
     return MESHX_SUCCESS;
@@ -201,7 +325,8 @@ int32_t meshx_app_key_update(uint16_t net_key_index, uint16_t app_key_index,
 
                 papp_key->app_key.key_state = MESHX_KEY_STATE_PHASE1;
                 memcpy(&papp_key->app_key.key_value[1], app_key, sizeof(meshx_key_t));
-                meshx_app_key_derive(&papp_key->app_key.key_value[0]);
+                meshx_app_key_derive(&papp_key->app_key.key_value[1]);
+                meshx_app_key_aid_link(papp_key, 1);
                 MESHX_INFO("application key update: index 0x%04x, value ", app_key_index);
                 MESHX_DUMP_INFO(app_key, sizeof(meshx_key_t));
                 ret = MESHX_SUCCESS;
@@ -235,6 +360,14 @@ int32_t meshx_app_key_state_transit(uint16_t net_key_index, meshx_key_state_t ke
             {
                 MESHX_INFO("app key state transit from %d to %d", papp_key->app_key.key_state, key_state);
                 papp_key->app_key.key_state = key_state;
+                if (MESHX_KEY_STATE_NORMAL == key_state)
+                {
+                    /* revoke old keys */
+                    meshx_app_key_aid_unlink(papp_key, 0);
+                    meshx_app_key_aid_unlink(papp_key, 1);
+                    papp_key->app_key.key_value[0] = papp_key->app_key.key_value[1];
+                    meshx_app_key_aid_link(papp_key, 0);
+                }
                 ret = MESHX_SUCCESS;
             }
             else
@@ -261,9 +394,82 @@ void meshx_app_key_clear(void)
 int32_t meshx_net_key_init(void)
 {
     meshx_list_init_head(&meshx_net_keys);
+    for (uint8_t i = 0; i < MESHX_NET_KEY_NID_NUM; ++i)
+    {
+        meshx_list_init_head(&meshx_net_key_nids[i]);
+    }
     return MESHX_SUCCESS;
 }
 
+static void meshx_net_key_nid_link(meshx_net_key_info_t *pnet_key, uint8_t index)
+{
+    meshx_net_key_nid_node_t *pnid_node = &pnet_key->nid_node[index];
+    pnid_node->pkey_value = &pnet_key->net_key.key_value[index];
+    /* new key has not decrypted any pdu yet */
+    meshx_list_append(&meshx_net_key_nids[pnid_node->pkey_value->nid & 0x7f], &pnid_node->node);
+}
+
+static void meshx_net_key_nid_unlink(meshx_net_key_info_t *pnet_key, uint8_t index)
+{
+    meshx_net_key_nid_node_t *pnid_node = &pnet_key->nid_node[index];
+    if (NULL != pnid_node->node.pnext)
+    {
+        meshx_list_remove(&pnid_node->node);
+    }
+    pnid_node->pkey_value = NULL;
+}
+
+static meshx_net_key_nid_node_t *meshx_net_key_nid_find(const meshx_net_key_value_t *pkey_value)
+{
+    meshx_list_t *pnode;
+    meshx_net_key_nid_node_t *pnid_node;
+    meshx_list_foreach(pnode, &meshx_net_key_nids[pkey_value->nid & 0x7f])
+    {
+        pnid_node = MESHX_CONTAINER_OF(pnode, meshx_net_key_nid_node_t, node);
+        if (pnid_node->pkey_value == pkey_value)
+        {
+            return pnid_node;
+        }
+    }
+
+    return NULL;
+}
+
+void meshx_net_key_nid_traverse_start(uint8_t nid, const meshx_net_key_value_t **ptraverse_key)
+{
+    *ptraverse_key = NULL;
+    meshx_list_t *pnode = meshx_list_peek(&meshx_net_key_nids[nid & 0x7f]);
+    if (NULL != pnode)
+    {
+        meshx_net_key_nid_node_t *pnid_node = MESHX_CONTAINER_OF(pnode, meshx_net_key_nid_node_t, node);
+        *ptraverse_key = pnid_node->pkey_value;
+    }
+}
+
+void meshx_net_key_nid_traverse_continue(const meshx_net_key_value_t **ptraverse_key)
+{
+    meshx_net_key_nid_node_t *pnid_node = meshx_net_key_nid_find(*ptraverse_key);
+    meshx_list_t *phead = &meshx_net_key_nids[(*ptraverse_key)->nid & 0x7f];
+    *ptraverse_key = NULL;
+    if ((NULL != pnid_node) && (pnid_node->node.pnext != phead))
+    {
+        pnid_node = MESHX_CONTAINER_OF(pnid_node->node.pnext, meshx_net_key_nid_node_t, node);
+        *ptraverse_key = pnid_node->pkey_value;
+    }
+}
+
+void meshx_net_key_nid_hit(const meshx_net_key_value_t *pkey_value)
+{
+    /* the hit key is the first one in most cases */
+    meshx_net_key_nid_node_t *pnid_node = meshx_net_key_nid_find(pkey_value);
+    meshx_list_t *phead = &meshx_net_key_nids[pkey_value->nid & 0x7f];
+    if ((NULL != pnid_node) && !meshx_list_is_first(phead, &pnid_node->node))
+    {
+        meshx_list_remove(&pnid_node->node);
+        meshx_list_prepend(phead, &pnid_node->node);
+    }
+}
+
 const meshx_net_key_t *meshx_net_key_get(uint16_t net_key_index)
 {
     meshx_list_t *pnode;
@@ -323,19 +529,14 @@ void meshx_net_key_traverse_continue(meshx_net_key_t **ptraverse_key)
 static void meshx_net_key_derive(meshx_net_key_value_t *pnet_key)
 {
     /* identity key */
-    uint8_t salt_M[] = {'n', 'k', 'i', 'k'};
-    uint8_t salt[16];
-    meshx_s1(salt_M, sizeof(salt_M), salt);
     uint8_t P[] = {'i', 'd', '1', '2', '8', 0x01};
-    meshx_k1(pnet_key->net_key, sizeof(pnet_key->net_key), salt, P, sizeof(P),
-             pnet_key->identity_key);
+    meshx_k1_salt(MESHX_SALT_NKIK, pnet_key->net_key, sizeof(pnet_key->net_key), P, sizeof(P),
+                  pnet_key->identity_key);
     MESHX_DEBUG("identity key:");
     MESHX_DUMP_DEBUG(pnet_key->identity_key, sizeof(meshx_key_t));
     /* beacon key */
-    salt_M[2] = 'b';
-    meshx_s1(salt_M, sizeof(salt_M), salt);
-    meshx_k1(pnet_key->net_key, sizeof(pnet_key->net_key), salt, P, sizeof(P),
-             pnet_key->beacon_key);
+    meshx_k1_salt(MESHX_SALT_NKBK, pnet_key->net_key, sizeof(pnet_key->net_key), P, sizeof(P),
+                  pnet_key->beacon_key);
     MESHX_DEBUG("beacon key:");
     MESHX_DUMP_DEBUG(pnet_key->beacon_key, sizeof(meshx_key_t));
     /* nid, encryption key, privacy key */
@@ -351,6 +552,10 @@ static void meshx_net_key_derive(meshx_net_key_value_t *pnet_key)
     meshx_k3(pnet_key->net_key, pnet_key->net_id);
     MESHX_DEBUG("network id:");
     MESHX_DUMP_DEBUG(pnet_key->net_id, sizeof(meshx_net_id_t));
+    /* expand keys used by every pdu */
+    meshx_aes_cmac_ctx_init(&pnet_key->beacon_key_ctx, pnet_key->beacon_key);
+    meshx_aes128_ctx_init(&pnet_key->encryption_key_ctx, pnet_key->encryption_key);
+    meshx_aes128_ctx_init(&pnet_key->privacy_key_ctx, pnet_key->privacy_key);
 }
 
 int32_t meshx_net_key_add(uint16_t net_key_index, meshx_key_t net_key)
@@ -386,6 +591,10 @@ int32_t meshx_net_key_add(uint16_t net_key_index, meshx_key_t net_key)
     MESHX_INFO("network key add: index %d", net_key_index);
     MESHX_DUMP_INFO(&pnet_key->net_key.key_value[0], sizeof(meshx_key_t));
     meshx_net_key_derive(&pnet_key->net_key.key_value[0]);
+    meshx_list_init_node(&pnet_key->nid_node[0].node);
+    meshx_list_init_node(&pnet_key->nid_node[1].node);
+    pnet_key->nid_node[1].pkey_value = NULL;
+    meshx_net_key_nid_link(pnet_key, 0);
     meshx_list_append(&meshx_net_keys, &pnet_key->node);
 
     return MESHX_SUCCESS;
@@ -425,6 +634,7 @@ int32_t meshx_net_key_update(uint16_t net_key_index, meshx_key_t net_key)
             pnet_key->net_key.key_state = MESHX_KEY_STATE_PHASE1;
             memcpy(&pnet_key->net_key.key_value[1], net_key, sizeof(meshx_key_t));
             meshx_net_key_derive(&pnet_key->net_key.key_value[1]);
+            meshx_net_key_nid_link(pnet_key, 1);
             MESHX_INFO("nework key update: index 0x%04x, value ", net_key_index);
             MESHX_DUMP_INFO(net_key, sizeof(meshx_key_t));
             ret = MESHX_SUCCESS;
@@ -445,6 +655,8 @@ int32_t meshx_net_key_delete(uint16_t net_key_index)
         if (pnet_key->net_key.key_index == net_key_index)
         {
             meshx_list_remove(pnode);
+            meshx_net_key_nid_unlink(pnet_key, 0);
+            meshx_net_key_nid_unlink(pnet_key, 1);
             /* TODO: update all bind app keys? */
             meshx_free(pnet_key);
             return MESHX_SUCCESS;
@@ -454,6 +666,48 @@ int32_t meshx_net_key_delete(uint16_t net_key_index)
     return -MESHX_ERR_NOT_FOUND;
 }
 
+/* can transit from phase1->phase2->normal, old key is revoked when transit to normal */
+int32_t meshx_net_key_state_transit(uint16_t net_key_index, meshx_key_state_t key_state)
+{
+    meshx_net_key_info_t *pnet_key = NULL;
+    meshx_list_t *pnode;
+    meshx_list_foreach(pnode, &meshx_net_keys)
+    {
+        meshx_net_key_info_t *pinfo = MESHX_CONTAINER_OF(pnode, meshx_net_key_info_t, node);
+        if (pinfo->net_key.key_index == net_key_index)
+        {
+            pnet_key = pinfo;
+            break;
+        }
+    }
+
+    if (NULL == pnet_key)
+    {
+        return -MESHX_ERR_NOT_FOUND;
+    }
+
+    if ((MESHX_KEY_STATE_NORMAL == pnet_key->net_key.key_state) ||
+        (MESHX_KEY_STATE_PHASE1 == key_state))
+    {
+        MESHX_WARN("can't transit from state(%d) to state(%d)", pnet_key->net_key.key_state,
+                   key_state);
+        return -MESHX_ERR_STATE;
+    }
+
+    MESHX_INFO("net key state transit from %d to %d", pnet_key->net_key.key_state, key_state);
+    pnet_key->net_key.key_state = key_state;
+    if (MESHX_KEY_STATE_NORMAL == key_state)
+    {
+        /* revoke old keys */
+        meshx_net_key_nid_unlink(pnet_key, 0);
+        meshx_net_key_nid_unlink(pnet_key, 1);
+        pnet_key->net_key.key_value[0] = pnet_key->net_key.key_value[1];
+        meshx_net_key_nid_link(pnet_key, 0);
+    }
+
+    return MESHX_SUCCESS;
+}
+
 void meshx_net_key_clear(void)
 {
 }
@@ -523,6 +777,7 @@ int32_t meshx_dev_key_add(uint16_t primary_addr, uint8_t element_num, meshx_key_
     pdev_key->dev_key.primary_addr = primary_addr;
     pdev_key->dev_key.element_num = element_num;
     memcpy(pdev_key->dev_key.dev_key, dev_key, sizeof(meshx_key_t));
+    meshx_aes128_ctx_init(&pdev_key->dev_key.dev_key_ctx, pdev_key->dev_key.dev_key);
     MESHX_INFO("device key add: primary addr 0x%04x, element num %d", pdev_key->dev_key.primary_addr,
                pdev_key->dev_key.element_num);
     MESHX_DUMP_INFO(pdev_key->dev_key.dev_key, sizeof(meshx_key_t));
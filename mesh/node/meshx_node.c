@@ -11,6 +11,8 @@
 #include "meshx_node.h"
 #include "meshx_errno.h"
 #include "meshx_node_internal.h"
+#include "meshx_config.h"
+#include "meshx_sub.h"
 
 
 meshx_node_params_t meshx_node_params;
@@ -21,15 +23,41 @@ static meshx_node_config_t node_default_config =
     .dev_uuid = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
     .adv_bearer_enable = TRUE,
     .gatt_bearer_enable = TRUE,
+    .element_num = 1,
     .net_key_num = 2,
     .app_key_num = 2,
     .dev_key_num = 10,
     .nmc_size = 64,
     .rpl_size = 16,
+    .rpl_full_iv_update = FALSE,
     .gap_task_num = 20,
     .trans_tx_task_num = 3,
     .trans_rx_task_num = 3,
     .trans_tx_retry_times = 2,
+    .crypto_worker_num = 2,
+    .prov_key_pool_size = 4,
+    .relay_queue_size = 8,
+    .relay_delay_max = 50,
+    .loopback_fast_path = TRUE,
+    .pkt_num = 12,
+    .pkt_size = MESHX_PKT_HEADROOM + 384,
+    .sub_group_num = 16,
+    .sub_virtual_num = 4,
+    .proxy_filter_size = 16,
+    .net_tx_queue_size = 8,
+    .net_tx_high_watermark = 6,
+    .net_tx_low_watermark = 2,
+    .adv_rssi_floor = -128,
+    .adv_dedup_size = 16,
+    .adv_dedup_window = 500,
+    .ip_bearer_enable = TRUE,
+    .ip_peer_num = 4,
+    .ip_poll_interval = 10,
+    .df_enable = FALSE,
+    .df_table_size = 16,
+    .df_flood_fallback = TRUE,
+    .df_path_lifetime = 300,
+    .df_discovery_timeout = 2000,
 };
 
 static meshx_node_param_t node_default_param =
@@ -39,8 +67,18 @@ static meshx_node_param_t node_default_param =
     .snb_interval = 100,
     .trans_retrans_count = 2,
     .default_ttl = 5,
+    .relay_enable = TRUE,
+    .relay_retrans_count = 0,
+    .relay_retrans_interval = 20,
 };
 
+/* all element addresses shall be unicast */
+static bool meshx_node_is_valid_address_range(uint16_t node_addr)
+{
+    return (MESHX_ADDRESS_IS_UNICAST(node_addr) &&
+            (node_addr + meshx_node_params.config.element_num - 1 <= 0x7fff));
+}
+
 int32_t meshx_node_config_init(meshx_node_config_t *pconfig)
 {
     if (NULL == pconfig)
@@ -65,6 +103,27 @@ int32_t meshx_node_config_set(const meshx_node_config_t *pconfig)
         return -MESHX_ERR_INVAL;
     }
 
+    if (0 == pconfig->element_num)
+    {
+        MESHX_ERROR("invalid element num: %d", pconfig->element_num);
+        return -MESHX_ERR_INVAL;
+    }
+
+    if ((0 != pconfig->net_tx_queue_size) &&
+        ((pconfig->net_tx_high_watermark > pconfig->net_tx_queue_size) ||
+         (pconfig->net_tx_low_watermark >= pconfig->net_tx_high_watermark)))
+    {
+        MESHX_ERROR("invalid net tx watermark: queue %d, high %d, low %d", pconfig->net_tx_queue_size,
+                    pconfig->net_tx_high_watermark, pconfig->net_tx_low_watermark);
+        return -MESHX_ERR_INVAL;
+    }
+
+    if (pconfig->df_enable && (0 == pconfig->df_table_size))
+    {
+        MESHX_ERROR("invalid directed forwarding table size: %d", pconfig->df_table_size);
+        return -MESHX_ERR_INVAL;
+    }
+
     meshx_node_params.config = *pconfig;
 
     return MESHX_SUCCESS;
@@ -96,6 +155,13 @@ int32_t meshx_node_params_set(const meshx_node_param_t *pparam)
         return -MESHX_ERR_INVAL;
     }
 
+    if (!MESHX_ADDRESS_IS_UNASSIGNED(pparam->node_addr) &&
+        !meshx_node_is_valid_address_range(pparam->node_addr))
+    {
+        MESHX_ERROR("invalid node address: 0x%04x", pparam->node_addr);
+        return -MESHX_ERR_INVAL;
+    }
+
     meshx_node_params.param = *pparam;
 
     return MESHX_SUCCESS;
@@ -114,10 +180,15 @@ int32_t meshx_node_param_set(meshx_node_param_type_t type, const void *pdata)
     case MESHX_NODE_PARAM_TYPE_NODE_ADDR:
         {
             uint16_t addr = *(uint16_t *)pdata;
-            if (MESHX_ADDRESS_IS_UNICAST(addr))
+            if (meshx_node_is_valid_address_range(addr))
             {
                 meshx_node_params.param.node_addr = addr;
             }
+            else
+            {
+                MESHX_ERROR("invalid node address: 0x%04x", addr);
+                ret = -MESHX_ERR_INVAL;
+            }
         }
         break;
     case MESHX_NODE_PARAM_TYPE_UDB_INTERVAL:
@@ -136,6 +207,15 @@ int32_t meshx_node_param_set(meshx_node_param_type_t type, const void *pdata)
     case MESHX_NODE_PARAM_TYPE_DEFAULT_TTL:
         meshx_node_params.param.default_ttl = *(uint8_t *)pdata;
         break;
+    case MESHX_NODE_PARAM_TYPE_RELAY_ENABLE:
+        meshx_node_params.param.relay_enable = *(bool *)pdata;
+        break;
+    case MESHX_NODE_PARAM_TYPE_RELAY_RETRANS_COUNT:
+        meshx_node_params.param.relay_retrans_count = *(uint8_t *)pdata;
+        break;
+    case MESHX_NODE_PARAM_TYPE_RELAY_RETRANS_INTERVAL:
+        meshx_node_params.param.relay_retrans_interval = *(uint16_t *)pdata;
+        break;
     default:
         MESHX_WARN("unknown parameter type: %d", type);
         ret = -MESHX_ERR_INVAL;
@@ -164,6 +244,16 @@ int32_t meshx_node_param_get(meshx_node_param_type_t type, void *pdata)
         break;
     case MESHX_NODE_PARAM_TYPE_DEFAULT_TTL:
         *((uint8_t *)pdata) = meshx_node_params.param.default_ttl;
+        break;
+    case MESHX_NODE_PARAM_TYPE_RELAY_ENABLE:
+        *((bool *)pdata) = meshx_node_params.param.relay_enable;
+        break;
+    case MESHX_NODE_PARAM_TYPE_RELAY_RETRANS_COUNT:
+        *((uint8_t *)pdata) = meshx_node_params.param.relay_retrans_count;
+        break;
+    case MESHX_NODE_PARAM_TYPE_RELAY_RETRANS_INTERVAL:
+        *((uint16_t *)pdata) = meshx_node_params.param.relay_retrans_interval;
+        break;
     default:
         MESHX_WARN("unknown parameter type: %d", type);
         ret = -MESHX_ERR_INVAL;
@@ -175,17 +265,36 @@ int32_t meshx_node_param_get(meshx_node_param_type_t type, void *pdata)
 
 bool meshx_node_is_my_address(uint16_t addr)
 {
-    /* TODO: node address range */
-    if (addr == meshx_node_params.param.node_addr)
+    /* subtraction wraps below node address, so one comparison checks the element range */
+    if (MESHX_ADDRESS_IS_UNASSIGNED(meshx_node_params.param.node_addr))
     {
-        return TRUE;
+        return FALSE;
     }
-    return FALSE;
+    return (MESHX_NODE_ELEMENT_INDEX(addr) < meshx_node_params.config.element_num);
 }
 
 bool meshx_node_is_accept_address(uint16_t addr)
 {
-    /* 0xffff, subscribe address, all realy node.... */
-    return FALSE;
+    if (MESHX_ADDRESS_IS_UNICAST(addr))
+    {
+        return meshx_node_is_my_address(addr);
+    }
+
+    switch (addr)
+    {
+    case MESHX_ADDRESS_ALL_NODES:
+        return TRUE;
+    case MESHX_ADDRESS_ALL_RELAYS:
+        return meshx_node_params.param.relay_enable;
+    case MESHX_ADDRESS_ALL_PRXIES:
+        return meshx_node_params.config.gatt_bearer_enable;
+    case MESHX_ADDRESS_ALL_FRIENDS:
+        /* friend feature is not supported */
+        return FALSE;
+    default:
+        break;
+    }
+
+    return meshx_sub_is_subscribed(addr);
 }
 
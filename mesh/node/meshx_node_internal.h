@@ -21,6 +21,9 @@ typedef struct
 
 MESHX_EXTERN meshx_node_params_t meshx_node_params;
 
+/* element index of my unicast address, out of range value if address is not mine */
+#define MESHX_NODE_ELEMENT_INDEX(addr)    ((uint16_t)((addr) - meshx_node_params.param.node_addr))
+
 MESHX_END_DECLS
 
 #endif /* _MESHX_NODE_INTERNAL_H_ */
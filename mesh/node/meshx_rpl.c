@@ -11,12 +11,31 @@
 #include "meshx_trace.h"
 #include "meshx_errno.h"
 #include "meshx_mem.h"
+#include "meshx_list.h"
 #include "meshx_node_internal.h"
+#include "meshx_iv_index.h"
 #include "meshx_assert.h"
+#include "meshx_hash_internal.h"
 
-static meshx_rpl_t *rpl_array;
+/**
+ * every source element has one entry, entries are indexed by an open addressing hash table
+ * with linear probing, slot value is entry index + 1, 0 is empty. when all entries are used,
+ * the least recently updated entry is evicted
+ */
+typedef struct
+{
+    meshx_rpl_t rpl;
+    meshx_list_t node;
+} meshx_rpl_entry_t;
+
+static meshx_rpl_entry_t *rpl_array;
+static uint16_t *rpl_table;
+static uint32_t rpl_table_mask;
+static meshx_list_t rpl_lru_list; /* least recently updated entry is the first */
 static uint32_t rpl_index;
 static uint32_t rpl_size;
+static uint32_t rpl_evict_count;
+static uint32_t rpl_iv_update_fail_count;
 
 int32_t meshx_rpl_init(void)
 {
@@ -27,16 +46,34 @@ int32_t meshx_rpl_init(void)
         return -MESHX_ERR_ALREADY;
     }
 
-    rpl_array = meshx_malloc(meshx_node_params.config.rpl_size * sizeof(meshx_rpl_t));
-    memset(rpl_array, 0, sizeof(meshx_rpl_t) * meshx_node_params.config.rpl_size);
-    if (NULL == rpl_array)
+    rpl_size = meshx_node_params.config.rpl_size;
+    if (0 == rpl_size)
+    {
+        MESHX_ERROR("initialize rpl failed: invalid size");
+        return -MESHX_ERR_INVAL;
+    }
+
+    uint32_t table_size = meshx_hash_table_size(rpl_size);
+
+    rpl_array = meshx_malloc(rpl_size * sizeof(meshx_rpl_entry_t));
+    rpl_table = meshx_malloc(table_size * sizeof(uint16_t));
+    if ((NULL == rpl_array) || (NULL == rpl_table))
     {
         MESHX_ERROR("initialize rpl failed: out of memory");
+        meshx_free(rpl_array);
+        meshx_free(rpl_table);
+        rpl_array = NULL;
+        rpl_table = NULL;
+        rpl_size = 0;
         return -MESHX_ERR_MEM;
     }
+    memset(rpl_table, 0, sizeof(uint16_t) * table_size);
 
+    rpl_table_mask = table_size - 1;
+    meshx_list_init_head(&rpl_lru_list);
     rpl_index = 0;
-    rpl_size = meshx_node_params.config.rpl_size;
+    rpl_evict_count = 0;
+    rpl_iv_update_fail_count = 0;
 
     return MESHX_SUCCESS;
 }
@@ -50,49 +87,121 @@ void meshx_rpl_deinit(void)
         rpl_array = NULL;
     }
 
+    if (NULL != rpl_table)
+    {
+        meshx_free(rpl_table);
+        rpl_table = NULL;
+    }
+
+    rpl_table_mask = 0;
     rpl_index = 0;
     rpl_size = 0;
 }
 
-int32_t meshx_rpl_update(meshx_rpl_t rpl)
+static uint32_t meshx_rpl_hash(uint16_t src)
 {
-    MESHX_ASSERT(NULL != rpl_array);
+    return meshx_hash_u32(src) & rpl_table_mask;
+}
+
+/**
+ * @return slot of source or empty slot that source can be inserted
+ */
+static uint32_t meshx_rpl_find(uint16_t src)
+{
+    uint32_t slot = meshx_rpl_hash(src);
+    while ((0 != rpl_table[slot]) && (rpl_array[rpl_table[slot] - 1].rpl.src != src))
+    {
+        slot = (slot + 1) & rpl_table_mask;
+    }
+
+    return slot;
+}
+
+static uint32_t meshx_rpl_home(uint16_t value, const void *pargs)
+{
+    return meshx_rpl_hash(rpl_array[value - 1].rpl.src);
+}
+
+static void meshx_rpl_table_remove(uint32_t slot)
+{
+    meshx_hash_table_remove(rpl_table, rpl_table_mask, slot, meshx_rpl_home, NULL);
+}
+
+static bool meshx_rpl_is_replay(const meshx_rpl_t *prpl_cache, const meshx_rpl_t *prpl)
+{
+    return (prpl->iv_index < prpl_cache->iv_index) ||
+           ((prpl->iv_index == prpl_cache->iv_index) && (prpl->seq <= prpl_cache->seq));
+}
 
-    for (uint8_t i = 0; i < rpl_index; ++i)
+static meshx_rpl_entry_t *meshx_rpl_entry_alloc(void)
+{
+    meshx_rpl_entry_t *pentry;
+    if (rpl_index < rpl_size)
     {
-        if (rpl_array[rpl_index].src == rpl.src)
+        pentry = &rpl_array[rpl_index ++];
+        return pentry;
+    }
+
+    /* evict least recently updated source */
+    meshx_list_t *pnode = meshx_list_pop(&rpl_lru_list);
+    pentry = MESHX_CONTAINER_OF(pnode, meshx_rpl_entry_t, node);
+    meshx_rpl_table_remove(meshx_rpl_find(pentry->rpl.src));
+    rpl_evict_count ++;
+    MESHX_WARN("rpl list is full, evict src 0x%04x", pentry->rpl.src);
+
+    if (meshx_node_params.config.rpl_full_iv_update &&
+        (MESHX_IV_UPDATE_STATE_NORMAL == meshx_iv_update_state_get()))
+    {
+        /* replay list is cleared when iv update procedure finished */
+        int32_t ret = meshx_iv_index_update(meshx_iv_index_get() + 1, MESHX_IV_UPDATE_STATE_IN_PROGRESS);
+        if (MESHX_SUCCESS != ret)
         {
-            /* found exists rpl */
-            rpl_array[rpl_index].seq = rpl.seq;
-            rpl_array[rpl_index].iv_index = rpl.iv_index;
-            MESHX_DEBUG("update rpl: src 0x%04x, seq 0x%06x, iv index 0x%08x", rpl_array[rpl_index].src,
-                        rpl_array[rpl_index].seq, rpl_array[rpl_index].iv_index);
-            return MESHX_SUCCESS;
+            rpl_iv_update_fail_count ++;
+            MESHX_ERROR("rpl list is full, but start iv update failed: %d", ret);
         }
     }
 
-    /* not found, try to add */
-    if (rpl_index == rpl_size)
+    return pentry;
+}
+
+static void meshx_rpl_store(uint32_t slot, const meshx_rpl_t *prpl)
+{
+    meshx_rpl_entry_t *pentry;
+    if (0 != rpl_table[slot])
     {
-        MESHX_ERROR("rpl list is full, can't add new rpl!");
-        return -MESHX_ERR_RESOURCE;
+        pentry = &rpl_array[rpl_table[slot] - 1];
+        meshx_list_remove(&pentry->node);
     }
+    else
+    {
+        pentry = meshx_rpl_entry_alloc();
+        /* eviction may move slots */
+        slot = meshx_rpl_find(prpl->src);
+        rpl_table[slot] = pentry - rpl_array + 1;
+    }
+
+    pentry->rpl = *prpl;
+    meshx_list_append(&rpl_lru_list, &pentry->node);
+    MESHX_DEBUG("update rpl: src 0x%04x, seq 0x%06x, iv index 0x%08x", prpl->src, prpl->seq,
+                prpl->iv_index);
+}
 
-    rpl_array[rpl_index] = rpl;
-    MESHX_DEBUG("update rpl: src 0x%04x, seq 0x%06x, iv index 0x%08x", rpl_array[rpl_index].src,
-                rpl_array[rpl_index].seq, rpl_array[rpl_index].iv_index);
+int32_t meshx_rpl_update(meshx_rpl_t rpl)
+{
+    MESHX_ASSERT(NULL != rpl_array);
 
-    rpl_index ++;
+    meshx_rpl_store(meshx_rpl_find(rpl.src), &rpl);
 
     return MESHX_SUCCESS;
 }
 
 void meshx_rpl_clear(void)
 {
-    if (NULL != rpl_array)
+    if (NULL != rpl_table)
     {
-        memset(rpl_array, 0, sizeof(meshx_rpl_t) * rpl_size);
+        memset(rpl_table, 0, sizeof(uint16_t) * (rpl_table_mask + 1));
     }
+    meshx_list_init_head(&rpl_lru_list);
     rpl_index = 0;
     MESHX_INFO("clear rpl list");
 }
@@ -101,23 +210,41 @@ bool meshx_rpl_check(meshx_rpl_t rpl)
 {
     MESHX_ASSERT(NULL != rpl_array);
 
-    bool ret = TRUE;
-    for (uint32_t i = 0; i < rpl_index; ++i)
+    uint32_t slot = meshx_rpl_find(rpl.src);
+    if (0 != rpl_table[slot])
     {
-        if (rpl_array[i].src == rpl.src)
+        const meshx_rpl_t *prpl_cache = &rpl_array[rpl_table[slot] - 1].rpl;
+        if (meshx_rpl_is_replay(prpl_cache, &rpl))
         {
-            if ((rpl.seq <= rpl_array[i].seq) || (rpl.iv_index < rpl_array[i].iv_index))
-            {
-                MESHX_WARN("rpl check failed: src 0x%04x, seq 0x%06x-0x%06x, iv index 0x%08x-0x%08x", rpl.src,
-                           rpl_array[i].seq, rpl.seq, rpl_array[i].iv_index, rpl.iv_index);
-                ret = FALSE;
-            }
-            break;
+            MESHX_WARN("rpl check failed: src 0x%04x, seq 0x%06x-0x%06x, iv index 0x%08x-0x%08x", rpl.src,
+                       prpl_cache->seq, rpl.seq, prpl_cache->iv_index, rpl.iv_index);
+            return FALSE;
         }
     }
 
     MESHX_DEBUG("rpl check passed");
-    return ret;
+    return TRUE;
+}
+
+bool meshx_rpl_check_update(meshx_rpl_t rpl)
+{
+    MESHX_ASSERT(NULL != rpl_array);
+
+    uint32_t slot = meshx_rpl_find(rpl.src);
+    if (0 != rpl_table[slot])
+    {
+        const meshx_rpl_t *prpl_cache = &rpl_array[rpl_table[slot] - 1].rpl;
+        if (meshx_rpl_is_replay(prpl_cache, &rpl))
+        {
+            MESHX_WARN("rpl check failed: src 0x%04x, seq 0x%06x-0x%06x, iv index 0x%08x-0x%08x", rpl.src,
+                       prpl_cache->seq, rpl.seq, prpl_cache->iv_index, rpl.iv_index);
+            return FALSE;
+        }
+    }
+
+    meshx_rpl_store(slot, &rpl);
+
+    return TRUE;
 }
 
 bool meshx_rpl_is_full(void)
@@ -126,3 +253,13 @@ bool meshx_rpl_is_full(void)
 
     return (rpl_index >= rpl_size);
 }
+
+uint32_t meshx_rpl_evict_count_get(void)
+{
+    return rpl_evict_count;
+}
+
+uint32_t meshx_rpl_iv_update_fail_count_get(void)
+{
+    return rpl_iv_update_fail_count;
+}
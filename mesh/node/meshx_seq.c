@@ -48,7 +48,7 @@ void meshx_seq_deinit(void)
     meshx_element_num = 0;
 }
 
-uint32_t meshx_seq_get(uint8_t element_index)
+uint32_t meshx_seq_get(uint16_t element_index)
 {
     MESHX_ASSERT(NULL != seq_array);
 
@@ -63,7 +63,7 @@ uint32_t meshx_seq_get(uint8_t element_index)
     return seq_array[element_index];
 }
 
-uint32_t meshx_seq_set(uint8_t element_index, uint32_t seq)
+uint32_t meshx_seq_set(uint16_t element_index, uint32_t seq)
 {
     MESHX_ASSERT(NULL != seq_array);
 
@@ -85,7 +85,7 @@ uint32_t meshx_seq_set(uint8_t element_index, uint32_t seq)
     return seq;
 }
 
-uint32_t meshx_seq_use(uint8_t element_index)
+uint32_t meshx_seq_use(uint16_t element_index)
 {
     MESHX_ASSERT(NULL != seq_array);
 
@@ -0,0 +1,311 @@
+/**
+ * This file is part of the meshx library.
+ *
+ * Copyright 2019, Huang Yang <elious.huang@gmail.com>. All rights reserved.
+ *
+ * See the COPYING file for the terms of usage and distribution.
+ */
+#include <string.h>
+#define MESHX_TRACE_MODULE "MESHX_SUB"
+#include "meshx_sub.h"
+#include "meshx_trace.h"
+#include "meshx_errno.h"
+#include "meshx_mem.h"
+#include "meshx_node_internal.h"
+#include "meshx_security.h"
+
+/**
+ * membership of virtual and group addresses(0x8000 - 0xffff) is kept in a bitmap, so
+ * received pdu is checked in constant time. subscribed addresses and label uuids are stored
+ * in small tables with reference count, which are only searched when subscription changes
+ */
+#define MESHX_SUB_BITMAP_SIZE                (0x8000 / 8)
+#define MESHX_SUB_BIT_INDEX(addr)            ((addr) & 0x7fff)
+
+typedef struct
+{
+    uint16_t addr;
+    uint16_t ref;
+} meshx_sub_group_t;
+
+typedef struct
+{
+    uint8_t label_uuid[16];
+    uint16_t addr;
+    uint16_t ref;
+} meshx_sub_virtual_t;
+
+static uint8_t *sub_bitmap;
+static meshx_sub_group_t *sub_groups;
+static meshx_sub_virtual_t *sub_virtuals;
+
+static void meshx_sub_bit_set(uint16_t addr)
+{
+    uint16_t index = MESHX_SUB_BIT_INDEX(addr);
+    sub_bitmap[index >> 3] |= (1 << (index & 0x07));
+}
+
+static void meshx_sub_bit_clear(uint16_t addr)
+{
+    uint16_t index = MESHX_SUB_BIT_INDEX(addr);
+    sub_bitmap[index >> 3] &= ~(1 << (index & 0x07));
+}
+
+int32_t meshx_sub_init(void)
+{
+    if (NULL != sub_bitmap)
+    {
+        MESHX_ERROR("subscription already initialized");
+        return -MESHX_ERR_ALREADY;
+    }
+
+    uint16_t group_num = meshx_node_params.config.sub_group_num;
+    uint16_t virtual_num = meshx_node_params.config.sub_virtual_num;
+    MESHX_INFO("initialize subscription module: group %d, virtual %d", group_num, virtual_num);
+    sub_bitmap = meshx_malloc(MESHX_SUB_BITMAP_SIZE);
+    if (NULL == sub_bitmap)
+    {
+        MESHX_ERROR("initialize subscription failed: out of memory");
+        return -MESHX_ERR_MEM;
+    }
+
+    if (0 != group_num)
+    {
+        sub_groups = meshx_malloc(group_num * sizeof(meshx_sub_group_t));
+        if (NULL == sub_groups)
+        {
+            meshx_sub_deinit();
+            MESHX_ERROR("initialize subscription failed: out of memory");
+            return -MESHX_ERR_MEM;
+        }
+    }
+
+    if (0 != virtual_num)
+    {
+        sub_virtuals = meshx_malloc(virtual_num * sizeof(meshx_sub_virtual_t));
+        if (NULL == sub_virtuals)
+        {
+            meshx_sub_deinit();
+            MESHX_ERROR("initialize subscription failed: out of memory");
+            return -MESHX_ERR_MEM;
+        }
+    }
+
+    meshx_sub_clear();
+
+    return MESHX_SUCCESS;
+}
+
+void meshx_sub_deinit(void)
+{
+    if (NULL != sub_bitmap)
+    {
+        meshx_free(sub_bitmap);
+        sub_bitmap = NULL;
+    }
+
+    if (NULL != sub_groups)
+    {
+        meshx_free(sub_groups);
+        sub_groups = NULL;
+    }
+
+    if (NULL != sub_virtuals)
+    {
+        meshx_free(sub_virtuals);
+        sub_virtuals = NULL;
+    }
+}
+
+void meshx_sub_clear(void)
+{
+    if (NULL != sub_bitmap)
+    {
+        memset(sub_bitmap, 0, MESHX_SUB_BITMAP_SIZE);
+    }
+
+    if (NULL != sub_groups)
+    {
+        memset(sub_groups, 0, meshx_node_params.config.sub_group_num * sizeof(meshx_sub_group_t));
+    }
+
+    if (NULL != sub_virtuals)
+    {
+        memset(sub_virtuals, 0, meshx_node_params.config.sub_virtual_num * sizeof(meshx_sub_virtual_t));
+    }
+    MESHX_INFO("clear subscription");
+}
+
+int32_t meshx_sub_group_add(uint16_t group_addr)
+{
+    if (!MESHX_ADDRESS_IS_GROUP(group_addr) || MESHX_ADDRESS_IS_RFU(group_addr) ||
+        (group_addr >= MESHX_ADDRESS_ALL_PRXIES))
+    {
+        MESHX_ERROR("invalid group address: 0x%04x", group_addr);
+        return -MESHX_ERR_INVAL;
+    }
+
+    meshx_sub_group_t *pidle = NULL;
+    for (uint16_t i = 0; i < meshx_node_params.config.sub_group_num; ++i)
+    {
+        if (0 == sub_groups[i].ref)
+        {
+            if (NULL == pidle)
+            {
+                pidle = &sub_groups[i];
+            }
+        }
+        else if (group_addr == sub_groups[i].addr)
+        {
+            sub_groups[i].ref ++;
+            return MESHX_SUCCESS;
+        }
+    }
+
+    if (NULL == pidle)
+    {
+        MESHX_ERROR("add group subscription failed: table is full");
+        return -MESHX_ERR_RESOURCE;
+    }
+
+    pidle->addr = group_addr;
+    pidle->ref = 1;
+    meshx_sub_bit_set(group_addr);
+    MESHX_INFO("subscribe group address: 0x%04x", group_addr);
+
+    return MESHX_SUCCESS;
+}
+
+int32_t meshx_sub_group_remove(uint16_t group_addr)
+{
+    for (uint16_t i = 0; i < meshx_node_params.config.sub_group_num; ++i)
+    {
+        if ((0 != sub_groups[i].ref) && (group_addr == sub_groups[i].addr))
+        {
+            sub_groups[i].ref --;
+            if (0 == sub_groups[i].ref)
+            {
+                meshx_sub_bit_clear(group_addr);
+                MESHX_INFO("unsubscribe group address: 0x%04x", group_addr);
+            }
+            return MESHX_SUCCESS;
+        }
+    }
+
+    MESHX_WARN("group address 0x%04x has not been subscribed", group_addr);
+    return -MESHX_ERR_NOT_FOUND;
+}
+
+static meshx_sub_virtual_t *meshx_sub_virtual_find(const uint8_t label_uuid[16])
+{
+    for (uint16_t i = 0; i < meshx_node_params.config.sub_virtual_num; ++i)
+    {
+        if ((0 != sub_virtuals[i].ref) &&
+            (0 == memcmp(sub_virtuals[i].label_uuid, label_uuid, 16)))
+        {
+            return &sub_virtuals[i];
+        }
+    }
+
+    return NULL;
+}
+
+int32_t meshx_sub_virtual_add(const uint8_t label_uuid[16], uint16_t *pvirtual_addr)
+{
+    meshx_sub_virtual_t *pvirtual = meshx_sub_virtual_find(label_uuid);
+    if (NULL != pvirtual)
+    {
+        pvirtual->ref ++;
+    }
+    else
+    {
+        for (uint16_t i = 0; i < meshx_node_params.config.sub_virtual_num; ++i)
+        {
+            if (0 == sub_virtuals[i].ref)
+            {
+                pvirtual = &sub_virtuals[i];
+                break;
+            }
+        }
+
+        if (NULL == pvirtual)
+        {
+            MESHX_ERROR("add virtual subscription failed: table is full");
+            return -MESHX_ERR_RESOURCE;
+        }
+
+        memcpy(pvirtual->label_uuid, label_uuid, 16);
+        meshx_virtual_addr(label_uuid, &pvirtual->addr);
+        pvirtual->ref = 1;
+        meshx_sub_bit_set(pvirtual->addr);
+        MESHX_INFO("subscribe virtual address: 0x%04x", pvirtual->addr);
+    }
+
+    if (NULL != pvirtual_addr)
+    {
+        *pvirtual_addr = pvirtual->addr;
+    }
+
+    return MESHX_SUCCESS;
+}
+
+int32_t meshx_sub_virtual_remove(const uint8_t label_uuid[16])
+{
+    meshx_sub_virtual_t *pvirtual = meshx_sub_virtual_find(label_uuid);
+    if (NULL == pvirtual)
+    {
+        MESHX_WARN("label uuid has not been subscribed");
+        return -MESHX_ERR_NOT_FOUND;
+    }
+
+    pvirtual->ref --;
+    if (0 == pvirtual->ref)
+    {
+        /* different label uuids may have the same virtual address */
+        const uint8_t *plabel = NULL;
+        meshx_sub_label_traverse_start(pvirtual->addr, &plabel);
+        if (NULL == plabel)
+        {
+            meshx_sub_bit_clear(pvirtual->addr);
+        }
+        MESHX_INFO("unsubscribe virtual address: 0x%04x", pvirtual->addr);
+    }
+
+    return MESHX_SUCCESS;
+}
+
+bool meshx_sub_is_subscribed(uint16_t addr)
+{
+    if (0 == (addr & 0x8000))
+    {
+        return FALSE;
+    }
+
+    uint16_t index = MESHX_SUB_BIT_INDEX(addr);
+    return (0 != (sub_bitmap[index >> 3] & (1 << (index & 0x07))));
+}
+
+static void meshx_sub_label_find(uint16_t virtual_addr, uint16_t start,
+                                 const uint8_t **ptraverse_label)
+{
+    *ptraverse_label = NULL;
+    for (uint16_t i = start; i < meshx_node_params.config.sub_virtual_num; ++i)
+    {
+        if ((0 != sub_virtuals[i].ref) && (virtual_addr == sub_virtuals[i].addr))
+        {
+            *ptraverse_label = sub_virtuals[i].label_uuid;
+            break;
+        }
+    }
+}
+
+void meshx_sub_label_traverse_start(uint16_t virtual_addr, const uint8_t **ptraverse_label)
+{
+    meshx_sub_label_find(virtual_addr, 0, ptraverse_label);
+}
+
+void meshx_sub_label_traverse_continue(uint16_t virtual_addr, const uint8_t **ptraverse_label)
+{
+    const meshx_sub_virtual_t *pvirtual = (const meshx_sub_virtual_t *)(*ptraverse_label);
+    meshx_sub_label_find(virtual_addr, pvirtual - sub_virtuals + 1, ptraverse_label);
+}
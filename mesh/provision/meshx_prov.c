@@ -25,10 +25,164 @@
 #include "meshx_sample_data.h"
 #include "meshx_node_internal.h"
 #include "meshx_key.h"
+#include "meshx_timer.h"
+
+static uint8_t prov_key_pool_size;
+static uint8_t prov_key_pool_count;
+static uint32_t prov_key_pool_hit;
+static uint32_t prov_key_pool_miss;
+
+/* key pairs generated in advance, refilled by crypto worker */
+typedef struct
+{
+    uint8_t public_key[64];
+    uint8_t private_key[32];
+} meshx_prov_key_pair_t;
+
+static meshx_prov_key_pair_t *prov_key_pool;
+static uint8_t prov_key_pool_head;
+static uint8_t prov_key_pool_refilling;
+static meshx_timer_t prov_key_pool_timer;
+
+#define MESHX_PROV_KEY_POOL_RETRY_INTERVAL          1000 /* ms */
+
+/* failed refill is retried later, instead of waiting for next key pair to be taken */
+static void meshx_prov_key_pool_refill_retry(void)
+{
+    if ((NULL != prov_key_pool_timer) && !meshx_timer_is_active(prov_key_pool_timer))
+    {
+        meshx_timer_start(prov_key_pool_timer, MESHX_PROV_KEY_POOL_RETRY_INTERVAL);
+    }
+}
+
+static void meshx_prov_key_pool_refill_complete(meshx_ecc_job_t *pjob)
+{
+    prov_key_pool_refilling --;
+    if ((MESHX_SUCCESS == pjob->result) && (prov_key_pool_count < prov_key_pool_size))
+    {
+        uint8_t tail = (prov_key_pool_head + prov_key_pool_count) % prov_key_pool_size;
+        memcpy(prov_key_pool[tail].public_key, pjob->public_key, 64);
+        memcpy(prov_key_pool[tail].private_key, pjob->private_key, 32);
+        prov_key_pool_count ++;
+    }
+    else
+    {
+        MESHX_ERROR("refill provision key pool failed: %d", pjob->result);
+        meshx_prov_key_pool_refill_retry();
+    }
+    meshx_free(pjob);
+}
+
+static void meshx_prov_key_pool_refill(void)
+{
+    while (prov_key_pool_count + prov_key_pool_refilling < prov_key_pool_size)
+    {
+        meshx_ecc_job_t *pjob = meshx_malloc(sizeof(meshx_ecc_job_t));
+        if (NULL == pjob)
+        {
+            MESHX_ERROR("refill provision key pool failed: out of memory");
+            meshx_prov_key_pool_refill_retry();
+            break;
+        }
+        pjob->type = MESHX_ECC_JOB_MAKE_KEY;
+        pjob->complete = meshx_prov_key_pool_refill_complete;
+        pjob->pargs = NULL;
+        /* worker may be inline, count before submit */
+        prov_key_pool_refilling ++;
+        if (MESHX_SUCCESS != meshx_ecc_job_submit(pjob))
+        {
+            prov_key_pool_refilling --;
+            meshx_free(pjob);
+            meshx_prov_key_pool_refill_retry();
+            break;
+        }
+    }
+}
+
+static void meshx_prov_key_pool_timeout(void *pargs)
+{
+    meshx_async_msg_t msg;
+    msg.type = MESHX_ASYNC_MSG_TYPE_TIMEOUT_PROV_KEY_POOL;
+    msg.pdata = pargs;
+    msg.data_len = 0;
+    meshx_async_msg_send(&msg);
+}
+
+void meshx_prov_async_handle_key_pool_timeout(meshx_async_msg_t msg)
+{
+    if (NULL != prov_key_pool)
+    {
+        meshx_prov_key_pool_refill();
+    }
+}
+
+static int32_t meshx_prov_key_pool_init(uint8_t size)
+{
+    if (0 == size)
+    {
+        return MESHX_SUCCESS;
+    }
+
+    prov_key_pool = meshx_malloc(size * sizeof(meshx_prov_key_pair_t));
+    if (NULL == prov_key_pool)
+    {
+        MESHX_ERROR("initialize provision key pool failed: out of memory");
+        return -MESHX_ERR_MEM;
+    }
+    if (MESHX_SUCCESS != meshx_timer_create(&prov_key_pool_timer, MESHX_TIMER_MODE_SINGLE_SHOT,
+                                            meshx_prov_key_pool_timeout, NULL))
+    {
+        /* pool still works, failed refill is retried when next key pair is taken */
+        MESHX_WARN("create provision key pool retry timer failed");
+        prov_key_pool_timer = NULL;
+    }
+    prov_key_pool_size = size;
+    meshx_prov_key_pool_refill();
+
+    return MESHX_SUCCESS;
+}
+
+/* take key pair from pool in O(1), refill it in background */
+static bool meshx_prov_key_pool_get(uint8_t public_key[64], uint8_t private_key[32])
+{
+    if (0 == prov_key_pool_count)
+    {
+        prov_key_pool_miss ++;
+        return FALSE;
+    }
+
+    memcpy(public_key, prov_key_pool[prov_key_pool_head].public_key, 64);
+    memcpy(private_key, prov_key_pool[prov_key_pool_head].private_key, 32);
+    /* key pair can only be used once */
+    memset(&prov_key_pool[prov_key_pool_head], 0, sizeof(meshx_prov_key_pair_t));
+    prov_key_pool_head = (prov_key_pool_head + 1) % prov_key_pool_size;
+    prov_key_pool_count --;
+    prov_key_pool_hit ++;
+    meshx_prov_key_pool_refill();
+
+    return TRUE;
+}
+
+meshx_prov_key_pool_info_t meshx_prov_key_pool_info_get(void)
+{
+    meshx_prov_key_pool_info_t info;
+    info.size = prov_key_pool_size;
+    info.ready = prov_key_pool_count;
+    info.hit = prov_key_pool_hit;
+    info.miss = prov_key_pool_miss;
+
+    return info;
+}
 
 int32_t meshx_prov_init(void)
 {
     meshx_pb_adv_init();
+#if MESHX_USE_SAMPLE_DATA
+    /* spec sample key pairs keep provisioning transcript deterministic */
+    meshx_prov_key_pool_init(0);
+#else
+    meshx_prov_key_pool_init(meshx_node_params.config.prov_key_pool_size);
+#endif
     return MESHX_SUCCESS;
 }
 
@@ -99,6 +253,112 @@ uint8_t meshx_prov_get_device_id(meshx_prov_dev_t prov_dev)
     return prov_dev->id;
 }
 
+static void meshx_prov_ecc_job_complete(meshx_ecc_job_t *pjob);
+
+static int32_t meshx_prov_ecc_job_submit(meshx_prov_dev_t prov_dev, meshx_ecc_job_type_t type)
+{
+    if (NULL != prov_dev->pecc_job)
+    {
+        MESHX_WARN("ecc job %d is processing", prov_dev->pecc_job->type);
+        return -MESHX_ERR_BUSY;
+    }
+
+    meshx_ecc_job_t *pjob = meshx_malloc(sizeof(meshx_ecc_job_t));
+    if (NULL == pjob)
+    {
+        MESHX_ERROR("submit ecc job failed: out of memory");
+        return -MESHX_ERR_MEM;
+    }
+    pjob->type = type;
+    if (MESHX_ECC_JOB_SHARED_SECRET == type)
+    {
+        memcpy(pjob->public_key, prov_dev->public_key_remote, sizeof(pjob->public_key));
+        memcpy(pjob->private_key, prov_dev->private_key, sizeof(pjob->private_key));
+    }
+    pjob->complete = meshx_prov_ecc_job_complete;
+    pjob->pargs = prov_dev;
+
+    prov_dev->pecc_job = pjob;
+    int32_t ret = meshx_ecc_job_submit(pjob);
+    if (MESHX_SUCCESS != ret)
+    {
+        prov_dev->pecc_job = NULL;
+        meshx_free(pjob);
+    }
+
+    return ret;
+}
+
+static void meshx_prov_share_secret_done(meshx_prov_dev_t prov_dev)
+{
+    prov_dev->share_secret_pending = FALSE;
+    MESHX_DEBUG("shared secret:");
+    MESHX_DUMP_DEBUG(prov_dev->share_secret, 32);
+
+    prov_dev->state = MESHX_PROV_STATE_PUBLIC_KEY;
+    /* notify app public key value */
+    meshx_notify_prov_t notify_prov;
+    notify_prov.metadata.prov_dev = prov_dev;
+    notify_prov.metadata.notify_type = MESHX_PROV_NOTIFY_PUBLIC_KEY;
+    notify_prov.pdata = prov_dev->public_key_remote;
+    meshx_notify(prov_dev->bearer, MESHX_NOTIFY_TYPE_PROV, &notify_prov,
+                 sizeof(meshx_notify_prov_metadata_t) + sizeof(meshx_prov_public_key_t));
+}
+
+static void meshx_prov_ecc_job_complete(meshx_ecc_job_t *pjob)
+{
+    meshx_prov_dev_t prov_dev = pjob->pargs;
+    if (NULL == prov_dev)
+    {
+        /* provision device has been deleted */
+        MESHX_INFO("drop ecc job %d result of deleted device", pjob->type);
+        meshx_free(pjob);
+        return ;
+    }
+    prov_dev->pecc_job = NULL;
+
+    if (MESHX_SUCCESS != pjob->result)
+    {
+        MESHX_ERROR("ecc job %d failed: %d", pjob->type, pjob->result);
+        meshx_free(pjob);
+        meshx_prov_failed(prov_dev, MESHX_PROV_FAILED_UNEXPECTED_ERROR);
+        return ;
+    }
+
+    if (MESHX_ECC_JOB_MAKE_KEY == pjob->type)
+    {
+        memcpy(prov_dev->public_key, pjob->public_key, sizeof(prov_dev->public_key));
+        memcpy(prov_dev->private_key, pjob->private_key, sizeof(prov_dev->private_key));
+        prov_dev->public_key_ready = TRUE;
+        MESHX_DEBUG("public key:");
+        MESHX_DUMP_DEBUG(prov_dev->public_key, sizeof(prov_dev->public_key));
+        MESHX_DEBUG("private key:");
+        MESHX_DUMP_DEBUG(prov_dev->private_key, sizeof(prov_dev->private_key));
+        meshx_free(pjob);
+
+        /* notify app local public key is ready */
+        meshx_notify_prov_t notify_prov;
+        notify_prov.metadata.prov_dev = prov_dev;
+        notify_prov.metadata.notify_type = MESHX_PROV_NOTIFY_LOCAL_PUBLIC_KEY;
+        notify_prov.pdata = prov_dev->public_key;
+        meshx_notify(prov_dev->bearer, MESHX_NOTIFY_TYPE_PROV, &notify_prov,
+                     sizeof(meshx_notify_prov_metadata_t) + sizeof(meshx_prov_public_key_t));
+
+        /* remote public key arrives before local key is generated */
+        if (prov_dev->share_secret_pending &&
+            (MESHX_SUCCESS != meshx_prov_ecc_job_submit(prov_dev, MESHX_ECC_JOB_SHARED_SECRET)))
+        {
+            meshx_prov_failed(prov_dev, MESHX_PROV_FAILED_OUT_OF_RESOURCE);
+        }
+    }
+    else
+    {
+        memcpy(prov_dev->share_secret, pjob->secret, sizeof(prov_dev->share_secret));
+        meshx_free(pjob);
+        meshx_prov_share_secret_done(prov_dev);
+    }
+}
+
 int32_t meshx_prov_make_key(meshx_prov_dev_t prov_dev)
 {
     if (NULL == prov_dev)
@@ -109,6 +369,14 @@ int32_t meshx_prov_make_key(meshx_prov_dev_t prov_dev)
 
     int32_t ret = MESHX_SUCCESS;
 
+    /* pool is disabled with sample data */
+    if ((0 != prov_key_pool_size) &&
+        meshx_prov_key_pool_get(prov_dev->public_key, prov_dev->private_key))
+    {
+        prov_dev->public_key_ready = TRUE;
+        return ret;
+    }
+
 #if MESHX_USE_SAMPLE_DATA
     if (MESHX_ROLE_DEVICE == prov_dev->role)
     {
@@ -120,13 +388,16 @@ int32_t meshx_prov_make_key(meshx_prov_dev_t prov_dev)
         memcpy(prov_dev->public_key, sample_prov_public_key, sizeof(prov_dev->public_key));
         memcpy(prov_dev->private_key, sample_prov_private_key, sizeof(prov_dev->private_key));
     }
-#else
-    ret = meshx_ecc_make_key(prov_dev->public_key, prov_dev->private_key);
-#endif
+    prov_dev->public_key_ready = TRUE;
     MESHX_DEBUG("public key:");
     MESHX_DUMP_DEBUG(prov_dev->public_key, sizeof(prov_dev->public_key));
     MESHX_DEBUG("private key:");
     MESHX_DUMP_DEBUG(prov_dev->private_key, sizeof(prov_dev->private_key));
+#else
+    /* pool is empty, key is generated in crypto worker */
+    prov_dev->public_key_ready = FALSE;
+    ret = meshx_prov_ecc_job_submit(prov_dev, MESHX_ECC_JOB_MAKE_KEY);
+#endif
 
     return ret;
 }
@@ -140,6 +411,12 @@ int32_t meshx_prov_get_local_public_key(meshx_prov_dev_t prov_dev,
         return -MESHX_ERR_INVAL;
     }
 
+    if (!prov_dev->public_key_ready)
+    {
+        MESHX_WARN("public key is generating");
+        return -MESHX_ERR_BUSY;
+    }
+
     memcpy(pkey, prov_dev->public_key, sizeof(meshx_prov_public_key_t));
 
     return MESHX_SUCCESS;
@@ -455,6 +732,13 @@ static void meshx_prov_delete_device(meshx_prov_dev_t prov_dev)
         return;
     }
 
+    if (NULL != prov_dev->pecc_job)
+    {
+        /* job is released when it is done */
+        prov_dev->pecc_job->pargs = NULL;
+        prov_dev->pecc_job = NULL;
+    }
+
     switch (prov_dev->bearer->type)
     {
     case MESHX_BEARER_TYPE_ADV:
@@ -1191,24 +1475,23 @@ int32_t meshx_prov_pdu_process(meshx_prov_dev_t prov_dev,
         }
         else
         {
-            if (meshx_prov_validate_public_key(&pprov_pdu->public_key))
+            if (prov_dev->share_secret_pending)
+            {
+                MESHX_INFO("shared secret is generating, ignore public key");
+            }
+            else if (meshx_prov_validate_public_key(&pprov_pdu->public_key))
             {
-                /* generate secret */
-                meshx_ecc_shared_secret((const uint8_t *)&pprov_pdu->public_key, prov_dev->private_key,
-                                        prov_dev->share_secret);
-                MESHX_DEBUG("shared secret:");
-                MESHX_DUMP_DEBUG(prov_dev->share_secret, 32);
-
-                /* notify app public key */
-                prov_dev->state = MESHX_PROV_STATE_PUBLIC_KEY;
+                /* generate secret in crypto worker, app is notified when secret is ready */
                 memcpy(prov_dev->public_key_remote, &pprov_pdu->public_key, 64);
-                /* notify app public key value */
-                meshx_notify_prov_t notify_prov;
-                notify_prov.metadata.prov_dev = prov_dev;
-                notify_prov.metadata.notify_type = MESHX_PROV_NOTIFY_PUBLIC_KEY;
-                notify_prov.pdata = &pprov_pdu->public_key;
-                meshx_notify(prov_dev->bearer, MESHX_NOTIFY_TYPE_PROV, &notify_prov,
-                             sizeof(meshx_notify_prov_metadata_t) + sizeof(meshx_prov_public_key_t));
+                prov_dev->share_secret_pending = TRUE;
+                if (prov_dev->public_key_ready)
+                {
+                    ret = meshx_prov_ecc_job_submit(prov_dev, MESHX_ECC_JOB_SHARED_SECRET);
+                    if (MESHX_SUCCESS != ret)
+                    {
+                        meshx_prov_failed(prov_dev, MESHX_PROV_FAILED_OUT_OF_RESOURCE);
+                    }
+                }
             }
             else
             {
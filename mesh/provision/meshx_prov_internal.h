@@ -13,6 +13,7 @@
 #include "meshx_prov.h"
 #include "meshx_async_internal.h"
 #include "meshx_notify.h"
+#include "meshx_security.h"
 
 MESHX_BEGIN_DECLS
 
@@ -41,6 +42,9 @@ struct _meshx_prov_dev
     meshx_prov_random_t random_remote;
     meshx_prov_data_t data;
     uint8_t err_code; /* provision failed error code */
+    meshx_ecc_job_t *pecc_job; /* ecc job processing in crypto worker */
+    bool public_key_ready;
+    bool share_secret_pending; /* remote public key received, waiting for shared secret */
 };
 
 
@@ -50,6 +54,7 @@ MESHX_EXTERN int32_t meshx_prov_pdu_process(meshx_prov_dev_t prov_dev,
                                             const uint8_t *pdata, uint8_t len);
 
 MESHX_EXTERN void meshx_pb_adv_async_handle_timeout(meshx_async_msg_t msg);
+MESHX_EXTERN void meshx_prov_async_handle_key_pool_timeout(meshx_async_msg_t msg);
 
 MESHX_EXTERN int32_t meshx_prov_handle_notify(meshx_bearer_t bearer,
                                               const meshx_notify_prov_t *pnotify, uint8_t len);
@@ -270,6 +270,7 @@ static int32_t meshx_proxy_dispatch(meshx_bearer_t bearer, uint8_t msg_type, con
         ret = meshx_beacon_receive(bearer, pdata, len, NULL);
         break;
     case MESHX_PROXY_MSG_TYPE_PROXY_CFG:
+        ret = meshx_proxy_cfg_receive(bearer, pdata, len);
         break;
     case MESHX_PROXY_MSG_TYPE_PROV:
         break;
@@ -304,6 +305,12 @@ int32_t meshx_proxy_receive(meshx_bearer_t bearer, const uint8_t *pdata, uint16_
             return -MESHX_ERR_UNEXPECTED;
         }
 
+        if (MESHX_PROXY_SAR_COMPLETE_MSG == prx_pdu->sar)
+        {
+            /* no segment, notify upper layer directly */
+            return meshx_proxy_dispatch(bearer, prx_pdu->msg_type, prx_pdu->data, data_len);
+        }
+
         prx_ctx = meshx_proxy_rx_ctx_request(len);
         if (NULL == prx_ctx)
         {
@@ -0,0 +1,122 @@
+/**
+ * This file is part of the meshx library.
+ *
+ * Copyright 2019, Huang Yang <elious.huang@gmail.com>. All rights reserved.
+ *
+ * See the COPYING file for the terms of usage and distribution.
+ */
+#include <string.h>
+#define MESHX_TRACE_MODULE "MESHX_PROXY_CFG"
+#include "meshx_trace.h"
+#include "meshx_errno.h"
+#include "meshx_proxy.h"
+#include "meshx_proxy_internal.h"
+#include "meshx_net.h"
+#include "meshx_net_internal.h"
+#include "meshx_node_internal.h"
+#include "meshx_iv_index.h"
+#include "meshx_seq.h"
+#include "meshx_endianness.h"
+
+typedef struct
+{
+    uint8_t opcode;
+    uint8_t filter_type;
+    uint16_t list_size;
+} __PACKED meshx_proxy_cfg_filter_status_t;
+
+static int32_t meshx_proxy_cfg_filter_status(const meshx_msg_ctx_t *pmsg_rx_ctx)
+{
+    meshx_proxy_cfg_filter_status_t status;
+    status.opcode = MESHX_PROXY_CFG_OPCODE_FILTER_STATUS;
+    status.filter_type = meshx_net_iface_proxy_filter_type_get(pmsg_rx_ctx->net_iface);
+    status.list_size = MESHX_HOST_TO_BE16(meshx_net_iface_proxy_filter_size(pmsg_rx_ctx->net_iface));
+
+    meshx_msg_ctx_t msg_tx_ctx;
+    memset(&msg_tx_ctx, 0, sizeof(meshx_msg_ctx_t));
+    msg_tx_ctx.ctl = 1;
+    msg_tx_ctx.ttl = 0;
+    msg_tx_ctx.src = meshx_node_params.param.node_addr;
+    msg_tx_ctx.dst = MESHX_ADDRESS_UNASSIGNED;
+    msg_tx_ctx.iv_index = meshx_iv_index_tx_get();
+    msg_tx_ctx.seq = meshx_seq_use(0);
+    msg_tx_ctx.pnet_key = pmsg_rx_ctx->pnet_key;
+    msg_tx_ctx.net_iface = pmsg_rx_ctx->net_iface;
+
+    return meshx_net_proxy_cfg_send((const uint8_t *)&status, sizeof(status), &msg_tx_ctx);
+}
+
+int32_t meshx_proxy_cfg_receive(meshx_bearer_t bearer, const uint8_t *pdata, uint16_t len)
+{
+    meshx_net_iface_t net_iface = meshx_net_iface_get(bearer);
+    if (NULL == net_iface)
+    {
+        MESHX_ERROR("bearer(0x%08x) has not been connected to any network interface!", bearer);
+        return -MESHX_ERR_CONNECT;
+    }
+
+    if (len > UINT8_MAX)
+    {
+        MESHX_ERROR("invalid proxy configuration message length: %d", len);
+        return -MESHX_ERR_LENGTH;
+    }
+
+    uint8_t msg[UINT8_MAX];
+    uint8_t msg_len = 0;
+    meshx_msg_ctx_t msg_rx_ctx;
+    int32_t ret = meshx_net_proxy_cfg_receive(net_iface, pdata, len, msg, &msg_len, &msg_rx_ctx);
+    if (MESHX_SUCCESS != ret)
+    {
+        return ret;
+    }
+
+    if (0 == msg_len)
+    {
+        return -MESHX_ERR_LENGTH;
+    }
+
+    const uint8_t *pparam = msg + 1;
+    uint8_t param_len = msg_len - 1;
+    switch (msg[0])
+    {
+    case MESHX_PROXY_CFG_OPCODE_SET_FILTER_TYPE:
+        if (1 != param_len)
+        {
+            return -MESHX_ERR_LENGTH;
+        }
+        ret = meshx_net_iface_proxy_filter_type_set(net_iface, pparam[0]);
+        break;
+    case MESHX_PROXY_CFG_OPCODE_ADD_ADDR:
+    case MESHX_PROXY_CFG_OPCODE_REMOVE_ADDR:
+        if ((0 == param_len) || (0 != (param_len & 0x01)))
+        {
+            return -MESHX_ERR_LENGTH;
+        }
+        for (uint8_t i = 0; i < param_len; i += 2)
+        {
+            uint16_t addr = ((uint16_t)pparam[i] << 8) | pparam[i + 1];
+            if (MESHX_PROXY_CFG_OPCODE_ADD_ADDR == msg[0])
+            {
+                meshx_net_iface_proxy_filter_add(net_iface, addr);
+            }
+            else
+            {
+                meshx_net_iface_proxy_filter_remove(net_iface, addr);
+            }
+        }
+        break;
+    default:
+        MESHX_WARN("unknown proxy configuration opcode: 0x%02x", msg[0]);
+        return -MESHX_ERR_INVAL;
+    }
+
+    if (MESHX_SUCCESS != ret)
+    {
+        return ret;
+    }
+
+    MESHX_INFO("proxy filter: type %d, size %d", meshx_net_iface_proxy_filter_type_get(net_iface),
+               meshx_net_iface_proxy_filter_size(net_iface));
+
+    return meshx_proxy_cfg_filter_status(&msg_rx_ctx);
+}
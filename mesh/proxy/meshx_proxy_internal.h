@@ -19,6 +19,8 @@ MESHX_EXTERN uint16_t meshx_prov_char_data_out_handle(void);
 MESHX_EXTERN uint16_t meshx_prov_char_data_in_handle(void);
 MESHX_EXTERN int32_t meshx_prov_server_receive(meshx_bearer_t bearer, const uint8_t *pdata,
                                                uint16_t len);
+MESHX_EXTERN int32_t meshx_proxy_cfg_receive(meshx_bearer_t bearer, const uint8_t *pdata,
+                                             uint16_t len);
 MESHX_EXTERN int32_t meshx_proxy_server_receive(meshx_bearer_t bearer, const uint8_t *pdata,
                                                 uint16_t len);
 
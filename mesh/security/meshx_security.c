@@ -8,9 +8,125 @@
 #include <string.h>
 #define MESHX_TRACE_MODULE "MESHX_SECURITY"
 #include "meshx_trace.h"
-#include "meshx_mem.h"
 #include "meshx_security.h"
+#include "meshx_security_internal.h"
+#include "meshx_crypto_worker.h"
 #include "meshx_errno.h"
+#include "meshx_sample_data.h"
+
+/* s1("smk2"), s1("smk3"), s1("smk4"), s1("nkik"), s1("nkbk") */
+static const uint8_t meshx_salts[MESHX_SALT_NUM][16] =
+{
+    {0x4f, 0x90, 0x48, 0x0c, 0x18, 0x71, 0xbf, 0xbf, 0xfd, 0x16, 0x97, 0x1f, 0x4d, 0x8d, 0x10, 0xb1},
+    {0x00, 0x36, 0x44, 0x35, 0x03, 0xf1, 0x95, 0xcc, 0x8a, 0x71, 0x6e, 0x13, 0x62, 0x91, 0xc3, 0x02},
+    {0x0e, 0x9a, 0xc1, 0xb7, 0xce, 0xfa, 0x66, 0x87, 0x4c, 0x97, 0xee, 0x54, 0xac, 0x5f, 0x49, 0xbe},
+    {0xf8, 0x79, 0x5a, 0x1a, 0xab, 0xf1, 0x82, 0xe4, 0xf1, 0x63, 0xd8, 0x6e, 0x24, 0x5e, 0x19, 0xf4},
+    {0x2c, 0x24, 0x61, 0x9a, 0xb7, 0x93, 0xc1, 0x23, 0x3f, 0x6e, 0x22, 0x67, 0x38, 0x39, 0x3d, 0xec},
+};
+
+/**
+ * cmac context of salts, salts are used as cmac key. contexts are expanded by the aes backend
+ * in use, they are built before crypto workers start and rebuilt when backend changes
+ */
+static meshx_aes_cmac_ctx_t meshx_salt_ctxs[MESHX_SALT_NUM];
+
+static void meshx_salt_ctxs_init(void)
+{
+    for (uint8_t i = 0; i < MESHX_SALT_NUM; ++i)
+    {
+        meshx_aes_cmac_ctx_init(&meshx_salt_ctxs[i], meshx_salts[i]);
+    }
+}
+
+static const meshx_aes_cmac_ctx_t *meshx_salt_ctx_get(meshx_salt_t salt)
+{
+    return &meshx_salt_ctxs[salt];
+}
+
+int32_t meshx_security_backend_set(meshx_aes128_backend_t backend)
+{
+    int32_t ret = meshx_aes128_backend_set(backend);
+    if (MESHX_SUCCESS == ret)
+    {
+        meshx_salt_ctxs_init();
+    }
+
+    return ret;
+}
+
+/* specification sample data: k2, k3 of sample net key and network pdu of sample message #1 */
+static const uint8_t meshx_check_encryption_key[16] =
+{
+    0x09, 0x53, 0xfa, 0x93, 0xe7, 0xca, 0xac, 0x96, 0x38, 0xf5, 0x88, 0x20, 0x22, 0x0a, 0x39, 0x8e
+};
+static const uint8_t meshx_check_privacy_key[16] =
+{
+    0x8b, 0x84, 0xee, 0xde, 0xc1, 0x00, 0x06, 0x7d, 0x67, 0x09, 0x71, 0xdd, 0x2a, 0xa7, 0x00, 0xcf
+};
+static const uint8_t meshx_check_net_id[8] = {0x3e, 0xca, 0xff, 0x67, 0x2f, 0x67, 0x33, 0x70};
+static const uint8_t meshx_check_net_nonce[MESHX_NONCE_SIZE] =
+{
+    0x00, 0x80, 0x00, 0x00, 0x01, 0x12, 0x01, 0x00, 0x00, 0x12, 0x34, 0x56, 0x78
+};
+static const uint8_t meshx_check_net_plain[13] =
+{
+    0xff, 0xfd, 0x03, 0x4b, 0x50, 0x05, 0x7e, 0x40, 0x00, 0x00, 0x01, 0x00, 0x00
+};
+static const uint8_t meshx_check_net_cipher[13 + 8] =
+{
+    0xb5, 0xe5, 0xbf, 0xda, 0xcb, 0xaf, 0x6c, 0xb7, 0xfb, 0x6b, 0xff, 0x87, 0x1f,
+    0x03, 0x54, 0x44, 0xce, 0x83, 0xa6, 0x70, 0xdf
+};
+
+/**
+ * check key derivation and ccm of current backend with sample data of specification, keys
+ * are expanded after backend is set
+ */
+static bool meshx_security_check(void)
+{
+    uint8_t P = 0x00;
+    uint8_t nid, aid;
+    uint8_t encryption_key[16], privacy_key[16], net_id[8];
+    meshx_k2(sample_net_key, &P, 1, &nid, encryption_key, privacy_key);
+    meshx_k3(sample_net_key, net_id);
+    meshx_k4(sample_app_key, &aid);
+    if ((0x68 != nid) || (0x26 != aid) ||
+        (0 != memcmp(encryption_key, meshx_check_encryption_key, 16)) ||
+        (0 != memcmp(privacy_key, meshx_check_privacy_key, 16)) ||
+        (0 != memcmp(net_id, meshx_check_net_id, 8)))
+    {
+        return FALSE;
+    }
+
+    meshx_aes128_ctx_t ctx;
+    uint8_t cipher[sizeof(meshx_check_net_cipher)];
+    meshx_aes128_ctx_init(&ctx, encryption_key);
+    meshx_aes_ccm_ctx_encrypt(&ctx, meshx_check_net_nonce, MESHX_NONCE_SIZE, NULL, 0,
+                              meshx_check_net_plain, sizeof(meshx_check_net_plain), cipher,
+                              cipher + sizeof(meshx_check_net_plain), 8);
+
+    return (0 == memcmp(cipher, meshx_check_net_cipher, sizeof(meshx_check_net_cipher)));
+}
+
+/**
+ * select the fastest aes backend, accelerated backend is only used when it produces the
+ * keys and ciphertext of specification sample data
+ */
+int32_t meshx_security_init(void)
+{
+    meshx_security_wrapper_init();
+    meshx_aes128_backend_t backend = meshx_aes128_backend_get();
+    meshx_security_backend_set(backend);
+    if ((MESHX_AES128_BACKEND_SOFTWARE != backend) && !meshx_security_check())
+    {
+        MESHX_ERROR("aes backend %d self check failed, use software backend", backend);
+        backend = MESHX_AES128_BACKEND_SOFTWARE;
+        meshx_security_backend_set(backend);
+    }
+    MESHX_INFO("aes backend: %d", backend);
+
+    return MESHX_SUCCESS;
+}
 
 int32_t meshx_s1(const uint8_t *pdata, uint32_t len, uint8_t salt[16])
 {
@@ -41,6 +157,21 @@ int32_t meshx_k1(const uint8_t *pN, uint32_t Nlen, uint8_t salt[16], const uint8
     return MESHX_SUCCESS;
 }
 
+int32_t meshx_k1_salt(meshx_salt_t salt, const uint8_t *pN, uint32_t Nlen,
+                      const uint8_t *pP, uint32_t Plen, uint8_t key[16])
+{
+    if ((NULL == pN) || (NULL == pP) || (salt >= MESHX_SALT_NUM))
+    {
+        return -MESHX_ERR_INVAL;
+    }
+
+    uint8_t key_T[16];
+    meshx_aes_cmac_ctx(meshx_salt_ctx_get(salt), pN, Nlen,  key_T);
+    meshx_aes_cmac(key_T, pP, Plen, key);
+
+    return MESHX_SUCCESS;
+}
+
 int32_t meshx_k2(const uint8_t N[16], const uint8_t *pP, uint32_t Plen, uint8_t *pnid,
                  uint8_t encryption_key[16], uint8_t privacy_key[16])
 {
@@ -49,36 +180,34 @@ int32_t meshx_k2(const uint8_t N[16], const uint8_t *pP, uint32_t Plen, uint8_t
         return -MESHX_ERR_INVAL;
     }
 
-    uint8_t *pt_tmp = meshx_malloc(Plen + 17);
-    if (NULL == pt_tmp)
+    if (Plen > MESHX_K2_P_MAX_LEN)
     {
-        return -MESHX_ERR_MEM;
+        return -MESHX_ERR_LENGTH;
     }
-    memcpy(pt_tmp, pP, Plen);
 
-    uint8_t salt[16];
-    uint8_t smk2[] = {'s', 'm', 'k', '2'};
-    meshx_s1(smk2, sizeof(smk2), salt);
     uint8_t key_T[16];
-    meshx_aes_cmac(salt, N, 16,  key_T);
+    meshx_aes_cmac_ctx(meshx_salt_ctx_get(MESHX_SALT_SMK2), N, 16,  key_T);
+    meshx_aes_cmac_ctx_t key_T_ctx;
+    meshx_aes_cmac_ctx_init(&key_T_ctx, key_T);
 
+    uint8_t pt_tmp[16 + MESHX_K2_P_MAX_LEN + 1];
     uint8_t T1[16], T2[16], T3[16];
 
     /* generate T1  */
+    memcpy(pt_tmp, pP, Plen);
     pt_tmp[Plen] = 0x01;
-    meshx_aes_cmac(key_T, pt_tmp, Plen + 1, T1);
+    meshx_aes_cmac_ctx(&key_T_ctx, pt_tmp, Plen + 1, T1);
 
     /* generate T2  */
     memcpy(pt_tmp, T1, 16);
     memcpy(pt_tmp + 16, pP, Plen);
     pt_tmp[Plen + 16] = 0x02;
-    meshx_aes_cmac(key_T, pt_tmp, Plen + 17, T2);
+    meshx_aes_cmac_ctx(&key_T_ctx, pt_tmp, Plen + 17, T2);
 
     /* generate T3  */
     memcpy(pt_tmp, T2, 16);
-    memcpy(pt_tmp + 16, pP, Plen);
     pt_tmp[Plen + 16] = 0x03;
-    meshx_aes_cmac(key_T, pt_tmp, Plen + 17, T3);
+    meshx_aes_cmac_ctx(&key_T_ctx, pt_tmp, Plen + 17, T3);
 
     /* generate id */
     *pnid = (T1[15] & 0x7f);
@@ -90,11 +219,8 @@ int32_t meshx_k2(const uint8_t N[16], const uint8_t *pP, uint32_t Plen, uint8_t
 
 int32_t meshx_k3(const uint8_t N[16], uint8_t value[8])
 {
-    uint8_t salt[16];
-    uint8_t smk3[] = {'s', 'm', 'k', '3'};
-    meshx_s1(smk3, sizeof(smk3), salt);
     uint8_t key_T[16];
-    meshx_aes_cmac(salt, N, 16,  key_T);
+    meshx_aes_cmac_ctx(meshx_salt_ctx_get(MESHX_SALT_SMK3), N, 16,  key_T);
     uint8_t id64[] = {'i', 'd', '6', '4', 0x01};
     uint8_t out[16];
     meshx_aes_cmac(key_T, id64, sizeof(id64), out);
@@ -105,20 +231,81 @@ int32_t meshx_k3(const uint8_t N[16], uint8_t value[8])
 
 int32_t meshx_k4(const uint8_t N[16], uint8_t value[1])
 {
-    uint8_t salt[16];
-    uint8_t smk4[] = {'s', 'm', 'k', '4'};
-    meshx_s1(smk4, sizeof(smk4), salt);
     uint8_t key_T[16];
-    meshx_aes_cmac(salt, N, 16,  key_T);
-    uint8_t id64[] = {'i', 'd', '6', 0x01};
+    meshx_aes_cmac_ctx(meshx_salt_ctx_get(MESHX_SALT_SMK4), N, 16,  key_T);
+    uint8_t id6[] = {'i', 'd', '6', 0x01};
     uint8_t out[16];
-    meshx_aes_cmac(key_T, id64, sizeof(id64), out);
+    meshx_aes_cmac(key_T, id6, sizeof(id6), out);
     value[0] = out[15] & 0x3f;
 
     return MESHX_SUCCESS;
 }
 
+int32_t meshx_virtual_addr(const uint8_t label_uuid[16], uint16_t *pvirtual_addr)
+{
+    /* only used when label uuid is added, so salt is not calculated in advance */
+    uint8_t vtad[16];
+    meshx_s1((const uint8_t *)"vtad", 4, vtad);
+    uint8_t hash[16];
+    meshx_aes_cmac(vtad, label_uuid, 16, hash);
+    *pvirtual_addr = 0x8000 | (((hash[14] << 8) | hash[15]) & 0x3fff);
+
+    return MESHX_SUCCESS;
+}
+
 int32_t meshx_e(const uint8_t input[16], const uint8_t key[16], uint8_t output[16])
 {
     return meshx_aes128_encrypt(input, key, output);
-}
\ No newline at end of file
+}
+
+static void meshx_ecc_job_process(void *pargs)
+{
+    meshx_ecc_job_t *pjob = pargs;
+    if (MESHX_ECC_JOB_MAKE_KEY == pjob->type)
+    {
+        pjob->result = meshx_ecc_make_key(pjob->public_key, pjob->private_key);
+    }
+    else
+    {
+        pjob->result = meshx_ecc_shared_secret(pjob->public_key, pjob->private_key, pjob->secret);
+    }
+
+    meshx_async_msg_t msg;
+    msg.type = MESHX_ASYNC_MSG_TYPE_ECC_JOB_DONE;
+    msg.pdata = pjob;
+    msg.data_len = 0;
+    meshx_async_msg_post(pjob->pdone_msg, &msg);
+}
+
+int32_t meshx_ecc_job_submit(meshx_ecc_job_t *pjob)
+{
+    if ((NULL == pjob) || (NULL == pjob->complete) ||
+        (pjob->type > MESHX_ECC_JOB_SHARED_SECRET))
+    {
+        MESHX_ERROR("invalid ecc job");
+        return -MESHX_ERR_INVAL;
+    }
+
+    pjob->pdone_msg = meshx_async_msg_reserve();
+    if (NULL == pjob->pdone_msg)
+    {
+        return -MESHX_ERR_RESOURCE;
+    }
+
+    pjob->result = -MESHX_ERR_BUSY;
+    int32_t ret = meshx_crypto_worker_submit(meshx_ecc_job_process, pjob);
+    if (MESHX_SUCCESS != ret)
+    {
+        meshx_async_msg_cancel(pjob->pdone_msg);
+        pjob->pdone_msg = NULL;
+    }
+
+    return ret;
+}
+
+void meshx_ecc_async_handle_job_done(meshx_async_msg_t msg)
+{
+    meshx_ecc_job_t *pjob = msg.pdata;
+    MESHX_DEBUG("ecc job %d done: %d", pjob->type, pjob->result);
+    pjob->complete(pjob);
+}
@@ -63,15 +63,68 @@ typedef struct
     uint32_t iv_index;
 } __PACKED meshx_proxy_nonce_t;
 
+/* constant salts of key derivation, s1 of them are calculated in advance */
+typedef enum
+{
+    MESHX_SALT_SMK2,
+    MESHX_SALT_SMK3,
+    MESHX_SALT_SMK4,
+    MESHX_SALT_NKIK,
+    MESHX_SALT_NKBK,
+    MESHX_SALT_NUM,
+} meshx_salt_t;
+
+#define MESHX_K2_P_MAX_LEN                  16
+
+typedef enum
+{
+    MESHX_ECC_JOB_MAKE_KEY,
+    MESHX_ECC_JOB_SHARED_SECRET,
+} meshx_ecc_job_type_t;
+
+typedef struct _meshx_ecc_job meshx_ecc_job_t;
+/* called in stack context when job is done, job memory is owned by caller */
+typedef void (*meshx_ecc_job_complete_t)(meshx_ecc_job_t *pjob);
+
+/**
+ * make key: output public_key and private_key
+ * shared secret: input public_key(remote) and private_key, output secret
+ */
+struct _meshx_ecc_job
+{
+    meshx_ecc_job_type_t type;
+    uint8_t public_key[64];
+    uint8_t private_key[32];
+    uint8_t secret[32];
+    int32_t result;
+    meshx_ecc_job_complete_t complete;
+    void *pargs;
+    void *pdone_msg; /* reserved when job is submitted, so result always reaches stack */
+};
 
+
+MESHX_EXTERN int32_t meshx_security_init(void);
+/**
+ * change aes backend and rebuild contexts of constant salts, keys expanded by previous backend
+ * shall be expanded again, no crypto operation shall be in progress
+ */
+MESHX_EXTERN int32_t meshx_security_backend_set(meshx_aes128_backend_t backend);
 MESHX_EXTERN int32_t meshx_s1(const uint8_t *pM, uint32_t Mlen, uint8_t salt[16]);
 MESHX_EXTERN int32_t meshx_k1(const uint8_t *pN, uint32_t Nlen, uint8_t salt[16], const uint8_t *pP,
                               uint32_t Plen, uint8_t key[16]);
+MESHX_EXTERN int32_t meshx_k1_salt(meshx_salt_t salt, const uint8_t *pN, uint32_t Nlen,
+                                   const uint8_t *pP, uint32_t Plen, uint8_t key[16]);
 MESHX_EXTERN int32_t meshx_k2(const uint8_t N[16], const uint8_t *pP, uint32_t Plen, uint8_t *pnid,
                               uint8_t encryption_key[16], uint8_t privacy_key[16]);
 MESHX_EXTERN int32_t meshx_k3(const uint8_t N[16], uint8_t value[8]);
 MESHX_EXTERN int32_t meshx_k4(const uint8_t N[16], uint8_t value[1]);
+MESHX_EXTERN int32_t meshx_virtual_addr(const uint8_t label_uuid[16], uint16_t *pvirtual_addr);
 MESHX_EXTERN int32_t meshx_e(const uint8_t input[16], const uint8_t key[16], uint8_t output[16]);
+/**
+ * process ecc job in crypto worker, job result is notified by complete callback through
+ * async message, job must keep valid until complete callback is called
+ */
+MESHX_EXTERN int32_t meshx_ecc_job_submit(meshx_ecc_job_t *pjob);
 
 
 MESHX_END_DECLS
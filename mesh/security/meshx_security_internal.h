@@ -0,0 +1,20 @@
+/**
+ * This file is part of the meshx library.
+ *
+ * Copyright 2019, Huang Yang <elious.huang@gmail.com>. All rights reserved.
+ *
+ * See the COPYING file for the terms of usage and distribution.
+ */
+#ifndef _MESHX_SECURITY_INTERNAL_H_
+#define _MESHX_SECURITY_INTERNAL_H_
+
+#include "meshx_async_internal.h"
+
+MESHX_BEGIN_DECLS
+
+MESHX_EXTERN void meshx_ecc_async_handle_job_done(meshx_async_msg_t msg);
+
+MESHX_END_DECLS
+
+
+#endif /* _MESHX_SECURITY_INTERNAL_H_ */
@@ -25,6 +25,8 @@
 #include "meshx_rpl.h"
 #include "meshx_iv_index_internal.h"
 #include "meshx_iv_index.h"
+#include "meshx_pkt.h"
+#include "meshx_config.h"
 
 /**
  *  NOTE: only one segment message can send to the same destination once a time,
@@ -60,10 +62,13 @@
 typedef struct
 {
     meshx_msg_ctx_t msg_tx_ctx;
+    meshx_pkt_t *ppkt; /* upper transport pdu, reference is held until task is released */
     uint8_t *ppdu;
     uint16_t pdu_len;
     uint32_t seg_bits;
     uint32_t block_ack;
+    uint32_t seg_sent; /* segments handed to network layer in current round */
+    bool paused; /* network interface would block, wait for resume */
     meshx_timer_t retry_timer;
     uint8_t retry_times;
     meshx_list_t node;
@@ -78,6 +83,7 @@ static meshx_list_t meshx_lower_trans_tx_task_pending;
 typedef struct
 {
     meshx_msg_ctx_t msg_rx_ctx;
+    meshx_pkt_t *ppkt; /* reassembly buffer */
     uint8_t *ppdu;
     uint16_t pdu_len;
     uint16_t max_pdu_len;
@@ -238,11 +244,7 @@ static uint8_t meshx_lower_trans_random(void)
 
 static bool meshx_lower_trans_rpl_check(meshx_rpl_t rpl)
 {
-    if (!meshx_rpl_check(rpl))
-    {
-        return FALSE;
-    }
-    return (MESHX_SUCCESS == meshx_rpl_update(rpl));
+    return meshx_rpl_check_update(rpl);
 }
 
 static void meshx_lower_trans_tx_timeout_handler(void *pargs)
@@ -254,9 +256,15 @@ static void meshx_lower_trans_tx_timeout_handler(void *pargs)
     meshx_async_msg_send(&msg);
 }
 
-static int32_t meshx_lower_trans_send_seg_msg(const uint8_t *ppdu,
-                                              uint16_t pdu_len, uint32_t block_ack, meshx_msg_ctx_t *pmsg_ctx)
+/**
+ * send segments that are neither acknowledged nor sent in current round, sending pauses
+ * when network layer would block and continues from the next segment when it resumes
+ */
+static int32_t meshx_lower_trans_send_seg_msg(meshx_lower_trans_tx_task_t *ptask)
 {
+    const uint8_t *ppdu = ptask->ppdu;
+    uint16_t pdu_len = ptask->pdu_len;
+    meshx_msg_ctx_t *pmsg_ctx = &ptask->msg_tx_ctx;
     uint8_t seg_num;
     if (pmsg_ctx->ctl)
     {
@@ -271,29 +279,8 @@ static int32_t meshx_lower_trans_send_seg_msg(const uint8_t *ppdu,
 
 
     uint8_t seg_len;
+    uint8_t seg_header_len;
     uint16_t data_offset = 0;
-    uint8_t pdu[20];
-
-    if (pmsg_ctx->ctl)
-    {
-        meshx_lower_trans_seg_ctl_pdu_t *pctl_pdu = (meshx_lower_trans_seg_ctl_pdu_t *)pdu;
-        pctl_pdu->metadata.opcode = pmsg_ctx->opcode;
-        pctl_pdu->metadata.seg = 1;
-    }
-    else
-    {
-        meshx_lower_trans_seg_access_pdu_t *paccess_pdu = (meshx_lower_trans_seg_access_pdu_t *)pdu;
-        if (pmsg_ctx->akf)
-        {
-            paccess_pdu->metadata.aid = pmsg_ctx->aid;
-        }
-        else
-        {
-            paccess_pdu->metadata.aid = 0;
-        }
-        paccess_pdu->metadata.akf = pmsg_ctx->akf;
-        paccess_pdu->metadata.seg = 1;
-    }
     for (uint8_t i = 0; i < seg_num; ++i)
     {
         if (pmsg_ctx->ctl)
@@ -307,14 +294,14 @@ static int32_t meshx_lower_trans_send_seg_msg(const uint8_t *ppdu,
                       MESHX_LOWER_TRANS_SEG_ACCESS_MAX_PDU_SIZE;
         }
 
-        if (block_ack & (1 << i))
+        if ((ptask->block_ack | ptask->seg_sent) & (1 << i))
         {
             data_offset += seg_len;
             continue;
         }
 
         /* use sequence */
-        pmsg_ctx->seq = meshx_seq_use(pmsg_ctx->src - meshx_node_params.param.node_addr);
+        pmsg_ctx->seq = meshx_seq_use(MESHX_NODE_ELEMENT_INDEX(pmsg_ctx->src));
 
         /* check sequence */
         if (!MESHX_LOWER_TRANS_IS_SEQ_AUTH_VALID(pmsg_ctx->seq, pmsg_ctx->seq_auth))
@@ -324,10 +311,23 @@ static int32_t meshx_lower_trans_send_seg_msg(const uint8_t *ppdu,
             return -MESHX_ERR_INVAL;
         }
 
-        if (pmsg_ctx->ctl)
+        /* segment is built in packet buffer, network layer adds its header in place */
+        meshx_pkt_t *pseg_pkt = meshx_pkt_alloc(MESHX_PKT_HEADROOM);
+        if (NULL == pseg_pkt)
         {
-            meshx_lower_trans_seg_ctl_pdu_t *pctl_pdu = (meshx_lower_trans_seg_ctl_pdu_t *)pdu;
+            MESHX_ERROR("send segment pdu failed: out of packet buffer");
+            return -MESHX_ERR_MEM;
+        }
 
+        if (pmsg_ctx->ctl)
+        {
+            seg_header_len = sizeof(meshx_lower_trans_ctl_pdu_metadata_t) + sizeof(
+                                 meshx_lower_trans_seg_ctl_misc_t);
+            meshx_lower_trans_seg_ctl_pdu_t *pctl_pdu = (meshx_lower_trans_seg_ctl_pdu_t *)meshx_pkt_put(
+                                                            pseg_pkt, seg_header_len + seg_len);
+            pctl_pdu->metadata.opcode = pmsg_ctx->opcode;
+            pctl_pdu->metadata.seg = 1;
+            pctl_pdu->seg_misc.rfu = 0;
             pctl_pdu->seg_misc.seq_zero = MESHX_LOWER_TRANS_SEQ_ZERO(pmsg_ctx->seq_auth);
             pctl_pdu->seg_misc.sego = i;
             pctl_pdu->seg_misc.segn = seg_num - 1;
@@ -336,8 +336,20 @@ static int32_t meshx_lower_trans_send_seg_msg(const uint8_t *ppdu,
         }
         else
         {
-            meshx_lower_trans_seg_access_pdu_t *paccess_pdu = (meshx_lower_trans_seg_access_pdu_t *)pdu;
-
+            seg_header_len = sizeof(meshx_lower_trans_access_pdu_metadata_t) + sizeof(
+                                 meshx_lower_trans_seg_access_misc_t);
+            meshx_lower_trans_seg_access_pdu_t *paccess_pdu = (meshx_lower_trans_seg_access_pdu_t *)
+                                                              meshx_pkt_put(pseg_pkt, seg_header_len + seg_len);
+            if (pmsg_ctx->akf)
+            {
+                paccess_pdu->metadata.aid = pmsg_ctx->aid;
+            }
+            else
+            {
+                paccess_pdu->metadata.aid = 0;
+            }
+            paccess_pdu->metadata.akf = pmsg_ctx->akf;
+            paccess_pdu->metadata.seg = 1;
             paccess_pdu->seg_misc.szmic = pmsg_ctx->szmic;
             paccess_pdu->seg_misc.seq_zero = MESHX_LOWER_TRANS_SEQ_ZERO(pmsg_ctx->seq_auth);
             paccess_pdu->seg_misc.sego = i;
@@ -347,24 +359,55 @@ static int32_t meshx_lower_trans_send_seg_msg(const uint8_t *ppdu,
         }
 
         data_offset += seg_len;
-        if (pmsg_ctx->ctl)
+        MESHX_INFO("send segment pdu: %d-%d", i, seg_num);
+        MESHX_DUMP_DEBUG(pseg_pkt->pdata, pseg_pkt->len);
+        int32_t ret = meshx_net_send_pkt(pseg_pkt, pmsg_ctx);
+        meshx_pkt_release(pseg_pkt);
+        if (-MESHX_ERR_BUSY != ret)
         {
-            seg_len += (sizeof(meshx_lower_trans_ctl_pdu_metadata_t) + sizeof(
-                            meshx_lower_trans_seg_ctl_misc_t));
+            ptask->seg_sent |= (1 << i);
         }
-        else
+
+        if ((-MESHX_ERR_AGAIN == ret) || (-MESHX_ERR_BUSY == ret))
         {
-            seg_len += (sizeof(meshx_lower_trans_access_pdu_metadata_t) + sizeof(
-                            meshx_lower_trans_seg_access_misc_t));
+            MESHX_DEBUG("pause segment pdu: %d-%d", i, seg_num);
+            ptask->paused = TRUE;
+            break;
         }
-        MESHX_INFO("send segment pdu: %d-%d", i, seg_num);
-        MESHX_DUMP_DEBUG(pdu, seg_len);
-        meshx_net_send(pdu, seg_len, pmsg_ctx);
     }
 
     return MESHX_SUCCESS;
 }
 
+/* start a new round of sending unacknowledged segments */
+static int32_t meshx_lower_trans_send_seg_round(meshx_lower_trans_tx_task_t *ptask)
+{
+    ptask->seg_sent = 0;
+    ptask->paused = FALSE;
+
+    return meshx_lower_trans_send_seg_msg(ptask);
+}
+
+void meshx_lower_trans_tx_resume(void)
+{
+    meshx_list_t *pnode;
+    meshx_lower_trans_tx_task_t *ptask;
+    meshx_list_foreach(pnode, &meshx_lower_trans_tx_task_active)
+    {
+        ptask = MESHX_CONTAINER_OF(pnode, meshx_lower_trans_tx_task_t, node);
+        if (ptask->paused)
+        {
+            ptask->paused = FALSE;
+            meshx_lower_trans_send_seg_msg(ptask);
+            if (ptask->paused)
+            {
+                /* network layer would block again */
+                break;
+            }
+        }
+    }
+}
+
 static void meshx_lower_trans_tx_task_release(meshx_lower_trans_tx_task_t *ptask)
 {
     MESHX_ASSERT(NULL != ptask);
@@ -375,9 +418,10 @@ static void meshx_lower_trans_tx_task_release(meshx_lower_trans_tx_task_t *ptask
         meshx_timer_delete(ptask->retry_timer);
         ptask->retry_timer = NULL;
     }
-    if (NULL != ptask->ppdu)
+    if (NULL != ptask->ppkt)
     {
-        meshx_free(ptask->ppdu);
+        meshx_pkt_release(ptask->ppkt);
+        ptask->ppkt = NULL;
         ptask->ppdu = NULL;
     }
     meshx_list_append(&meshx_lower_trans_tx_task_idle, &ptask->node);
@@ -471,8 +515,7 @@ static void meshx_lower_trans_handle_tx_timeout(meshx_lower_trans_tx_task_t *pta
     else
     {
         /* send segment message */
-        meshx_lower_trans_send_seg_msg(ptask->ppdu, ptask->pdu_len, ptask->block_ack,
-                                       &ptask->msg_tx_ctx);
+        meshx_lower_trans_send_seg_round(ptask);
 
         if (!MESHX_LOWER_TRANS_IS_SEQ_AUTH_VALID(ptask->msg_tx_ctx.seq, ptask->msg_tx_ctx.seq_auth))
         {
@@ -511,8 +554,7 @@ static int32_t meshx_lower_trans_tx_task_run(meshx_lower_trans_tx_task_t *ptx_ta
 
     /* send segment message for the first time */
     int32_t ret;
-    ret = meshx_lower_trans_send_seg_msg(ptx_task->ppdu, ptx_task->pdu_len, ptx_task->block_ack,
-                                         &ptx_task->msg_tx_ctx);
+    ret = meshx_lower_trans_send_seg_round(ptx_task);
     if (MESHX_SUCCESS != ret)
     {
         meshx_lower_trans_tx_task_finish(ptx_task);
@@ -548,7 +590,7 @@ static int32_t meshx_lower_trans_tx_task_try(meshx_lower_trans_tx_task_t *ptx_ta
     return meshx_lower_trans_tx_task_run(ptx_task);
 }
 
-static meshx_lower_trans_tx_task_t *meshx_lower_trans_tx_task_request(uint16_t pdu_len)
+static meshx_lower_trans_tx_task_t *meshx_lower_trans_tx_task_request(meshx_pkt_t *ppkt)
 {
     if (meshx_list_is_empty(&meshx_lower_trans_tx_task_idle))
     {
@@ -558,18 +600,17 @@ static meshx_lower_trans_tx_task_t *meshx_lower_trans_tx_task_request(uint16_t p
     meshx_list_t *pnode = meshx_list_pop(&meshx_lower_trans_tx_task_idle);
     MESHX_ASSERT(NULL != pnode);
     meshx_lower_trans_tx_task_t *ptask =  MESHX_CONTAINER_OF(pnode, meshx_lower_trans_tx_task_t, node);
-    ptask->ppdu = meshx_malloc(pdu_len);
-    if (NULL == ptask->ppdu)
-    {
-        meshx_list_append(&meshx_lower_trans_tx_task_idle, pnode);
-        MESHX_ERROR("request lower transport task failed: out of memory!");
-        return NULL;
-    }
+    /* keep upper transport pdu for retransmit without copy */
+    ptask->ppkt = meshx_pkt_ref(ppkt);
+    ptask->ppdu = ppkt->pdata;
+    ptask->pdu_len = ppkt->len;
 
     MESHX_INFO("request lower trans task(0x%08x)", ptask);
     ptask->retry_times = 0;
     ptask->block_ack = 0;
     ptask->seg_bits = 0;
+    ptask->seg_sent = 0;
+    ptask->paused = FALSE;
 
     return ptask;
 }
@@ -600,10 +641,11 @@ static bool meshx_lower_trans_is_tx_task_exist(const meshx_msg_ctx_t *pmsg_ctx)
     return FALSE;
 }
 
-static int32_t meshx_lower_trans_process_seg_msg(const uint8_t *pupper_trans_pdu,
-                                                 uint16_t pdu_len, uint8_t max_seg_size, const meshx_msg_ctx_t *pmsg_tx_ctx)
+static int32_t meshx_lower_trans_process_seg_msg(meshx_pkt_t *ppkt, uint8_t max_seg_size,
+                                                 const meshx_msg_ctx_t *pmsg_tx_ctx)
 {
     /* segment message */
+    uint16_t pdu_len = ppkt->len;
     uint8_t seg_num = (pdu_len + max_seg_size - 1) / max_seg_size;
     if (seg_num > MESHX_LOWER_TRANS_MAX_SEG_SIZE)
     {
@@ -621,15 +663,13 @@ static int32_t meshx_lower_trans_process_seg_msg(const uint8_t *pupper_trans_pdu
     }
 
     /* store segment message for retransmit */
-    meshx_lower_trans_tx_task_t *ptask = meshx_lower_trans_tx_task_request(pdu_len);
+    meshx_lower_trans_tx_task_t *ptask = meshx_lower_trans_tx_task_request(ppkt);
     if (NULL == ptask)
     {
         MESHX_ERROR("lower transport is busy now, try again later!");
         return -MESHX_ERR_BUSY;
     }
     ptask->msg_tx_ctx = *pmsg_tx_ctx;
-    memcpy(ptask->ppdu, pupper_trans_pdu, pdu_len);
-    ptask->pdu_len = pdu_len;
     for (uint8_t i = 0; i < seg_num; ++i)
     {
         ptask->seg_bits |= (1 << i);
@@ -638,9 +678,9 @@ static int32_t meshx_lower_trans_process_seg_msg(const uint8_t *pupper_trans_pdu
     return meshx_lower_trans_tx_task_try(ptask);
 }
 
-int32_t meshx_lower_trans_send(const uint8_t *pupper_trans_pdu,
-                               uint16_t pdu_len, meshx_msg_ctx_t *pmsg_tx_ctx)
+int32_t meshx_lower_trans_send_pkt(meshx_pkt_t *ppkt, meshx_msg_ctx_t *pmsg_tx_ctx)
 {
+    uint16_t pdu_len = ppkt->len;
 #if MESHX_REDUNDANCY_CHECK
     if (0 == pdu_len)
     {
@@ -663,17 +703,20 @@ int32_t meshx_lower_trans_send(const uint8_t *pupper_trans_pdu,
         {
             pmsg_tx_ctx->seg = 1;
             /* segment message */
-            ret = meshx_lower_trans_process_seg_msg(pupper_trans_pdu, pdu_len,
-                                                    MESHX_LOWER_TRANS_SEG_CTL_MAX_PDU_SIZE, pmsg_tx_ctx);
+            ret = meshx_lower_trans_process_seg_msg(ppkt, MESHX_LOWER_TRANS_SEG_CTL_MAX_PDU_SIZE,
+                                                    pmsg_tx_ctx);
         }
         else
         {
-            meshx_lower_trans_unseg_ctl_pdu_t pdu;
-            pdu.metadata.opcode = pmsg_tx_ctx->opcode;
-            pdu.metadata.seg = 0;
-            memcpy(pdu.pdu, pupper_trans_pdu, pdu_len);
-            ret = meshx_net_send((const uint8_t *)&pdu, sizeof(meshx_lower_trans_ctl_pdu_metadata_t) + pdu_len,
-                                 pmsg_tx_ctx);
+            meshx_lower_trans_ctl_pdu_metadata_t *pmetadata = (meshx_lower_trans_ctl_pdu_metadata_t *)
+                                                              meshx_pkt_push(ppkt, sizeof(meshx_lower_trans_ctl_pdu_metadata_t));
+            if (NULL == pmetadata)
+            {
+                return -MESHX_ERR_LENGTH;
+            }
+            pmetadata->opcode = pmsg_tx_ctx->opcode;
+            pmetadata->seg = 0;
+            ret = meshx_net_send_pkt(ppkt, pmsg_tx_ctx);
         }
     }
     else
@@ -683,34 +726,65 @@ int32_t meshx_lower_trans_send(const uint8_t *pupper_trans_pdu,
         {
             pmsg_tx_ctx->seg = 1;
             /* segment message */
-            ret = meshx_lower_trans_process_seg_msg(pupper_trans_pdu, pdu_len,
-                                                    MESHX_LOWER_TRANS_SEG_ACCESS_MAX_PDU_SIZE, pmsg_tx_ctx);
+            ret = meshx_lower_trans_process_seg_msg(ppkt, MESHX_LOWER_TRANS_SEG_ACCESS_MAX_PDU_SIZE,
+                                                    pmsg_tx_ctx);
         }
         else
         {
             /* unsegment message */
-            meshx_lower_trans_unseg_access_pdu_t pdu;
+            meshx_lower_trans_access_pdu_metadata_t *pmetadata = (meshx_lower_trans_access_pdu_metadata_t *)
+                                                                 meshx_pkt_push(ppkt, sizeof(meshx_lower_trans_access_pdu_metadata_t));
+            if (NULL == pmetadata)
+            {
+                return -MESHX_ERR_LENGTH;
+            }
             if (pmsg_tx_ctx->akf)
             {
-                pdu.metadata.aid = pmsg_tx_ctx->aid;
+                pmetadata->aid = pmsg_tx_ctx->aid;
             }
             else
             {
-                pdu.metadata.aid = 0;
+                pmetadata->aid = 0;
             }
-            pdu.metadata.akf = pmsg_tx_ctx->akf;
-            pdu.metadata.seg = 0;
-            memcpy(pdu.pdu, pupper_trans_pdu, pdu_len);
-            ret = meshx_net_send((const uint8_t *)&pdu,
-                                 sizeof(meshx_lower_trans_access_pdu_metadata_t) + pdu_len, pmsg_tx_ctx);
+            pmetadata->akf = pmsg_tx_ctx->akf;
+            pmetadata->seg = 0;
+            ret = meshx_net_send_pkt(ppkt, pmsg_tx_ctx);
         }
     }
 
     return ret;
 }
 
+int32_t meshx_lower_trans_send(const uint8_t *pupper_trans_pdu,
+                               uint16_t pdu_len, meshx_msg_ctx_t *pmsg_tx_ctx)
+{
+    meshx_pkt_t *ppkt = meshx_pkt_alloc(MESHX_PKT_HEADROOM);
+    if (NULL == ppkt)
+    {
+        MESHX_ERROR("send lower transport pdu failed: out of packet buffer");
+        return -MESHX_ERR_MEM;
+    }
+
+    int32_t ret = -MESHX_ERR_LENGTH;
+    uint8_t *pdata = meshx_pkt_put(ppkt, pdu_len);
+    if (NULL != pdata)
+    {
+        memcpy(pdata, pupper_trans_pdu, pdu_len);
+        ret = meshx_lower_trans_send_pkt(ppkt, pmsg_tx_ctx);
+    }
+    meshx_pkt_release(ppkt);
+
+    return ret;
+}
+
 static int32_t meshx_lower_trans_seg_ack(uint32_t block_ack, const meshx_msg_ctx_t *pmsg_rx_ctx)
 {
+    if (!MESHX_ADDRESS_IS_UNICAST(pmsg_rx_ctx->dst))
+    {
+        /* segments sent to group or virtual address are not acknowledged */
+        return MESHX_SUCCESS;
+    }
+
     meshx_lower_trans_seg_ack_pdu_t seg_ack;
     seg_ack.rfu = 0;
     seg_ack.seq_zero = MESHX_LOWER_TRANS_SEQ_ZERO(pmsg_rx_ctx->seq_auth);
@@ -728,7 +802,7 @@ static int32_t meshx_lower_trans_seg_ack(uint32_t block_ack, const meshx_msg_ctx
     msg_tx_ctx.iv_index = meshx_iv_index_tx_get();
     msg_tx_ctx.pnet_key = pmsg_rx_ctx->pnet_key;
     msg_tx_ctx.opcode = 0;
-    msg_tx_ctx.seq = meshx_seq_use(msg_tx_ctx.src - meshx_node_params.param.node_addr);
+    msg_tx_ctx.seq = meshx_seq_use(MESHX_NODE_ELEMENT_INDEX(msg_tx_ctx.src));
 
     MESHX_INFO("lower transport block ack: 0x%08x", block_ack);
     return meshx_lower_trans_send((const uint8_t *)&seg_ack,
@@ -753,9 +827,10 @@ static void meshx_lower_trans_rx_task_release(meshx_lower_trans_rx_task_t *ptask
         ptask->incomplete_timer = NULL;
     }
 
-    if (NULL != ptask->ppdu)
+    if (NULL != ptask->ppkt)
     {
-        meshx_free(ptask->ppdu);
+        meshx_pkt_release(ptask->ppkt);
+        ptask->ppkt = NULL;
         ptask->ppdu = NULL;
     }
     meshx_list_append(&meshx_lower_trans_rx_task_idle, &ptask->node);
@@ -817,9 +892,10 @@ static meshx_lower_trans_rx_task_t *meshx_lower_trans_rx_task_request(uint16_t m
                                                                  prx_task->msg_rx_ctx.seq_auth);
             if (seq_auth_rx > seq_auth_store)
             {
-                if (NULL != prx_task->ppdu)
+                if (NULL != prx_task->ppkt)
                 {
-                    meshx_free(prx_task->ppdu);
+                    meshx_pkt_release(prx_task->ppkt);
+                    prx_task->ppkt = NULL;
                     prx_task->ppdu = NULL;
                 }
                 if (0 != prx_task->not_received_seg)
@@ -873,15 +949,21 @@ NEW_SEG_MSG:
         return NULL;
     }
 
-    prx_task->ppdu = meshx_malloc(max_pdu_len);
-    if (NULL == prx_task->ppdu)
+    prx_task->ppkt = meshx_pkt_alloc(0);
+    if ((NULL != prx_task->ppkt) && (NULL == meshx_pkt_put(prx_task->ppkt, max_pdu_len)))
+    {
+        meshx_pkt_release(prx_task->ppkt);
+        prx_task->ppkt = NULL;
+    }
+    if (NULL == prx_task->ppkt)
     {
         meshx_timer_delete(prx_task->ack_timer);
         meshx_timer_delete(prx_task->incomplete_timer);
         meshx_list_append(&meshx_lower_trans_rx_task_idle, pnode);
-        MESHX_ERROR("request rx task failed: out of memory!");
+        MESHX_ERROR("request rx task failed: out of packet buffer!");
         return NULL;
     }
+    prx_task->ppdu = prx_task->ppkt->pdata;
     prx_task->max_pdu_len = max_pdu_len;
 
     prx_task->msg_rx_ctx = *pmsg_rx_ctx;
@@ -962,8 +1044,7 @@ static void meshx_lower_trans_recv_block_ack(const meshx_lower_trans_seg_ack_pdu
                 else
                 {
                     pcur_task->block_ack = seg_ack.block_ack;
-                    meshx_lower_trans_send_seg_msg(pcur_task->ppdu, pcur_task->pdu_len, pcur_task->block_ack,
-                                                   &pcur_task->msg_tx_ctx);
+                    meshx_lower_trans_send_seg_round(pcur_task);
                     if (!MESHX_LOWER_TRANS_IS_SEQ_AUTH_VALID(pcur_task->msg_tx_ctx.seq,
                                                              pcur_task->msg_tx_ctx.seq_auth))
                     {
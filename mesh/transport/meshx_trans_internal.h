@@ -16,6 +16,8 @@ MESHX_EXTERN void meshx_lower_trans_async_handle_tx_timeout(meshx_async_msg_t ms
 MESHX_EXTERN void meshx_lower_trans_async_handle_rx_ack_timeout(meshx_async_msg_t msg);
 MESHX_EXTERN void meshx_lower_trans_async_handle_rx_incomplete_timeout(meshx_async_msg_t msg);
 MESHX_EXTERN bool meshx_is_lower_trans_busy(void);
+/* network interface is writable again, continue paused segments */
+MESHX_EXTERN void meshx_lower_trans_tx_resume(void);
 
 MESHX_END_DECLS
 
@@ -18,6 +18,10 @@
 #include "meshx_access.h"
 #include "meshx_mem.h"
 #include "meshx_seq.h"
+#include "meshx_sub.h"
+#include "meshx_pkt.h"
+#include "meshx_config.h"
+#include "meshx_df.h"
 
 #define MESHX_UNSEG_ACCESS_MAX_PDU_SIZE                    15
 #define MESHX_MAX_CTL_PDU_SIZE                             256
@@ -67,20 +71,23 @@ static void meshx_upper_trans_encrypt(uint8_t *paccess_pdu, uint8_t pdu_len,
     uint8_t *padd = NULL;
     uint8_t add_len = 0;
 
-    const meshx_key_t *pencrypt_key = pmsg_tx_ctx->akf ? pmsg_tx_ctx->papp_key :
-                                      pmsg_tx_ctx->pdev_key;
+    const meshx_aes128_ctx_t *pencrypt_key = pmsg_tx_ctx->akf ? &pmsg_tx_ctx->papp_key->app_key_ctx :
+                                             &pmsg_tx_ctx->pdev_key->dev_key_ctx;
     /* encrypt data */
-    meshx_aes_ccm_encrypt(*pencrypt_key, nonce, MESHX_NONCE_SIZE,
-                          padd, add_len, paccess_pdu, pdu_len, paccess_pdu, ptrans_mic, trans_mic_len);
+    meshx_aes_ccm_ctx_encrypt(pencrypt_key, nonce, MESHX_NONCE_SIZE,
+                              padd, add_len, paccess_pdu, pdu_len, paccess_pdu, ptrans_mic, trans_mic_len);
     MESHX_DEBUG("encrypt access pdu:");
     MESHX_DUMP_DEBUG(paccess_pdu, pdu_len);
     MESHX_DEBUG("access pdu transmic:");
     MESHX_DUMP_DEBUG(ptrans_mic, trans_mic_len);
 }
 
-static int32_t meshx_upper_trans_decrypt(uint8_t *paccess_pdu, uint8_t pdu_len,
-                                         uint8_t *ptrans_mic, uint8_t trans_mic_len,
-                                         meshx_msg_ctx_t *pmsg_rx_ctx)
+/**
+ * decrypt access pdu into pplain_pdu, cipher text is kept for trying other candidate keys
+ */
+static int32_t meshx_upper_trans_decrypt(const uint8_t *paccess_pdu, uint8_t pdu_len,
+                                         const uint8_t *ptrans_mic, uint8_t trans_mic_len,
+                                         uint8_t *pplain_pdu, meshx_msg_ctx_t *pmsg_rx_ctx)
 {
     int32_t ret = MESHX_SUCCESS;
     uint8_t nonce[MESHX_NONCE_SIZE];
@@ -100,47 +107,54 @@ static int32_t meshx_upper_trans_decrypt(uint8_t *paccess_pdu, uint8_t pdu_len,
         MESHX_DEBUG("application nonce:");
         MESHX_DUMP_DEBUG(papp_nonce, sizeof(meshx_app_nonce_t));
 
-        /* get app key */
+        /* get app key, label uuid is used as additional data of virtual address */
         int32_t ret = MESHX_SUCCESS;
-        /* TODO: label uuid */
-        uint8_t *padd = NULL;
+        const uint8_t *padd = NULL;
         uint8_t add_len = 0;
-        meshx_app_key_t *papp_key = NULL;
-        meshx_app_key_traverse_start(&papp_key);
-        while (NULL != papp_key)
+        bool is_virtual = MESHX_ADDRESS_IS_VIRTUAL(pmsg_rx_ctx->dst);
+        if (is_virtual)
         {
-            uint8_t loop = 1;
-            if ((MESHX_KEY_STATE_PHASE1 == papp_key->key_state) ||
-                (MESHX_KEY_STATE_PHASE2 == papp_key->key_state))
+            meshx_sub_label_traverse_start(pmsg_rx_ctx->dst, &padd);
+            if (NULL == padd)
             {
-                loop = 2;
+                MESHX_WARN("no label uuid matches virtual address 0x%04x", pmsg_rx_ctx->dst);
+                return -MESHX_ERR_NOT_FOUND;
             }
+            add_len = 16;
+        }
 
-            for (uint8_t i = 0; i < loop; ++i)
+        const meshx_app_key_value_t *papp_key = NULL;
+        do
+        {
+            meshx_app_key_aid_traverse_start(pmsg_rx_ctx->aid, pmsg_rx_ctx->pnet_key, &papp_key);
+            while (NULL != papp_key)
             {
-                if (papp_key->key_value[i].aid == pmsg_rx_ctx->aid)
+                ret = meshx_aes_ccm_ctx_decrypt(&papp_key->app_key_ctx, nonce, MESHX_NONCE_SIZE, padd,
+                                                add_len, paccess_pdu, pdu_len, pplain_pdu, ptrans_mic,
+                                                trans_mic_len);
+                if (MESHX_SUCCESS == ret)
                 {
-                    ret = meshx_aes_ccm_decrypt(papp_key->key_value[i].app_key, nonce, MESHX_NONCE_SIZE,
-                                                padd, add_len, paccess_pdu, pdu_len, paccess_pdu, ptrans_mic, trans_mic_len);
-                    if (MESHX_SUCCESS == ret)
-                    {
-                        pmsg_rx_ctx->papp_key = &papp_key->key_value[i].app_key;
-                        goto FINISH;
-                    }
+                    pmsg_rx_ctx->papp_key = papp_key;
+                    break;
                 }
+
+                meshx_app_key_aid_traverse_continue(pmsg_rx_ctx->aid, pmsg_rx_ctx->pnet_key, &papp_key);
             }
 
-            meshx_app_key_traverse_continue(&papp_key);
-        }
+            if ((NULL != papp_key) || !is_virtual)
+            {
+                break;
+            }
+            meshx_sub_label_traverse_continue(pmsg_rx_ctx->dst, &padd);
+        } while (NULL != padd);
 
-FINISH:
         if (NULL == papp_key)
         {
             MESHX_WARN("can't decrypt pdu by application key that aid is 0x%x", pmsg_rx_ctx->aid);
             return -MESHX_ERR_KEY;
         }
         MESHX_DEBUG("decrypt access pdu:");
-        MESHX_DUMP_DEBUG(paccess_pdu, pdu_len);
+        MESHX_DUMP_DEBUG(pplain_pdu, pdu_len);
     }
     else
     {
@@ -169,13 +183,13 @@ FINISH:
             MESHX_ERROR("device key is invalid!");
             return -MESHX_ERR_KEY;
         }
-        pmsg_rx_ctx->pdev_key = &pdev_key->dev_key;
-        ret = meshx_aes_ccm_decrypt(*pmsg_rx_ctx->pdev_key, nonce, MESHX_NONCE_SIZE,
-                                    padd, add_len, paccess_pdu, pdu_len, paccess_pdu, ptrans_mic, trans_mic_len);
+        pmsg_rx_ctx->pdev_key = pdev_key;
+        ret = meshx_aes_ccm_ctx_decrypt(&pdev_key->dev_key_ctx, nonce, MESHX_NONCE_SIZE,
+                                        padd, add_len, paccess_pdu, pdu_len, pplain_pdu, ptrans_mic, trans_mic_len);
         if (MESHX_SUCCESS == ret)
         {
             MESHX_DEBUG("decrypt access pdu:");
-            MESHX_DUMP_DEBUG(paccess_pdu, pdu_len);
+            MESHX_DUMP_DEBUG(pplain_pdu, pdu_len);
         }
     }
 
@@ -218,16 +232,26 @@ int32_t meshx_upper_trans_send(const uint8_t *pdata, uint16_t len,
             trans_mic_len = 8;
         }
 
-        uint8_t *ppdu = meshx_malloc(len + trans_mic_len);
-        if (NULL == ppdu)
+        /* access pdu is the only copy, it is encrypted in place and lower layers add headers */
+        meshx_pkt_t *ppkt = meshx_pkt_alloc(MESHX_PKT_HEADROOM);
+        if (NULL == ppkt)
         {
             MESHX_ERROR("allocate access pdu data failed!");
             return -MESHX_ERR_MEM;
         }
+        uint8_t *ppdu = meshx_pkt_put(ppkt, len + trans_mic_len);
+        if (NULL == ppdu)
+        {
+            meshx_pkt_release(ppkt);
+            return -MESHX_ERR_LENGTH;
+        }
         memcpy(ppdu, pdata, len);
 
+        /* path request goes ahead of the message */
+        meshx_df_path_check(pmsg_tx_ctx);
+
         /* allocate sequence */
-        pmsg_tx_ctx->seq = meshx_seq_use(pmsg_tx_ctx->src - meshx_node_params.param.node_addr);
+        pmsg_tx_ctx->seq = meshx_seq_use(MESHX_NODE_ELEMENT_INDEX(pmsg_tx_ctx->src));
         pmsg_tx_ctx->seq_auth = pmsg_tx_ctx->seq;
 
         MESHX_INFO("access message: src 0x%04x, dst 0x%04x, ttl %d, seq auth 0x%06x, iv index 0x%08x, seg %d, akf %d, nid %d, aid %d",
@@ -239,8 +263,8 @@ int32_t meshx_upper_trans_send(const uint8_t *pdata, uint16_t len,
         /* encrypt and authenticate access pdu */
         meshx_upper_trans_encrypt(ppdu, len, ppdu + len, trans_mic_len, pmsg_tx_ctx);
 
-        ret = meshx_lower_trans_send(ppdu, len + trans_mic_len, pmsg_tx_ctx);
-        meshx_free(ppdu);
+        ret = meshx_lower_trans_send_pkt(ppkt, pmsg_tx_ctx);
+        meshx_pkt_release(ppkt);
     }
 
     return ret;
@@ -256,6 +280,14 @@ int32_t meshx_upper_trans_receive(uint8_t *pdata,
     if (pmsg_rx_ctx->ctl)
     {
         /* receive control message */
+        if (MESHX_DF_OPCODE_IS_VALID(pmsg_rx_ctx->opcode))
+        {
+            ret = meshx_df_receive(pdata, len, pmsg_rx_ctx);
+        }
+        else
+        {
+            MESHX_WARN("unsupported control message: opcode 0x%02x", pmsg_rx_ctx->opcode);
+        }
     }
     else
     {
@@ -267,12 +299,14 @@ int32_t meshx_upper_trans_receive(uint8_t *pdata,
             trans_mic_len = 8;
         }
 
+        /* ccm output is the only copy on receive path */
+        uint8_t plain_pdu[UINT8_MAX];
         ret = meshx_upper_trans_decrypt(pdata, len - trans_mic_len, pdata + len - trans_mic_len,
-                                        trans_mic_len, pmsg_rx_ctx);
+                                        trans_mic_len, plain_pdu, pmsg_rx_ctx);
         if (MESHX_SUCCESS == ret)
         {
             /* notify access layer */
-            ret = meshx_access_receive(pdata, len - trans_mic_len, pmsg_rx_ctx);
+            ret = meshx_access_receive(plain_pdu, len - trans_mic_len, pmsg_rx_ctx);
         }
         else
         {
@@ -9,11 +9,18 @@
 #include "meshx.h"
 #include "meshx_bearer_internal.h"
 #include "meshx_node_internal.h"
+#include "meshx_security.h"
+#include "meshx_crypto_worker.h"
+#include "meshx_pkt.h"
+#include "meshx_sub.h"
+#include "meshx_df.h"
 
 int32_t meshx_init(void)
 {
-    /* TODO: set to actual element number */
-    meshx_seq_init(1);
+    meshx_security_init();
+    meshx_crypto_worker_init(meshx_node_params.config.crypto_worker_num);
+    meshx_pkt_init(meshx_node_params.config.pkt_num, meshx_node_params.config.pkt_size);
+    meshx_seq_init(meshx_node_params.config.element_num);
     meshx_rpl_init();
     meshx_nmc_init();
     meshx_iv_index_init();
@@ -21,6 +28,7 @@ int32_t meshx_init(void)
     meshx_app_key_init();
     meshx_net_key_init();
     meshx_dev_key_init();
+    meshx_sub_init();
 
     meshx_bearer_init();
     if (meshx_node_params.config.adv_bearer_enable)
@@ -28,6 +36,7 @@ int32_t meshx_init(void)
         meshx_gap_init(meshx_node_params.config.gap_task_num);
     }
     meshx_net_init();
+    meshx_df_init();
     meshx_lower_trans_init();
     meshx_upper_trans_init();
     meshx_access_init();
@@ -29,6 +29,7 @@
 #include "meshx_sample_data.h"
 #include "meshx_rpl.h"
 #include "meshx_nmc.h"
+#include "meshx_df.h"
 #include "meshx_seq.h"
 #include "meshx_iv_index.h"
 #include "meshx_key.h"
@@ -0,0 +1,104 @@
+/**
+ * This file is part of the meshx library.
+ *
+ * Copyright 2019, Huang Yang <elious.huang@gmail.com>. All rights reserved.
+ *
+ * See the LICENSE file for the terms of usage and distribution.
+ */
+#include <pthread.h>
+#define MESHX_TRACE_MODULE "MESHX_CRYPTO_WORKER"
+#include "meshx_trace.h"
+#include "meshx_crypto_worker.h"
+#include "meshx_errno.h"
+#include "meshx_list.h"
+#include "meshx_mem.h"
+
+typedef struct
+{
+    meshx_crypto_work_t work;
+    void *pargs;
+    meshx_list_t node;
+} meshx_crypto_work_item_t;
+
+static pthread_mutex_t crypto_work_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t crypto_work_cond = PTHREAD_COND_INITIALIZER;
+static meshx_list_t crypto_work_list;
+static uint8_t crypto_worker_num;
+static bool crypto_worker_inited;
+
+static void *meshx_crypto_worker_thread(void *pargs)
+{
+    for (;;)
+    {
+        pthread_mutex_lock(&crypto_work_mutex);
+        while (meshx_list_is_empty(&crypto_work_list))
+        {
+            pthread_cond_wait(&crypto_work_cond, &crypto_work_mutex);
+        }
+        meshx_list_t *pnode = meshx_list_pop(&crypto_work_list);
+        pthread_mutex_unlock(&crypto_work_mutex);
+
+        meshx_crypto_work_item_t *pitem = MESHX_CONTAINER_OF(pnode, meshx_crypto_work_item_t, node);
+        pitem->work(pitem->pargs);
+        meshx_free(pitem);
+    }
+
+    return NULL;
+}
+
+int32_t meshx_crypto_worker_init(uint8_t worker_num)
+{
+    if (crypto_worker_inited)
+    {
+        MESHX_WARN("crypto worker has already been initialized");
+        return -MESHX_ERR_ALREADY;
+    }
+
+    meshx_list_init_head(&crypto_work_list);
+    for (uint8_t i = 0; i < worker_num; ++i)
+    {
+        pthread_t tid;
+        if (0 != pthread_create(&tid, NULL, meshx_crypto_worker_thread, NULL))
+        {
+            MESHX_ERROR("create crypto worker %d failed", i);
+            break;
+        }
+        pthread_detach(tid);
+        crypto_worker_num ++;
+    }
+    crypto_worker_inited = TRUE;
+    MESHX_INFO("crypto worker number: %d", crypto_worker_num);
+
+    return (crypto_worker_num == worker_num) ? MESHX_SUCCESS : -MESHX_ERR_RESOURCE;
+}
+
+int32_t meshx_crypto_worker_submit(meshx_crypto_work_t work, void *pargs)
+{
+    if (NULL == work)
+    {
+        MESHX_ERROR("invalid crypto work");
+        return -MESHX_ERR_INVAL;
+    }
+
+    if (0 == crypto_worker_num)
+    {
+        work(pargs);
+        return MESHX_SUCCESS;
+    }
+
+    meshx_crypto_work_item_t *pitem = meshx_malloc(sizeof(meshx_crypto_work_item_t));
+    if (NULL == pitem)
+    {
+        MESHX_ERROR("submit crypto work failed: out of memory");
+        return -MESHX_ERR_MEM;
+    }
+    pitem->work = work;
+    pitem->pargs = pargs;
+
+    pthread_mutex_lock(&crypto_work_mutex);
+    meshx_list_append(&crypto_work_list, &pitem->node);
+    pthread_cond_signal(&crypto_work_cond);
+    pthread_mutex_unlock(&crypto_work_mutex);
+
+    return MESHX_SUCCESS;
+}
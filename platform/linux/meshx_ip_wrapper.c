@@ -0,0 +1,184 @@
+/**
+ * This file is part of the meshx library.
+ *
+ * Copyright 2019, Huang Yang <elious.huang@gmail.com>. All rights reserved.
+ *
+ * See the LICENSE file for the terms of usage and distribution.
+ */
+#define _GNU_SOURCE
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#define MESHX_TRACE_MODULE "MESHX_IP_WRAPPER"
+#include "meshx_trace.h"
+#include "meshx_ip_wrapper.h"
+#include "meshx_errno.h"
+
+/* datagrams passed to kernel in one system call */
+#define MESHX_IP_MMSG_MAX                  16
+
+typedef union
+{
+    struct sockaddr sa;
+    struct sockaddr_in sin;
+    struct sockaddr_un sun;
+} meshx_ip_sockaddr_t;
+
+static socklen_t meshx_ip_addr_to_sockaddr(const meshx_ip_addr_t *paddr,
+                                           meshx_ip_sockaddr_t *psockaddr)
+{
+    memset(psockaddr, 0, sizeof(meshx_ip_sockaddr_t));
+    if (MESHX_IP_FAMILY_UNIX == paddr->family)
+    {
+        psockaddr->sun.sun_family = AF_UNIX;
+        strncpy(psockaddr->sun.sun_path, paddr->path, sizeof(psockaddr->sun.sun_path) - 1);
+        return sizeof(struct sockaddr_un);
+    }
+
+    psockaddr->sin.sin_family = AF_INET;
+    psockaddr->sin.sin_port = htons(paddr->port);
+    memcpy(&psockaddr->sin.sin_addr.s_addr, paddr->ipv4, 4);
+    return sizeof(struct sockaddr_in);
+}
+
+static void meshx_ip_sockaddr_to_addr(const meshx_ip_sockaddr_t *psockaddr,
+                                      meshx_ip_addr_t *paddr)
+{
+    memset(paddr, 0, sizeof(meshx_ip_addr_t));
+    if (AF_UNIX == psockaddr->sa.sa_family)
+    {
+        paddr->family = MESHX_IP_FAMILY_UNIX;
+        strncpy(paddr->path, psockaddr->sun.sun_path, MESHX_IP_UNIX_PATH_MAX_LEN - 1);
+    }
+    else
+    {
+        paddr->family = MESHX_IP_FAMILY_UDP;
+        paddr->port = ntohs(psockaddr->sin.sin_port);
+        memcpy(paddr->ipv4, &psockaddr->sin.sin_addr.s_addr, 4);
+    }
+}
+
+int32_t meshx_ip_open(const meshx_ip_addr_t *plocal, int32_t *phandle)
+{
+    int domain = (MESHX_IP_FAMILY_UNIX == plocal->family) ? AF_UNIX : AF_INET;
+    int fd = socket(domain, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+    {
+        MESHX_ERROR("create socket failed: %d", errno);
+        return -MESHX_ERR_FAIL;
+    }
+
+    meshx_ip_sockaddr_t sockaddr;
+    socklen_t socklen = meshx_ip_addr_to_sockaddr(plocal, &sockaddr);
+    if (AF_UNIX == domain)
+    {
+        /* remove socket file left by previous process */
+        unlink(sockaddr.sun.sun_path);
+    }
+
+    if (bind(fd, &sockaddr.sa, socklen) < 0)
+    {
+        MESHX_ERROR("bind socket failed: %d", errno);
+        close(fd);
+        return -MESHX_ERR_FAIL;
+    }
+
+    *phandle = fd;
+    return MESHX_SUCCESS;
+}
+
+void meshx_ip_close(int32_t handle)
+{
+    close(handle);
+}
+
+int32_t meshx_ip_send_batch(int32_t handle, const meshx_ip_datagram_t *pdatagrams, uint16_t num)
+{
+    struct mmsghdr msgs[MESHX_IP_MMSG_MAX];
+    struct iovec iovs[MESHX_IP_MMSG_MAX];
+    meshx_ip_sockaddr_t sockaddrs[MESHX_IP_MMSG_MAX];
+    int32_t sent = 0;
+
+    while (sent < num)
+    {
+        uint16_t cnt = num - sent;
+        if (cnt > MESHX_IP_MMSG_MAX)
+        {
+            cnt = MESHX_IP_MMSG_MAX;
+        }
+
+        memset(msgs, 0, cnt * sizeof(struct mmsghdr));
+        for (uint16_t i = 0; i < cnt; ++i)
+        {
+            const meshx_ip_datagram_t *pdatagram = &pdatagrams[sent + i];
+            iovs[i].iov_base = pdatagram->pdata;
+            iovs[i].iov_len = pdatagram->len;
+            msgs[i].msg_hdr.msg_iov = &iovs[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+            msgs[i].msg_hdr.msg_name = &sockaddrs[i];
+            msgs[i].msg_hdr.msg_namelen = meshx_ip_addr_to_sockaddr(&pdatagram->addr, &sockaddrs[i]);
+        }
+
+        int ret = sendmmsg(handle, msgs, cnt, 0);
+        if (ret < 0)
+        {
+            if ((EAGAIN == errno) || (EWOULDBLOCK == errno) || (ENOBUFS == errno))
+            {
+                return (0 == sent) ? -MESHX_ERR_BUSY : sent;
+            }
+
+            /* skip datagram that can't be delivered, such as unix peer doesn't exist */
+            MESHX_DEBUG("send datagram failed: %d", errno);
+            ret = 1;
+        }
+        sent += ret;
+    }
+
+    return sent;
+}
+
+int32_t meshx_ip_receive_batch(int32_t handle, meshx_ip_datagram_t *pdatagrams, uint16_t num)
+{
+    struct mmsghdr msgs[MESHX_IP_MMSG_MAX];
+    struct iovec iovs[MESHX_IP_MMSG_MAX];
+    meshx_ip_sockaddr_t sockaddrs[MESHX_IP_MMSG_MAX];
+
+    if (num > MESHX_IP_MMSG_MAX)
+    {
+        num = MESHX_IP_MMSG_MAX;
+    }
+
+    memset(msgs, 0, num * sizeof(struct mmsghdr));
+    for (uint16_t i = 0; i < num; ++i)
+    {
+        iovs[i].iov_base = pdatagrams[i].pdata;
+        iovs[i].iov_len = pdatagrams[i].len;
+        msgs[i].msg_hdr.msg_iov = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+        msgs[i].msg_hdr.msg_name = &sockaddrs[i];
+        msgs[i].msg_hdr.msg_namelen = sizeof(meshx_ip_sockaddr_t);
+    }
+
+    int ret = recvmmsg(handle, msgs, num, MSG_DONTWAIT, NULL);
+    if (ret < 0)
+    {
+        if ((EAGAIN == errno) || (EWOULDBLOCK == errno))
+        {
+            return 0;
+        }
+        MESHX_ERROR("receive datagram failed: %d", errno);
+        return -MESHX_ERR_FAIL;
+    }
+
+    for (int i = 0; i < ret; ++i)
+    {
+        pdatagrams[i].len = msgs[i].msg_len;
+        meshx_ip_sockaddr_to_addr(&sockaddrs[i], &pdatagrams[i].addr);
+    }
+
+    return ret;
+}
@@ -14,6 +14,17 @@ void *meshx_malloc(size_t size)
     return malloc(size);
 }
 
+void *meshx_malloc_aligned(size_t alignment, size_t size)
+{
+    void *ptr = NULL;
+    if (0 != posix_memalign(&ptr, alignment, size))
+    {
+        return NULL;
+    }
+
+    return ptr;
+}
+
 void meshx_free(void *ptr)
 {
     free(ptr);
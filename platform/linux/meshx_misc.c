@@ -6,6 +6,7 @@
  * See the LICENSE file for the terms of usage and distribution.
  */
 #include <stdlib.h>
+#include <time.h>
 #include "meshx_misc.h"
 
 void meshx_srand(uint32_t seed)
@@ -18,3 +19,9 @@ int32_t meshx_rand(void)
     return rand();
 }
 
+uint32_t meshx_time_get(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
@@ -0,0 +1,186 @@
+/**
+ * This file is part of the meshx library.
+ *
+ * Copyright 2019, Huang Yang <elious.huang@gmail.com>. All rights reserved.
+ *
+ * See the COPYING file for the terms of usage and distribution.
+ */
+#include "meshx_security_aesni.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <wmmintrin.h>
+
+#define MESHX_AESNI_TARGET      __attribute__((target("aes,sse2")))
+
+/* 11 round keys are stored at the head of the context */
+typedef char meshx_aesni_ctx_size_check[(11 * sizeof(__m128i) <= sizeof(
+                                             meshx_aes128_ctx_t)) ? 1 : -1];
+
+bool meshx_aesni_is_supported(void)
+{
+    unsigned int eax, ebx, ecx, edx;
+    if (0 == __get_cpuid(1, &eax, &ebx, &ecx, &edx))
+    {
+        return FALSE;
+    }
+
+    return ((ecx & bit_AES) && (edx & bit_SSE2));
+}
+
+static MESHX_AESNI_TARGET __m128i meshx_aesni_key_assist(__m128i key, __m128i assist)
+{
+    assist = _mm_shuffle_epi32(assist, _MM_SHUFFLE(3, 3, 3, 3));
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    return _mm_xor_si128(key, assist);
+}
+
+/* aeskeygenassist needs the round constant as an immediate value */
+#define MESHX_AESNI_EXPAND(round, rcon) \
+    prk[round] = meshx_aesni_key_assist(prk[round - 1], \
+                                        _mm_aeskeygenassist_si128(prk[round - 1], rcon))
+
+MESHX_AESNI_TARGET void meshx_aesni_key_expand(meshx_aes128_ctx_t *pctx, const uint8_t key[16])
+{
+    __m128i prk[11];
+    prk[0] = _mm_loadu_si128((const __m128i *)key);
+    MESHX_AESNI_EXPAND(1, 0x01);
+    MESHX_AESNI_EXPAND(2, 0x02);
+    MESHX_AESNI_EXPAND(3, 0x04);
+    MESHX_AESNI_EXPAND(4, 0x08);
+    MESHX_AESNI_EXPAND(5, 0x10);
+    MESHX_AESNI_EXPAND(6, 0x20);
+    MESHX_AESNI_EXPAND(7, 0x40);
+    MESHX_AESNI_EXPAND(8, 0x80);
+    MESHX_AESNI_EXPAND(9, 0x1b);
+    MESHX_AESNI_EXPAND(10, 0x36);
+
+    __m128i *pdst = (__m128i *)pctx->data;
+    for (uint8_t i = 0; i < 11; ++i)
+    {
+        _mm_storeu_si128(pdst + i, prk[i]);
+    }
+}
+
+MESHX_AESNI_TARGET void meshx_aesni_encrypt(const meshx_aes128_ctx_t *pctx,
+                                            const uint8_t input[16], uint8_t output[16])
+{
+    const __m128i *prk = (const __m128i *)pctx->data;
+    __m128i block = _mm_loadu_si128((const __m128i *)input);
+    block = _mm_xor_si128(block, _mm_loadu_si128(prk));
+    for (uint8_t i = 1; i < 10; ++i)
+    {
+        block = _mm_aesenc_si128(block, _mm_loadu_si128(prk + i));
+    }
+    block = _mm_aesenclast_si128(block, _mm_loadu_si128(prk + 10));
+    _mm_storeu_si128((__m128i *)output, block);
+}
+
+/* two independent blocks share the rounds, so the aesenc latency of one hides the other */
+MESHX_AESNI_TARGET void meshx_aesni_encrypt2(const meshx_aes128_ctx_t *pctx,
+                                             const uint8_t input0[16], uint8_t output0[16],
+                                             const uint8_t input1[16], uint8_t output1[16])
+{
+    const __m128i *prk = (const __m128i *)pctx->data;
+    __m128i rk = _mm_loadu_si128(prk);
+    __m128i block0 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)input0), rk);
+    __m128i block1 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)input1), rk);
+    for (uint8_t i = 1; i < 10; ++i)
+    {
+        rk = _mm_loadu_si128(prk + i);
+        block0 = _mm_aesenc_si128(block0, rk);
+        block1 = _mm_aesenc_si128(block1, rk);
+    }
+    rk = _mm_loadu_si128(prk + 10);
+    _mm_storeu_si128((__m128i *)output0, _mm_aesenclast_si128(block0, rk));
+    _mm_storeu_si128((__m128i *)output1, _mm_aesenclast_si128(block1, rk));
+}
+
+/* four blocks with different keys go through the rounds together */
+MESHX_AESNI_TARGET void meshx_aesni_encrypt_multi(const meshx_aes128_ctx_t *const pctx[],
+                                                  const uint8_t *const pinput[],
+                                                  uint8_t *const poutput[], uint32_t num)
+{
+    uint32_t index = 0;
+    for (; index + 4 <= num; index += 4)
+    {
+        const __m128i *prk0 = (const __m128i *)pctx[index]->data;
+        const __m128i *prk1 = (const __m128i *)pctx[index + 1]->data;
+        const __m128i *prk2 = (const __m128i *)pctx[index + 2]->data;
+        const __m128i *prk3 = (const __m128i *)pctx[index + 3]->data;
+        __m128i block0 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)pinput[index]),
+                                       _mm_loadu_si128(prk0));
+        __m128i block1 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)pinput[index + 1]),
+                                       _mm_loadu_si128(prk1));
+        __m128i block2 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)pinput[index + 2]),
+                                       _mm_loadu_si128(prk2));
+        __m128i block3 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)pinput[index + 3]),
+                                       _mm_loadu_si128(prk3));
+        for (uint8_t i = 1; i < 10; ++i)
+        {
+            block0 = _mm_aesenc_si128(block0, _mm_loadu_si128(prk0 + i));
+            block1 = _mm_aesenc_si128(block1, _mm_loadu_si128(prk1 + i));
+            block2 = _mm_aesenc_si128(block2, _mm_loadu_si128(prk2 + i));
+            block3 = _mm_aesenc_si128(block3, _mm_loadu_si128(prk3 + i));
+        }
+        _mm_storeu_si128((__m128i *)poutput[index],
+                         _mm_aesenclast_si128(block0, _mm_loadu_si128(prk0 + 10)));
+        _mm_storeu_si128((__m128i *)poutput[index + 1],
+                         _mm_aesenclast_si128(block1, _mm_loadu_si128(prk1 + 10)));
+        _mm_storeu_si128((__m128i *)poutput[index + 2],
+                         _mm_aesenclast_si128(block2, _mm_loadu_si128(prk2 + 10)));
+        _mm_storeu_si128((__m128i *)poutput[index + 3],
+                         _mm_aesenclast_si128(block3, _mm_loadu_si128(prk3 + 10)));
+    }
+
+    for (; index < num; ++index)
+    {
+        meshx_aesni_encrypt(pctx[index], pinput[index], poutput[index]);
+    }
+}
+
+#else
+
+bool meshx_aesni_is_supported(void)
+{
+    return FALSE;
+}
+
+void meshx_aesni_key_expand(meshx_aes128_ctx_t *pctx, const uint8_t key[16])
+{
+    MESHX_UNUSED(pctx);
+    MESHX_UNUSED(key);
+}
+
+void meshx_aesni_encrypt(const meshx_aes128_ctx_t *pctx, const uint8_t input[16],
+                         uint8_t output[16])
+{
+    MESHX_UNUSED(pctx);
+    MESHX_UNUSED(input);
+    MESHX_UNUSED(output);
+}
+
+void meshx_aesni_encrypt2(const meshx_aes128_ctx_t *pctx,
+                          const uint8_t input0[16], uint8_t output0[16],
+                          const uint8_t input1[16], uint8_t output1[16])
+{
+    MESHX_UNUSED(pctx);
+    MESHX_UNUSED(input0);
+    MESHX_UNUSED(output0);
+    MESHX_UNUSED(input1);
+    MESHX_UNUSED(output1);
+}
+
+void meshx_aesni_encrypt_multi(const meshx_aes128_ctx_t *const pctx[],
+                               const uint8_t *const pinput[],
+                               uint8_t *const poutput[], uint32_t num)
+{
+    MESHX_UNUSED(pctx);
+    MESHX_UNUSED(pinput);
+    MESHX_UNUSED(poutput);
+    MESHX_UNUSED(num);
+}
+
+#endif
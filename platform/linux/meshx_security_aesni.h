@@ -0,0 +1,28 @@
+/**
+ * This file is part of the meshx library.
+ *
+ * Copyright 2019, Huang Yang <elious.huang@gmail.com>. All rights reserved.
+ *
+ * See the COPYING file for the terms of usage and distribution.
+ */
+#ifndef _MESHX_SECURITY_AESNI_H_
+#define _MESHX_SECURITY_AESNI_H_
+
+#include "meshx_security_wrapper.h"
+
+MESHX_BEGIN_DECLS
+
+MESHX_EXTERN bool meshx_aesni_is_supported(void);
+MESHX_EXTERN void meshx_aesni_key_expand(meshx_aes128_ctx_t *pctx, const uint8_t key[16]);
+MESHX_EXTERN void meshx_aesni_encrypt(const meshx_aes128_ctx_t *pctx, const uint8_t input[16],
+                                      uint8_t output[16]);
+MESHX_EXTERN void meshx_aesni_encrypt2(const meshx_aes128_ctx_t *pctx,
+                                       const uint8_t input0[16], uint8_t output0[16],
+                                       const uint8_t input1[16], uint8_t output1[16]);
+MESHX_EXTERN void meshx_aesni_encrypt_multi(const meshx_aes128_ctx_t *const pctx[],
+                                            const uint8_t *const pinput[],
+                                            uint8_t *const poutput[], uint32_t num);
+
+MESHX_END_DECLS
+
+#endif /* _MESHX_SECURITY_AESNI_H_ */
@@ -12,6 +12,118 @@
 #include "aes_cmac.h"
 #include "aes_ccm.h"
 #include "uECC.h"
+#include "meshx_security_aesni.h"
+
+/* expanded key is stored in place of the tiny-AES-c context */
+typedef char meshx_aes128_ctx_size_check[(sizeof(struct AES_ctx) <= sizeof(
+                                              meshx_aes128_ctx_t)) ? 1 : -1];
+
+typedef struct
+{
+    void (*key_expand)(meshx_aes128_ctx_t *pctx, const uint8_t key[16]);
+    void (*encrypt)(const meshx_aes128_ctx_t *pctx, const uint8_t input[16], uint8_t output[16]);
+    void (*encrypt2)(const meshx_aes128_ctx_t *pctx, const uint8_t input0[16], uint8_t output0[16],
+                     const uint8_t input1[16], uint8_t output1[16]);
+    void (*encrypt_multi)(const meshx_aes128_ctx_t *const pctx[], const uint8_t *const pinput[],
+                          uint8_t *const poutput[], uint32_t num);
+} meshx_aes128_ops_t;
+
+static void meshx_aes128_soft_key_expand(meshx_aes128_ctx_t *pctx, const uint8_t key[16])
+{
+    AES_init_ctx((struct AES_ctx *)pctx, key);
+}
+
+static void meshx_aes128_soft_encrypt(const meshx_aes128_ctx_t *pctx, const uint8_t input[16],
+                                      uint8_t output[16])
+{
+    if (output != input)
+    {
+        memcpy(output, input, 16);
+    }
+    AES_ECB_encrypt((struct AES_ctx *)pctx, output);
+}
+
+static void meshx_aes128_soft_encrypt2(const meshx_aes128_ctx_t *pctx,
+                                       const uint8_t input0[16], uint8_t output0[16],
+                                       const uint8_t input1[16], uint8_t output1[16])
+{
+    meshx_aes128_soft_encrypt(pctx, input0, output0);
+    meshx_aes128_soft_encrypt(pctx, input1, output1);
+}
+
+static void meshx_aes128_soft_encrypt_multi(const meshx_aes128_ctx_t *const pctx[],
+                                            const uint8_t *const pinput[],
+                                            uint8_t *const poutput[], uint32_t num)
+{
+    for (uint32_t i = 0; i < num; ++i)
+    {
+        meshx_aes128_soft_encrypt(pctx[i], pinput[i], poutput[i]);
+    }
+}
+
+static const meshx_aes128_ops_t aes128_backends[] =
+{
+    [MESHX_AES128_BACKEND_SOFTWARE] =
+    {
+        meshx_aes128_soft_key_expand, meshx_aes128_soft_encrypt,
+        meshx_aes128_soft_encrypt2, meshx_aes128_soft_encrypt_multi
+    },
+    [MESHX_AES128_BACKEND_AESNI] =
+    {
+        meshx_aesni_key_expand, meshx_aesni_encrypt,
+        meshx_aesni_encrypt2, meshx_aesni_encrypt_multi
+    },
+};
+
+static meshx_aes128_backend_t aes128_backend = MESHX_AES128_BACKEND_SOFTWARE;
+static const meshx_aes128_ops_t *paes128_ops = &aes128_backends[MESHX_AES128_BACKEND_SOFTWARE];
+
+bool meshx_aes128_backend_is_supported(meshx_aes128_backend_t backend)
+{
+    bool ret = FALSE;
+    switch (backend)
+    {
+    case MESHX_AES128_BACKEND_SOFTWARE:
+        ret = TRUE;
+        break;
+    case MESHX_AES128_BACKEND_AESNI:
+        ret = meshx_aesni_is_supported();
+        break;
+    default:
+        break;
+    }
+
+    return ret;
+}
+
+int32_t meshx_aes128_backend_set(meshx_aes128_backend_t backend)
+{
+    if (!meshx_aes128_backend_is_supported(backend))
+    {
+        return -MESHX_ERR_INVAL;
+    }
+
+    aes128_backend = backend;
+    paes128_ops = &aes128_backends[backend];
+
+    return MESHX_SUCCESS;
+}
+
+meshx_aes128_backend_t meshx_aes128_backend_get(void)
+{
+    return aes128_backend;
+}
+
+int32_t meshx_security_wrapper_init(void)
+{
+    meshx_aes128_backend_t backend = MESHX_AES128_BACKEND_SOFTWARE;
+    if (meshx_aes128_backend_is_supported(MESHX_AES128_BACKEND_AESNI))
+    {
+        backend = MESHX_AES128_BACKEND_AESNI;
+    }
+
+    return meshx_aes128_backend_set(backend);
+}
 
 int32_t meshx_ecc_make_key(uint8_t public_key[64], uint8_t private_key[32])
 {
@@ -29,7 +141,7 @@ bool meshx_ecc_validate_public_key(const uint8_t public_key[64])
     return (1 == uECC_valid_public_key(public_key, uECC_secp256r1()));
 }
 
-int32_t meshx_ecc_shared_secret(const uint8_t public_key[64], const uint8_t private_key[64],
+int32_t meshx_ecc_shared_secret(const uint8_t public_key[64], const uint8_t private_key[32],
                                 uint8_t secret[32])
 {
     int32_t ret = MESHX_SUCCESS;
@@ -41,16 +153,38 @@ int32_t meshx_ecc_shared_secret(const uint8_t public_key[64], const uint8_t priv
     return ret;
 }
 
-int32_t meshx_aes128_encrypt(const uint8_t input[16], const uint8_t key[16], uint8_t output[16])
+int32_t meshx_aes128_ctx_init(meshx_aes128_ctx_t *pctx, const uint8_t key[16])
 {
-    memcpy(output, input, 16);
-    struct AES_ctx ctx;
-    AES_init_ctx(&ctx, key);
-    AES_ECB_encrypt(&ctx, output);
+    paes128_ops->key_expand(pctx, key);
+
+    return MESHX_SUCCESS;
+}
+
+int32_t meshx_aes128_ctx_encrypt(const meshx_aes128_ctx_t *pctx, const uint8_t input[16],
+                                 uint8_t output[16])
+{
+    paes128_ops->encrypt(pctx, input, output);
 
     return MESHX_SUCCESS;
 }
 
+int32_t meshx_aes128_ctx_encrypt_multi(const meshx_aes128_ctx_t *const pctx[],
+                                       const uint8_t *const pinput[],
+                                       uint8_t *const poutput[], uint32_t num)
+{
+    paes128_ops->encrypt_multi(pctx, pinput, poutput, num);
+
+    return MESHX_SUCCESS;
+}
+
+int32_t meshx_aes128_encrypt(const uint8_t input[16], const uint8_t key[16], uint8_t output[16])
+{
+    meshx_aes128_ctx_t ctx;
+    meshx_aes128_ctx_init(&ctx, key);
+
+    return meshx_aes128_ctx_encrypt(&ctx, input, output);
+}
+
 int32_t meshx_aes128_decrypt(const uint8_t input[16], const uint8_t key[16], uint8_t output[16])
 {
     memcpy(output, input, 16);
@@ -61,47 +195,340 @@ int32_t meshx_aes128_decrypt(const uint8_t input[16], const uint8_t key[16], uin
     return MESHX_SUCCESS;
 }
 
+int32_t meshx_aes_cmac_ctx_init(meshx_aes_cmac_ctx_t *pctx, const uint8_t key[16])
+{
+    meshx_aes128_ctx_init(&pctx->cipher, key);
+    generate_subkey(&pctx->cipher, pctx->k1, pctx->k2);
+
+    return MESHX_SUCCESS;
+}
+
+int32_t meshx_aes_cmac_ctx(const meshx_aes_cmac_ctx_t *pctx, const uint8_t *pinput, uint32_t len,
+                           uint8_t mac[16])
+{
+    AES_CMAC_with_subkey(&pctx->cipher, pctx->k1, pctx->k2, (uint8_t *)pinput, len, mac);
+
+    return MESHX_SUCCESS;
+}
+
 int32_t meshx_aes_cmac(const uint8_t key[16], const uint8_t *pinput, uint32_t len,
                        uint8_t mac[16])
 {
-    AES_CMAC((uint8_t *)key, (uint8_t *)pinput, len, mac);
+    meshx_aes128_ctx_t ctx;
+    meshx_aes128_ctx_init(&ctx, key);
+    AES_CMAC(&ctx, (uint8_t *)pinput, len, mac);
 
     return MESHX_SUCCESS;
 }
 
-void aes128_encrypt(const unsigned char key[16], const unsigned char input[16],
+void aes128_encrypt(const void *pcipher, const unsigned char input[16],
                     unsigned char output[16])
 {
-    meshx_aes128_encrypt(input, key, output);
+    meshx_aes128_ctx_encrypt(pcipher, input, output);
 }
 
-int32_t meshx_aes_ccm_encrypt(const uint8_t key[16], const uint8_t *piv, uint32_t iv_len,
-                              const uint8_t *padd, uint32_t add_len,
-                              const uint8_t *pinput, uint32_t length, uint8_t *poutput,
-                              uint8_t *ptag, uint32_t tag_len)
+/**
+ * mesh ccm: 13 bytes nonce, no additional data and 32/64 bits mic, so the length field
+ * is always 2 bytes and the counter only uses the last 2 bytes.
+ * the cbc-mac block and the counter block of each step do not depend on each other,
+ * they are encrypted together.
+ */
+#define MESHX_AES_CCM_MESH_NONCE_LEN           13
+#define MESHX_AES_CCM_MESH_MAX_LEN             0xffff
+
+static bool meshx_aes_ccm_is_mesh(uint32_t iv_len, uint32_t add_len, uint32_t length,
+                                  uint32_t tag_len)
 {
-    int32_t ret = MESHX_SUCCESS;
-    if (0 != mbedtls_ccm_encrypt_and_tag((mbedtls_ccm_context *)key, length, piv, iv_len, padd, add_len,
-                                         pinput, poutput,
-                                         ptag, tag_len))
+    return ((MESHX_AES_CCM_MESH_NONCE_LEN == iv_len) && (0 == add_len) &&
+            (length <= MESHX_AES_CCM_MESH_MAX_LEN) && ((4 == tag_len) || (8 == tag_len)));
+}
+
+static void meshx_aes_ccm_mesh_init(const uint8_t *piv, uint32_t length, uint32_t tag_len,
+                                    uint8_t b0[16], uint8_t ctr[16])
+{
+    /* flags: no adata, (t - 2) / 2, q - 1 */
+    b0[0] = (((tag_len - 2) / 2) << 3) | 0x01;
+    memcpy(b0 + 1, piv, MESHX_AES_CCM_MESH_NONCE_LEN);
+    b0[14] = (uint8_t)(length >> 8);
+    b0[15] = (uint8_t)length;
+
+    ctr[0] = 0x01;
+    memcpy(ctr + 1, piv, MESHX_AES_CCM_MESH_NONCE_LEN);
+    ctr[14] = 0;
+    ctr[15] = 0;
+}
+
+static void meshx_aes_ccm_mesh_encrypt(const meshx_aes128_ctx_t *pctx, const uint8_t *piv,
+                                       const uint8_t *pinput, uint32_t length, uint8_t *poutput,
+                                       uint8_t *ptag, uint32_t tag_len)
+{
+    uint8_t y[16], ctr[16], s0[16], stream[16], block[16];
+    meshx_aes_ccm_mesh_init(piv, length, tag_len, y, ctr);
+    /* Y0 = E(B0), S0 = E(A0) */
+    paes128_ops->encrypt2(pctx, y, y, ctr, s0);
+
+    uint16_t counter = 1;
+    uint32_t use_len;
+    while (length > 0)
+    {
+        use_len = (length > 16) ? 16 : length;
+        /* input may be the same as output, keep plaintext */
+        memcpy(block, pinput, use_len);
+        for (uint8_t i = 0; i < use_len; ++i)
+        {
+            y[i] ^= block[i];
+        }
+        ctr[14] = (uint8_t)(counter >> 8);
+        ctr[15] = (uint8_t)counter;
+        /* Yi = E(Yi-1 ^ Pi), Si = E(Ai) */
+        paes128_ops->encrypt2(pctx, y, y, ctr, stream);
+        for (uint8_t i = 0; i < use_len; ++i)
+        {
+            poutput[i] = block[i] ^ stream[i];
+        }
+
+        counter ++;
+        pinput += use_len;
+        poutput += use_len;
+        length -= use_len;
+    }
+
+    for (uint8_t i = 0; i < tag_len; ++i)
+    {
+        ptag[i] = y[i] ^ s0[i];
+    }
+}
+
+static int32_t meshx_aes_ccm_mesh_decrypt(const meshx_aes128_ctx_t *pctx, const uint8_t *piv,
+                                          const uint8_t *pinput, uint32_t length, uint8_t *poutput,
+                                          const uint8_t *ptag, uint32_t tag_len)
+{
+    uint8_t y[16], ctr[16], stream[16];
+    meshx_aes_ccm_mesh_init(piv, length, tag_len, y, ctr);
+
+    uint16_t counter = 1;
+    uint32_t use_len;
+    /* Y0 = E(B0), S1 = E(A1) */
+    ctr[15] = 0x01;
+    paes128_ops->encrypt2(pctx, y, y, ctr, stream);
+    while (length > 0)
+    {
+        use_len = (length > 16) ? 16 : length;
+        for (uint8_t i = 0; i < use_len; ++i)
+        {
+            poutput[i] = pinput[i] ^ stream[i];
+            y[i] ^= poutput[i];
+        }
+
+        /* next counter, counter 0 is used to encrypt tag at last */
+        counter ++;
+        length -= use_len;
+        if (0 == length)
+        {
+            counter = 0;
+        }
+        ctr[14] = (uint8_t)(counter >> 8);
+        ctr[15] = (uint8_t)counter;
+        /* Yi = E(Yi-1 ^ Pi), Si+1 = E(Ai+1) */
+        paes128_ops->encrypt2(pctx, y, y, ctr, stream);
+
+        pinput += use_len;
+        poutput += use_len;
+    }
+
+    if (0 != counter)
+    {
+        /* no payload, only tag */
+        ctr[15] = 0;
+        paes128_ops->encrypt(pctx, ctr, stream);
+    }
+
+    /* check tag in constant time */
+    uint8_t diff = 0;
+    for (uint8_t i = 0; i < tag_len; ++i)
+    {
+        diff |= ptag[i] ^ y[i] ^ stream[i];
+    }
+
+    return (0 == diff) ? MESHX_SUCCESS : -MESHX_ERR_FAIL;
+}
+
+/**
+ * decrypt jobs in lock step, cbc-mac block and counter block of all jobs in one step are
+ * encrypted together
+ */
+#define MESHX_AES_CCM_MULTI_MAX                8
+
+static void meshx_aes_ccm_mesh_decrypt_multi(meshx_aes_ccm_job_t *pjobs, uint32_t num)
+{
+    uint8_t y[MESHX_AES_CCM_MULTI_MAX][16];
+    uint8_t ctr[MESHX_AES_CCM_MULTI_MAX][16];
+    uint8_t stream[MESHX_AES_CCM_MULTI_MAX][16];
+    uint16_t offset[MESHX_AES_CCM_MULTI_MAX];
+    uint16_t counter[MESHX_AES_CCM_MULTI_MAX];
+    const meshx_aes128_ctx_t *pctxs[MESHX_AES_CCM_MULTI_MAX * 2];
+    const uint8_t *pinputs[MESHX_AES_CCM_MULTI_MAX * 2];
+    uint8_t *poutputs[MESHX_AES_CCM_MULTI_MAX * 2];
+    uint32_t block_num = 0;
+
+    /* Y0 = E(B0), S1 = E(A1), or S0 = E(A0) if there is no payload */
+    for (uint32_t i = 0; i < num; ++i)
+    {
+        meshx_aes_ccm_mesh_init(pjobs[i].piv, pjobs[i].length, pjobs[i].tag_len, y[i], ctr[i]);
+        offset[i] = 0;
+        counter[i] = (0 == pjobs[i].length) ? 0 : 1;
+        ctr[i][15] = (uint8_t)counter[i];
+        pctxs[block_num] = pjobs[i].pctx;
+        pinputs[block_num] = y[i];
+        poutputs[block_num ++] = y[i];
+        pctxs[block_num] = pjobs[i].pctx;
+        pinputs[block_num] = ctr[i];
+        poutputs[block_num ++] = stream[i];
+    }
+
+    while (block_num > 0)
+    {
+        paes128_ops->encrypt_multi(pctxs, pinputs, poutputs, block_num);
+        block_num = 0;
+        for (uint32_t i = 0; i < num; ++i)
+        {
+            if (offset[i] >= pjobs[i].length)
+            {
+                continue;
+            }
+
+            uint16_t use_len = pjobs[i].length - offset[i];
+            if (use_len > 16)
+            {
+                use_len = 16;
+            }
+            const uint8_t *pinput = pjobs[i].pinput + offset[i];
+            uint8_t *poutput = pjobs[i].poutput + offset[i];
+            for (uint8_t j = 0; j < use_len; ++j)
+            {
+                poutput[j] = pinput[j] ^ stream[i][j];
+                y[i][j] ^= poutput[j];
+            }
+            offset[i] += use_len;
+
+            /* counter 0 is used to encrypt tag after the last block */
+            counter[i] = (offset[i] >= pjobs[i].length) ? 0 : (counter[i] + 1);
+            ctr[i][14] = (uint8_t)(counter[i] >> 8);
+            ctr[i][15] = (uint8_t)counter[i];
+            pctxs[block_num] = pjobs[i].pctx;
+            pinputs[block_num] = y[i];
+            poutputs[block_num ++] = y[i];
+            pctxs[block_num] = pjobs[i].pctx;
+            pinputs[block_num] = ctr[i];
+            poutputs[block_num ++] = stream[i];
+        }
+    }
+
+    for (uint32_t i = 0; i < num; ++i)
+    {
+        uint8_t diff = 0;
+        for (uint8_t j = 0; j < pjobs[i].tag_len; ++j)
+        {
+            diff |= pjobs[i].ptag[j] ^ y[i][j] ^ stream[i][j];
+        }
+        pjobs[i].result = (0 == diff) ? MESHX_SUCCESS : -MESHX_ERR_FAIL;
+    }
+}
+
+int32_t meshx_aes_ccm_ctx_decrypt_multi(meshx_aes_ccm_job_t *pjobs, uint32_t num)
+{
+    /* continuous mesh jobs are decrypted together */
+    uint32_t start = 0;
+    for (uint32_t i = 0; i < num; ++i)
+    {
+        bool is_mesh = meshx_aes_ccm_is_mesh(MESHX_AES_CCM_MESH_NONCE_LEN, 0, pjobs[i].length,
+                                             pjobs[i].tag_len);
+        if ((!is_mesh || (MESHX_AES_CCM_MULTI_MAX == i - start)) && (i > start))
+        {
+            meshx_aes_ccm_mesh_decrypt_multi(pjobs + start, i - start);
+            start = i;
+        }
+
+        if (!is_mesh)
+        {
+            pjobs[i].result = meshx_aes_ccm_ctx_decrypt(pjobs[i].pctx, pjobs[i].piv,
+                                                        MESHX_AES_CCM_MESH_NONCE_LEN, NULL, 0,
+                                                        pjobs[i].pinput, pjobs[i].length,
+                                                        pjobs[i].poutput, pjobs[i].ptag,
+                                                        pjobs[i].tag_len);
+            start = i + 1;
+        }
+    }
+
+    if (num > start)
+    {
+        meshx_aes_ccm_mesh_decrypt_multi(pjobs + start, num - start);
+    }
+
+    return MESHX_SUCCESS;
+}
+
+int32_t meshx_aes_ccm_ctx_encrypt(const meshx_aes128_ctx_t *pctx, const uint8_t *piv,
+                                  uint32_t iv_len, const uint8_t *padd, uint32_t add_len,
+                                  const uint8_t *pinput, uint32_t length, uint8_t *poutput,
+                                  uint8_t *ptag, uint32_t tag_len)
+{
+    if (meshx_aes_ccm_is_mesh(iv_len, add_len, length, tag_len))
+    {
+        meshx_aes_ccm_mesh_encrypt(pctx, piv, pinput, length, poutput, ptag, tag_len);
+        return MESHX_SUCCESS;
+    }
+
+    mbedtls_ccm_context ccm_ctx = {.pcipher = pctx};
+    if (0 != mbedtls_ccm_encrypt_and_tag(&ccm_ctx, length, piv, iv_len, padd, add_len,
+                                         pinput, poutput, ptag, tag_len))
     {
         return -MESHX_ERR_FAIL;
     }
 
-    return ret;
+    return MESHX_SUCCESS;
 }
 
-int meshx_aes_ccm_decrypt(const uint8_t key[16], const uint8_t *piv, uint32_t iv_len,
-                          const uint8_t *padd, uint32_t add_len,
-                          const uint8_t *pinput, uint32_t length, uint8_t *poutput,
-                          const uint8_t *ptag, uint32_t tag_len)
+int32_t meshx_aes_ccm_ctx_decrypt(const meshx_aes128_ctx_t *pctx, const uint8_t *piv,
+                                  uint32_t iv_len, const uint8_t *padd, uint32_t add_len,
+                                  const uint8_t *pinput, uint32_t length, uint8_t *poutput,
+                                  const uint8_t *ptag, uint32_t tag_len)
 {
-    int32_t ret = MESHX_SUCCESS;
-    if (0 != mbedtls_ccm_auth_decrypt((mbedtls_ccm_context *)key, length, piv, iv_len, padd, add_len,
+    if (meshx_aes_ccm_is_mesh(iv_len, add_len, length, tag_len))
+    {
+        return meshx_aes_ccm_mesh_decrypt(pctx, piv, pinput, length, poutput, ptag, tag_len);
+    }
+
+    mbedtls_ccm_context ccm_ctx = {.pcipher = pctx};
+    if (0 != mbedtls_ccm_auth_decrypt(&ccm_ctx, length, piv, iv_len, padd, add_len,
                                       pinput, poutput, ptag, tag_len))
     {
         return -MESHX_ERR_FAIL;
     }
 
-    return ret;
-}
\ No newline at end of file
+    return MESHX_SUCCESS;
+}
+
+int32_t meshx_aes_ccm_encrypt(const uint8_t key[16], const uint8_t *piv, uint32_t iv_len,
+                              const uint8_t *padd, uint32_t add_len,
+                              const uint8_t *pinput, uint32_t length, uint8_t *poutput,
+                              uint8_t *ptag, uint32_t tag_len)
+{
+    meshx_aes128_ctx_t ctx;
+    meshx_aes128_ctx_init(&ctx, key);
+
+    return meshx_aes_ccm_ctx_encrypt(&ctx, piv, iv_len, padd, add_len, pinput, length, poutput,
+                                     ptag, tag_len);
+}
+
+int32_t meshx_aes_ccm_decrypt(const uint8_t key[16], const uint8_t *piv, uint32_t iv_len,
+                              const uint8_t *padd, uint32_t add_len,
+                              const uint8_t *pinput, uint32_t length, uint8_t *poutput,
+                              const uint8_t *ptag, uint32_t tag_len)
+{
+    meshx_aes128_ctx_t ctx;
+    meshx_aes128_ctx_init(&ctx, key);
+
+    return meshx_aes_ccm_ctx_decrypt(&ctx, piv, iv_len, padd, add_len, pinput, length, poutput,
+                                     ptag, tag_len);
+}
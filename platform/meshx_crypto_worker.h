@@ -0,0 +1,28 @@
+/**
+ * This file is part of the meshx library.
+ *
+ * Copyright 2019, Huang Yang <elious.huang@gmail.com>. All rights reserved.
+ *
+ * See the LICENSE file for the terms of usage and distribution.
+ */
+#ifndef _MESHX_CRYPTO_WORKER_H_
+#define _MESHX_CRYPTO_WORKER_H_
+
+#include "meshx_types.h"
+
+MESHX_BEGIN_DECLS
+
+/* executed in worker thread, must not touch stack data */
+typedef void (*meshx_crypto_work_t)(void *pargs);
+
+/**
+ * create crypto worker threads
+ * @param worker_num: number of worker threads, 0 means work is executed in submitter context
+ */
+MESHX_EXTERN int32_t meshx_crypto_worker_init(uint8_t worker_num);
+MESHX_EXTERN int32_t meshx_crypto_worker_submit(meshx_crypto_work_t work, void *pargs);
+
+MESHX_END_DECLS
+
+
+#endif /* _MESHX_CRYPTO_WORKER_H_ */
@@ -0,0 +1,53 @@
+/**
+ * This file is part of the meshx library.
+ *
+ * Copyright 2019, Huang Yang <elious.huang@gmail.com>. All rights reserved.
+ *
+ * See the LICENSE file for the terms of usage and distribution.
+ */
+#ifndef _MESHX_IP_WRAPPER_H_
+#define _MESHX_IP_WRAPPER_H_
+
+#include "meshx_types.h"
+
+MESHX_BEGIN_DECLS
+
+#define MESHX_IP_FAMILY_UDP                 0 /* udp over ipv4 */
+#define MESHX_IP_FAMILY_UNIX                1 /* unix domain datagram */
+
+#define MESHX_IP_UNIX_PATH_MAX_LEN          64
+
+typedef struct
+{
+    uint8_t family;
+    uint8_t ipv4[4]; /* udp, most significant byte first */
+    uint16_t port; /* udp */
+    char path[MESHX_IP_UNIX_PATH_MAX_LEN]; /* unix, null terminated */
+} meshx_ip_addr_t;
+
+typedef struct
+{
+    meshx_ip_addr_t addr; /* destination when send, source when receive */
+    uint8_t *pdata;
+    uint16_t len; /* buffer size when receive, updated to datagram length */
+} meshx_ip_datagram_t;
+
+/**
+ * open non-blocking datagram socket bound to local address
+ */
+int32_t meshx_ip_open(const meshx_ip_addr_t *plocal, int32_t *phandle);
+void meshx_ip_close(int32_t handle);
+/**
+ * send several datagrams in one call
+ * @return number of datagrams sent, -MESHX_ERR_BUSY if socket buffer is full
+ */
+int32_t meshx_ip_send_batch(int32_t handle, const meshx_ip_datagram_t *pdatagrams, uint16_t num);
+/**
+ * receive available datagrams without blocking
+ * @return number of datagrams received, 0 if there is no datagram
+ */
+int32_t meshx_ip_receive_batch(int32_t handle, meshx_ip_datagram_t *pdatagrams, uint16_t num);
+
+MESHX_END_DECLS
+
+#endif /* _MESHX_IP_WRAPPER_H_ */
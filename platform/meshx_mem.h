@@ -13,6 +13,8 @@
 MESHX_BEGIN_DECLS
 
 MESHX_EXTERN void *meshx_malloc(size_t size);
+/* alignment is power of 2 and multiple of pointer size, memory is released by meshx_free */
+MESHX_EXTERN void *meshx_malloc_aligned(size_t alignment, size_t size);
 MESHX_EXTERN void meshx_free(void *ptr);
 
 MESHX_END_DECLS
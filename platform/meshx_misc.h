@@ -14,6 +14,8 @@ MESHX_BEGIN_DECLS
 
 MESHX_EXTERN void meshx_srand(uint32_t seed);
 MESHX_EXTERN int32_t meshx_rand(void);
+/* monotonic time in milliseconds, wraps around */
+MESHX_EXTERN uint32_t meshx_time_get(void);
 
 MESHX_END_DECLS
 
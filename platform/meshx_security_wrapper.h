@@ -12,6 +12,48 @@
 
 MESHX_BEGIN_DECLS
 
+#define MESHX_AES128_CTX_SIZE                192
+
+/* expanded aes128 key, the layout is private to the crypto implementation */
+typedef struct
+{
+    uint32_t data[MESHX_AES128_CTX_SIZE / sizeof(uint32_t)];
+} meshx_aes128_ctx_t;
+
+/* expanded key and subkeys of cmac */
+typedef struct
+{
+    meshx_aes128_ctx_t cipher;
+    uint8_t k1[16];
+    uint8_t k2[16];
+} meshx_aes_cmac_ctx_t;
+
+/* ccm job with mesh parameters: 13 bytes nonce, no additional data, 4 or 8 bytes tag */
+typedef struct
+{
+    const meshx_aes128_ctx_t *pctx;
+    const uint8_t *piv;
+    const uint8_t *pinput;
+    uint8_t *poutput;
+    const uint8_t *ptag;
+    uint16_t length;
+    uint8_t tag_len;
+    int32_t result;
+} meshx_aes_ccm_job_t;
+
+typedef enum
+{
+    MESHX_AES128_BACKEND_SOFTWARE,
+    MESHX_AES128_BACKEND_AESNI,
+} meshx_aes128_backend_t;
+
+
+MESHX_EXTERN int32_t meshx_security_wrapper_init(void);
+MESHX_EXTERN bool meshx_aes128_backend_is_supported(meshx_aes128_backend_t backend);
+/* expanded keys belong to the backend which expanded them, so backend can only be changed
+   before any key is added */
+MESHX_EXTERN int32_t meshx_aes128_backend_set(meshx_aes128_backend_t backend);
+MESHX_EXTERN meshx_aes128_backend_t meshx_aes128_backend_get(void);
 
 MESHX_EXTERN int32_t meshx_ecc_make_key(uint8_t public_key[64], uint8_t private_key[32]);
 MESHX_EXTERN bool meshx_ecc_validate_public_key(const uint8_t public_key[64]);
@@ -35,6 +77,28 @@ MESHX_EXTERN int32_t meshx_aes_ccm_decrypt(const uint8_t key[16], const uint8_t
                                            const uint8_t *pinput, uint32_t length, uint8_t *poutput,
                                            const uint8_t *ptag, uint32_t tag_len);
 
+MESHX_EXTERN int32_t meshx_aes128_ctx_init(meshx_aes128_ctx_t *pctx, const uint8_t key[16]);
+MESHX_EXTERN int32_t meshx_aes128_ctx_encrypt(const meshx_aes128_ctx_t *pctx,
+                                              const uint8_t input[16], uint8_t output[16]);
+/* encrypt independent blocks, each block uses its own key */
+MESHX_EXTERN int32_t meshx_aes128_ctx_encrypt_multi(const meshx_aes128_ctx_t *const pctx[],
+                                                    const uint8_t *const pinput[],
+                                                    uint8_t *const poutput[], uint32_t num);
+MESHX_EXTERN int32_t meshx_aes_cmac_ctx_init(meshx_aes_cmac_ctx_t *pctx, const uint8_t key[16]);
+MESHX_EXTERN int32_t meshx_aes_cmac_ctx(const meshx_aes_cmac_ctx_t *pctx, const uint8_t *pinput,
+                                        uint32_t len, uint8_t mac[16]);
+MESHX_EXTERN int32_t meshx_aes_ccm_ctx_encrypt(const meshx_aes128_ctx_t *pctx, const uint8_t *piv,
+                                               uint32_t iv_len,
+                                               const uint8_t *padd, uint32_t add_len,
+                                               const uint8_t *pinput, uint32_t length, uint8_t *poutput,
+                                               uint8_t *ptag, uint32_t tag_len);
+MESHX_EXTERN int32_t meshx_aes_ccm_ctx_decrypt(const meshx_aes128_ctx_t *pctx, const uint8_t *piv,
+                                               uint32_t iv_len,
+                                               const uint8_t *padd, uint32_t add_len,
+                                               const uint8_t *pinput, uint32_t length, uint8_t *poutput,
+                                               const uint8_t *ptag, uint32_t tag_len);
+/* decrypt jobs together, result of each job is stored in job result */
+MESHX_EXTERN int32_t meshx_aes_ccm_ctx_decrypt_multi(meshx_aes_ccm_job_t *pjobs, uint32_t num);
 
 
 MESHX_END_DECLS
@@ -0,0 +1,522 @@
+/**
+ * This file is part of the meshx library.
+ *
+ * Copyright 2019, Huang Yang <elious.huang@gmail.com>. All rights reserved.
+ *
+ * See the COPYING file for the terms of usage and distribution.
+ */
+#define MESHX_TRACE_MODULE "BENCH_CRYPTO"
+#include <time.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "meshx.h"
+#include "meshx_security.h"
+
+/**
+ * time every security primitive and check the results with sample data, results of software
+ * and aesni backend are compared before timing
+ * usage: meshx_bench_crypto [-m] [-t time per case in ms]
+ *     -m: machine readable output, one csv line for each case:
+ *         backend,case,iterations,ns_per_op,ops_per_s,check
+ */
+
+#define BENCH_CRYPTO_TIME_DEFAULT          200 /* ms */
+
+typedef struct
+{
+    const char *name;
+    void (*run)(void);
+    /* TRUE: result is the same as sample data */
+    bool (*check)(void);
+    /* result depends on aes backend */
+    bool aes;
+} bench_crypto_case_t;
+
+/* used by gap wrapper */
+int fd_psdr = -1;
+
+int32_t meshx_trace_send(const char *pdata, uint32_t len)
+{
+    return len;
+}
+
+static uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/* aes128: FIPS-197 appendix C.1 */
+static const uint8_t aes_key[16] =
+{
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+    0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+};
+static const uint8_t aes_plain[16] =
+{
+    0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+    0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff
+};
+static const uint8_t aes_cipher[16] =
+{
+    0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30,
+    0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a
+};
+
+/* network pdu: mesh profile sample message #1, encryption key is derived from sample net key */
+static const uint8_t net_encryption_key[16] =
+{
+    0x09, 0x53, 0xfa, 0x93, 0xe7, 0xca, 0xac, 0x96,
+    0x38, 0xf5, 0x88, 0x20, 0x22, 0x0a, 0x39, 0x8e
+};
+static const uint8_t net_privacy_key[16] =
+{
+    0x8b, 0x84, 0xee, 0xde, 0xc1, 0x00, 0x06, 0x7d,
+    0x67, 0x09, 0x71, 0xdd, 0x2a, 0xa7, 0x00, 0xcf
+};
+static const uint8_t net_nonce[13] =
+{
+    0x00, 0x80, 0x00, 0x00, 0x01, 0x12, 0x01, 0x00, 0x00, 0x12, 0x34, 0x56, 0x78
+};
+static const uint8_t net_plain[13] =
+{
+    0xff, 0xfd, 0x03, 0x4b, 0x50, 0x05, 0x7e, 0x40, 0x00, 0x00, 0x01, 0x00, 0x00
+};
+static const uint8_t net_cipher[13 + 8] =
+{
+    0xb5, 0xe5, 0xbf, 0xda, 0xcb, 0xaf, 0x6c, 0xb7, 0xfb, 0x6b, 0xff, 0x87, 0x1f,
+    0x03, 0x54, 0x44, 0xce, 0x83, 0xa6, 0x70, 0xdf
+};
+
+/* access pdu: mesh profile sample message #6, encrypted by sample device key */
+static const uint8_t access_nonce[13] =
+{
+    0x02, 0x00, 0x31, 0x29, 0xab, 0x00, 0x03, 0x12, 0x01, 0x12, 0x34, 0x56, 0x78
+};
+static const uint8_t access_plain[20] =
+{
+    0x00, 0x56, 0x34, 0x12, 0x63, 0x96, 0x47, 0x71, 0x73, 0x4f,
+    0xbd, 0x76, 0xe3, 0xb4, 0x05, 0x19, 0xd1, 0xd9, 0x4a, 0x48
+};
+static const uint8_t access_cipher[20 + 4] =
+{
+    0xee, 0x9d, 0xdd, 0xfd, 0x21, 0x69, 0x32, 0x6d, 0x23, 0xf3,
+    0xaf, 0xdf, 0xcf, 0xdc, 0x18, 0xc5, 0x2f, 0xde, 0xf7, 0x72,
+    0xe0, 0xe1, 0x73, 0x08
+};
+
+/* s1("test") */
+static const uint8_t s1_test[16] =
+{
+    0xb7, 0x3c, 0xef, 0xbd, 0x64, 0x1e, 0xf2, 0xea,
+    0x59, 0x8c, 0x2b, 0x6e, 0xfb, 0x62, 0xf7, 0x9c
+};
+
+/* identity key of sample net key */
+static const uint8_t identity_key[16] =
+{
+    0x84, 0x39, 0x6c, 0x43, 0x5a, 0xc4, 0x85, 0x60,
+    0xb5, 0x96, 0x53, 0x85, 0x25, 0x3e, 0x21, 0x0c
+};
+
+/* network id of sample net key */
+static const uint8_t net_id[8] = {0x3e, 0xca, 0xff, 0x67, 0x2f, 0x67, 0x33, 0x70};
+
+/* ecdh secret of sample provisioner and device keys */
+static const uint8_t ecdh_secret[32] =
+{
+    0xab, 0x85, 0x84, 0x3a, 0x2f, 0x6d, 0x88, 0x3f,
+    0x62, 0xe5, 0x68, 0x4b, 0x38, 0xe3, 0x07, 0x33,
+    0x5f, 0xe6, 0xe1, 0x94, 0x5e, 0xcd, 0x19, 0x60,
+    0x41, 0x05, 0xc6, 0xf2, 0x32, 0x21, 0xeb, 0x69
+};
+
+static const uint8_t salt_test[] = {'t', 'e', 's', 't'};
+static const uint8_t salt_nkik[] = {'n', 'k', 'i', 'k'};
+static const uint8_t P_id128[] = {'i', 'd', '1', '2', '8', 0x01};
+static const uint8_t P_k2 = 0x00;
+
+static meshx_aes128_ctx_t aes_ctx;
+static uint8_t out[64];
+static uint8_t out1[64];
+static uint8_t nid;
+
+static void bench_aes128_encrypt(void)
+{
+    meshx_aes128_encrypt(aes_plain, aes_key, out);
+}
+
+static bool check_aes128_encrypt(void)
+{
+    bench_aes128_encrypt();
+    return (0 == memcmp(out, aes_cipher, 16));
+}
+
+static void bench_aes128_ctx_encrypt(void)
+{
+    meshx_aes128_ctx_encrypt(&aes_ctx, aes_plain, out);
+}
+
+static bool check_aes128_ctx_encrypt(void)
+{
+    meshx_aes128_ctx_init(&aes_ctx, aes_key);
+    bench_aes128_ctx_encrypt();
+    return (0 == memcmp(out, aes_cipher, 16));
+}
+
+static void bench_ccm_encrypt_net(void)
+{
+    meshx_aes_ccm_encrypt(net_encryption_key, net_nonce, sizeof(net_nonce), NULL, 0, net_plain,
+                          sizeof(net_plain), out, out + sizeof(net_plain), 8);
+}
+
+static bool check_ccm_encrypt_net(void)
+{
+    bench_ccm_encrypt_net();
+    return (0 == memcmp(out, net_cipher, sizeof(net_cipher)));
+}
+
+static void bench_ccm_decrypt_net(void)
+{
+    meshx_aes_ccm_decrypt(net_encryption_key, net_nonce, sizeof(net_nonce), NULL, 0, net_cipher,
+                          sizeof(net_plain), out, net_cipher + sizeof(net_plain), 8);
+}
+
+static bool check_ccm_decrypt_net(void)
+{
+    if (MESHX_SUCCESS != meshx_aes_ccm_decrypt(net_encryption_key, net_nonce, sizeof(net_nonce),
+                                               NULL, 0, net_cipher, sizeof(net_plain), out,
+                                               net_cipher + sizeof(net_plain), 8))
+    {
+        return FALSE;
+    }
+    return (0 == memcmp(out, net_plain, sizeof(net_plain)));
+}
+
+static void bench_ccm_encrypt_access(void)
+{
+    meshx_aes_ccm_encrypt(sample_dev_key, access_nonce, sizeof(access_nonce), NULL, 0,
+                          access_plain, sizeof(access_plain), out, out + sizeof(access_plain), 4);
+}
+
+static bool check_ccm_encrypt_access(void)
+{
+    bench_ccm_encrypt_access();
+    return (0 == memcmp(out, access_cipher, sizeof(access_cipher)));
+}
+
+static void bench_ccm_decrypt_access(void)
+{
+    meshx_aes_ccm_decrypt(sample_dev_key, access_nonce, sizeof(access_nonce), NULL, 0,
+                          access_cipher, sizeof(access_plain), out,
+                          access_cipher + sizeof(access_plain), 4);
+}
+
+static bool check_ccm_decrypt_access(void)
+{
+    if (MESHX_SUCCESS != meshx_aes_ccm_decrypt(sample_dev_key, access_nonce, sizeof(access_nonce),
+                                               NULL, 0, access_cipher, sizeof(access_plain), out,
+                                               access_cipher + sizeof(access_plain), 4))
+    {
+        return FALSE;
+    }
+    return (0 == memcmp(out, access_plain, sizeof(access_plain)));
+}
+
+static void bench_aes_cmac(void)
+{
+    /* s1 is cmac with zero key */
+    uint8_t key[16] = {0};
+    meshx_aes_cmac(key, salt_test, sizeof(salt_test), out);
+}
+
+static bool check_aes_cmac(void)
+{
+    bench_aes_cmac();
+    return (0 == memcmp(out, s1_test, 16));
+}
+
+static void bench_s1(void)
+{
+    meshx_s1(salt_test, sizeof(salt_test), out);
+}
+
+static bool check_s1(void)
+{
+    bench_s1();
+    return (0 == memcmp(out, s1_test, 16));
+}
+
+static void bench_k1(void)
+{
+    uint8_t salt[16];
+    meshx_s1(salt_nkik, sizeof(salt_nkik), salt);
+    meshx_k1(sample_net_key, sizeof(meshx_key_t), salt, P_id128, sizeof(P_id128), out);
+}
+
+static bool check_k1(void)
+{
+    bench_k1();
+    return (0 == memcmp(out, identity_key, 16));
+}
+
+static void bench_k1_salt(void)
+{
+    meshx_k1_salt(MESHX_SALT_NKIK, sample_net_key, sizeof(meshx_key_t), P_id128, sizeof(P_id128),
+                  out);
+}
+
+static bool check_k1_salt(void)
+{
+    bench_k1_salt();
+    return (0 == memcmp(out, identity_key, 16));
+}
+
+static void bench_k2(void)
+{
+    meshx_k2(sample_net_key, &P_k2, 1, &nid, out, out + 16);
+}
+
+static bool check_k2(void)
+{
+    bench_k2();
+    return (0x68 == nid) && (0 == memcmp(out, net_encryption_key, 16)) &&
+           (0 == memcmp(out + 16, net_privacy_key, 16));
+}
+
+static void bench_k3(void)
+{
+    meshx_k3(sample_net_key, out);
+}
+
+static bool check_k3(void)
+{
+    bench_k3();
+    return (0 == memcmp(out, net_id, 8));
+}
+
+static void bench_k4(void)
+{
+    meshx_k4(sample_app_key, out);
+}
+
+static bool check_k4(void)
+{
+    bench_k4();
+    return (0x26 == out[0]);
+}
+
+static void bench_ecc_make_key(void)
+{
+    meshx_ecc_make_key(out, out1);
+}
+
+static bool check_ecc_make_key(void)
+{
+    if (MESHX_SUCCESS != meshx_ecc_make_key(out, out1))
+    {
+        return FALSE;
+    }
+    return meshx_ecc_validate_public_key(out);
+}
+
+static void bench_ecc_shared_secret(void)
+{
+    meshx_ecc_shared_secret(sample_device_public_key, sample_prov_private_key, out);
+}
+
+static bool check_ecc_shared_secret(void)
+{
+    meshx_ecc_shared_secret(sample_device_public_key, sample_prov_private_key, out);
+    meshx_ecc_shared_secret(sample_prov_public_key, sample_device_private_key, out1);
+    return (0 == memcmp(out, ecdh_secret, 32)) && (0 == memcmp(out1, ecdh_secret, 32));
+}
+
+static const bench_crypto_case_t bench_crypto_cases[] =
+{
+    {"aes128_encrypt", bench_aes128_encrypt, check_aes128_encrypt, TRUE},
+    {"aes128_ctx_encrypt", bench_aes128_ctx_encrypt, check_aes128_ctx_encrypt, TRUE},
+    {"ccm_encrypt_net", bench_ccm_encrypt_net, check_ccm_encrypt_net, TRUE},
+    {"ccm_decrypt_net", bench_ccm_decrypt_net, check_ccm_decrypt_net, TRUE},
+    {"ccm_encrypt_access", bench_ccm_encrypt_access, check_ccm_encrypt_access, TRUE},
+    {"ccm_decrypt_access", bench_ccm_decrypt_access, check_ccm_decrypt_access, TRUE},
+    {"aes_cmac", bench_aes_cmac, check_aes_cmac, TRUE},
+    {"s1", bench_s1, check_s1, TRUE},
+    {"k1", bench_k1, check_k1, TRUE},
+    {"k1_salt", bench_k1_salt, check_k1_salt, TRUE},
+    {"k2", bench_k2, check_k2, TRUE},
+    {"k3", bench_k3, check_k3, TRUE},
+    {"k4", bench_k4, check_k4, TRUE},
+    {"ecc_make_key", bench_ecc_make_key, check_ecc_make_key, FALSE},
+    {"ecc_shared_secret", bench_ecc_shared_secret, check_ecc_shared_secret, FALSE},
+};
+
+/* run case until time is used up, iterations are doubled every round */
+static void bench_crypto_run(const bench_crypto_case_t *pcase, uint64_t time_ns,
+                             uint64_t *piterations, uint64_t *pelapse)
+{
+    uint64_t iterations = 0;
+    uint64_t round = 1;
+    uint64_t begin = bench_now_ns();
+    uint64_t elapse = 0;
+    while (elapse < time_ns)
+    {
+        for (uint64_t i = 0; i < round; ++i)
+        {
+            pcase->run();
+        }
+        iterations += round;
+        round <<= 1;
+        elapse = bench_now_ns() - begin;
+    }
+
+    *piterations = iterations;
+    *pelapse = elapse;
+}
+
+static const char *bench_backend_name(meshx_aes128_backend_t backend)
+{
+    return (MESHX_AES128_BACKEND_AESNI == backend) ? "aesni" : "software";
+}
+
+/**
+ * run sample data of every aes case with software and aesni backend, results of both
+ * backends shall be the same as specification and as each other
+ */
+static int bench_crypto_backend_compare(bool machine)
+{
+    if (!meshx_aes128_backend_is_supported(MESHX_AES128_BACKEND_AESNI))
+    {
+        if (!machine)
+        {
+            printf("backend compare: skipped, aesni is not supported\n");
+        }
+        return 0;
+    }
+
+    int ret = 0;
+    for (uint32_t i = 0; i < sizeof(bench_crypto_cases) / sizeof(bench_crypto_case_t); ++i)
+    {
+        const bench_crypto_case_t *pcase = &bench_crypto_cases[i];
+        if (!pcase->aes)
+        {
+            continue;
+        }
+
+        uint8_t result[2][sizeof(out) + 1];
+        bool check[2];
+        for (uint8_t backend = MESHX_AES128_BACKEND_SOFTWARE; backend <= MESHX_AES128_BACKEND_AESNI;
+             ++backend)
+        {
+            /* keys used by case are expanded again by the backend */
+            meshx_security_backend_set(backend);
+            memset(out, 0, sizeof(out));
+            nid = 0;
+            check[backend] = pcase->check();
+            memcpy(result[backend], out, sizeof(out));
+            result[backend][sizeof(out)] = nid;
+        }
+
+        if (!check[MESHX_AES128_BACKEND_SOFTWARE] || !check[MESHX_AES128_BACKEND_AESNI] ||
+            (0 != memcmp(result[MESHX_AES128_BACKEND_SOFTWARE], result[MESHX_AES128_BACKEND_AESNI],
+                         sizeof(result[0]))))
+        {
+            /* printed in machine mode too, mismatch shall not be missed */
+            printf("backend compare: %s mismatch, software %s, aesni %s\n", pcase->name,
+                   check[MESHX_AES128_BACKEND_SOFTWARE] ? "ok" : "fail",
+                   check[MESHX_AES128_BACKEND_AESNI] ? "ok" : "fail");
+            ret = -1;
+        }
+    }
+
+    if ((0 == ret) && !machine)
+    {
+        printf("backend compare: software and aesni results are the same\n");
+    }
+
+    return ret;
+}
+
+int main(int argc, char **argv)
+{
+    bool machine = FALSE;
+    uint64_t time_ms = BENCH_CRYPTO_TIME_DEFAULT;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (0 == strcmp(argv[i], "-m"))
+        {
+            machine = TRUE;
+        }
+        else if ((0 == strcmp(argv[i], "-t")) && (i + 1 < argc))
+        {
+            time_ms = strtoul(argv[++i], NULL, 0);
+        }
+        else
+        {
+            printf("usage: %s [-m] [-t time per case in ms]\n", argv[0]);
+            return -1;
+        }
+    }
+
+    meshx_trace_init();
+    meshx_trace_level_disable(MESHX_TRACE_LEVEL_ALL);
+    meshx_security_init();
+    meshx_aes128_backend_t default_backend = meshx_aes128_backend_get();
+
+    if (machine)
+    {
+        printf("backend,case,iterations,ns_per_op,ops_per_s,check\n");
+    }
+
+    int ret = bench_crypto_backend_compare(machine);
+    for (uint8_t backend = MESHX_AES128_BACKEND_SOFTWARE; backend <= MESHX_AES128_BACKEND_AESNI;
+         ++backend)
+    {
+        if (!meshx_aes128_backend_is_supported(backend))
+        {
+            continue;
+        }
+        meshx_security_backend_set(backend);
+        if (!machine)
+        {
+            printf("aes128 backend: %s\n", bench_backend_name(backend));
+        }
+
+        for (uint32_t i = 0; i < sizeof(bench_crypto_cases) / sizeof(bench_crypto_case_t); ++i)
+        {
+            const bench_crypto_case_t *pcase = &bench_crypto_cases[i];
+            /* cases that don't use aes only run with default backend */
+            if (!pcase->aes && (backend != default_backend))
+            {
+                continue;
+            }
+
+            bool check = pcase->check();
+            if (!check)
+            {
+                ret = -1;
+            }
+
+            uint64_t iterations, elapse;
+            bench_crypto_run(pcase, time_ms * 1000000ULL, &iterations, &elapse);
+            double ns_per_op = (double)elapse / iterations;
+            if (machine)
+            {
+                printf("%s,%s,%llu,%.1f,%.0f,%s\n", bench_backend_name(backend), pcase->name,
+                       (unsigned long long)iterations, ns_per_op, 1e9 / ns_per_op,
+                       check ? "ok" : "fail");
+            }
+            else
+            {
+                printf("%-20s %12.1f ns/op %12.0f ops/s %s\n", pcase->name, ns_per_op,
+                       1e9 / ns_per_op, check ? "" : "CHECK FAILED");
+            }
+        }
+    }
+
+    meshx_security_backend_set(default_backend);
+
+    return ret;
+}
@@ -0,0 +1,231 @@
+/**
+ * This file is part of the meshx library.
+ *
+ * Copyright 2019, Huang Yang <elious.huang@gmail.com>. All rights reserved.
+ *
+ * See the COPYING file for the terms of usage and distribution.
+ */
+#define MESHX_TRACE_MODULE "BENCH_NET"
+#include <time.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "meshx.h"
+#include "meshx_security.h"
+#include "meshx_endianness.h"
+#include "meshx_config.h"
+
+/**
+ * compare throughput of meshx_net_receive and meshx_net_receive_batch
+ * usage: meshx_bench_net [pdu number] [batch size]
+ */
+
+#define BENCH_NET_PDU_NUM_DEFAULT          20000
+#define BENCH_NET_BATCH_SIZE_DEFAULT       MESHX_NET_RECEIVE_BATCH_MAX
+#define BENCH_NET_SRC                      0x1201
+#define BENCH_NET_DST                      0x1234
+#define BENCH_NET_NODE_ADDR                0x0003
+#define BENCH_NET_IV_INDEX                 0x12345678
+
+typedef struct
+{
+    uint8_t data[29];
+    uint8_t len;
+} bench_net_pdu_t;
+
+/* used by gap wrapper, adv bearer is disabled in benchmark */
+int fd_psdr = -1;
+
+int32_t meshx_trace_send(const char *pdata, uint32_t len)
+{
+    return len;
+}
+
+static int32_t bench_async_msg_notify_handler(void)
+{
+    return MESHX_SUCCESS;
+}
+
+static uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/* build encrypted and obfuscated network pdu, access message with 32bit net mic */
+static void bench_net_pdu_make(bench_net_pdu_t *ppdu, uint32_t seq, uint8_t trans_pdu_len,
+                               const meshx_net_key_value_t *pnet_key)
+{
+    uint8_t *pdata = ppdu->data;
+    pdata[0] = (uint8_t)(((BENCH_NET_IV_INDEX & 0x01) << 7) | pnet_key->nid);
+    pdata[1] = 5; /* ctl 0, ttl 5 */
+    pdata[2] = (uint8_t)(seq >> 16);
+    pdata[3] = (uint8_t)(seq >> 8);
+    pdata[4] = (uint8_t)seq;
+    pdata[5] = (uint8_t)(BENCH_NET_SRC >> 8);
+    pdata[6] = (uint8_t)BENCH_NET_SRC;
+    pdata[7] = (uint8_t)(BENCH_NET_DST >> 8);
+    pdata[8] = (uint8_t)BENCH_NET_DST;
+    for (uint8_t i = 0; i < trans_pdu_len; ++i)
+    {
+        pdata[9 + i] = (uint8_t)(seq + i);
+    }
+
+    meshx_net_nonce_t net_nonce;
+    memset(&net_nonce, 0, sizeof(meshx_net_nonce_t));
+    net_nonce.nonce_type = MESHX_NONCE_TYPE_NET;
+    net_nonce.ttl = 5;
+    memcpy(net_nonce.seq, pdata + 2, 3);
+    memcpy(&net_nonce.src, pdata + 5, 2);
+    net_nonce.iv_index = MESHX_HOST_TO_BE32(BENCH_NET_IV_INDEX);
+    meshx_aes_ccm_encrypt(pnet_key->encryption_key, (const uint8_t *)&net_nonce,
+                          sizeof(meshx_net_nonce_t), NULL, 0, pdata + 7, 2 + trans_pdu_len,
+                          pdata + 7, pdata + 9 + trans_pdu_len, 4);
+
+    uint32_t iv_index = MESHX_HOST_TO_BE32(BENCH_NET_IV_INDEX);
+    uint8_t pecb[16];
+    memset(pecb, 0, 5);
+    memcpy(pecb + 5, &iv_index, 4);
+    memcpy(pecb + 9, pdata + 7, 7);
+    meshx_aes128_encrypt(pecb, pnet_key->privacy_key, pecb);
+    for (uint8_t i = 0; i < 6; ++i)
+    {
+        pdata[1 + i] ^= pecb[i];
+    }
+
+    ppdu->len = 9 + trans_pdu_len + 4;
+}
+
+static void bench_net_pdus_make(bench_net_pdu_t *ppdus, uint32_t num, uint32_t seq_start,
+                                const meshx_net_key_value_t *pnet_key)
+{
+    for (uint32_t i = 0; i < num; ++i)
+    {
+        /* mix unsegmented access pdus of different length */
+        bench_net_pdu_make(&ppdus[i], seq_start + i, 1 + (i % 16), pnet_key);
+    }
+}
+
+static void bench_net_report(const char *pname, uint32_t num, uint32_t received,
+                             uint64_t elapse)
+{
+    double ns_per_pdu = (double)elapse / num;
+    printf("%-12s %8u pdus %8u received %10.1f ns/pdu %12.0f pdus/s\n", pname, num, received,
+           ns_per_pdu, 1e9 / ns_per_pdu);
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t pdu_num = BENCH_NET_PDU_NUM_DEFAULT;
+    uint32_t batch_size = BENCH_NET_BATCH_SIZE_DEFAULT;
+    if (argc > 1)
+    {
+        pdu_num = strtoul(argv[1], NULL, 0);
+    }
+    if (argc > 2)
+    {
+        batch_size = strtoul(argv[2], NULL, 0);
+    }
+    if ((0 == pdu_num) || (0 == batch_size))
+    {
+        printf("usage: %s [pdu number] [batch size]\n", argv[0]);
+        return -1;
+    }
+
+    meshx_async_msg_init(10, bench_async_msg_notify_handler);
+    meshx_trace_init();
+    meshx_trace_level_disable(MESHX_TRACE_LEVEL_ALL);
+
+    meshx_node_config_t config;
+    meshx_node_config_init(&config);
+    config.adv_bearer_enable = FALSE;
+    config.gatt_bearer_enable = FALSE;
+    meshx_node_config_set(&config);
+
+    meshx_node_param_t param;
+    meshx_node_params_init(&param);
+    param.node_addr = BENCH_NET_NODE_ADDR;
+    meshx_node_params_set(&param);
+
+    meshx_init();
+    meshx_iv_index_set(BENCH_NET_IV_INDEX);
+    meshx_net_key_add(0, sample_net_key);
+
+    const meshx_net_key_value_t *pnet_key = &meshx_net_key_get(0)->key_value[0];
+    meshx_net_iface_t net_iface = meshx_net_iface_get(NULL);
+
+    bench_net_pdu_t *ppdus = meshx_malloc(pdu_num * sizeof(bench_net_pdu_t));
+    const uint8_t **pdata = meshx_malloc(pdu_num * sizeof(uint8_t *));
+    uint8_t *plen = meshx_malloc(pdu_num);
+    if ((NULL == ppdus) || (NULL == pdata) || (NULL == plen))
+    {
+        printf("out of memory\n");
+        return -1;
+    }
+
+    int ret = 0;
+    uint32_t seq = 1;
+    for (uint8_t backend = MESHX_AES128_BACKEND_SOFTWARE; backend <= MESHX_AES128_BACKEND_AESNI;
+         ++backend)
+    {
+        if (!meshx_aes128_backend_is_supported(backend))
+        {
+            continue;
+        }
+        meshx_security_backend_set(backend);
+        printf("aes128 backend: %s\n", (MESHX_AES128_BACKEND_AESNI == backend) ? "aesni" : "software");
+        /* expanded net key belongs to previous backend, add it again */
+        meshx_net_key_delete(0);
+        meshx_net_key_add(0, sample_net_key);
+        pnet_key = &meshx_net_key_get(0)->key_value[0];
+
+        /* network message cache drops repeated pdus, so each pass uses new sequence numbers */
+        bench_net_pdus_make(ppdus, pdu_num, seq, pnet_key);
+        seq += pdu_num;
+        uint32_t received = 0;
+        uint64_t begin = bench_now_ns();
+        for (uint32_t i = 0; i < pdu_num; ++i)
+        {
+            if (MESHX_SUCCESS == meshx_net_receive(net_iface, ppdus[i].data, ppdus[i].len))
+            {
+                received ++;
+            }
+        }
+        bench_net_report("per-packet", pdu_num, received, bench_now_ns() - begin);
+        if (received != pdu_num)
+        {
+            ret = -1;
+        }
+
+        bench_net_pdus_make(ppdus, pdu_num, seq, pnet_key);
+        seq += pdu_num;
+        for (uint32_t i = 0; i < pdu_num; ++i)
+        {
+            pdata[i] = ppdus[i].data;
+            plen[i] = ppdus[i].len;
+        }
+        received = 0;
+        begin = bench_now_ns();
+        for (uint32_t i = 0; i < pdu_num; i += batch_size)
+        {
+            uint32_t num = (pdu_num - i > batch_size) ? batch_size : (pdu_num - i);
+            int32_t count = meshx_net_receive_batch(net_iface, pdata + i, plen + i, num);
+            if (count > 0)
+            {
+                received += count;
+            }
+        }
+        bench_net_report("batched", pdu_num, received, bench_now_ns() - begin);
+        if (received != pdu_num)
+        {
+            ret = -1;
+        }
+    }
+
+    meshx_free(plen);
+    meshx_free(pdata);
+    meshx_free(ppdus);
+
+    return ret;
+}
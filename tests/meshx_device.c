@@ -103,7 +103,7 @@ static int32_t meshx_notify_prov_cb(const void *pdata, uint8_t len)
             meshx_prov_capabilites_t cap;
             memset(&cap, 0, sizeof(meshx_prov_capabilites_t));
             cap.algorithms = MESHX_PROV_CAP_ALGORITHM_P256_CURVE;
-            cap.element_nums = 1;
+            cap.element_nums = meshx_node_config_get().element_num;
             meshx_prov_capabilites(pprov->metadata.prov_dev, &cap);
         }
         break;
@@ -217,15 +217,28 @@ static int32_t meshx_notify_prov_cb(const void *pdata, uint8_t len)
                              pstart->auth_size);
             if (MESHX_PROV_PUBLIC_KEY_OOB == pstart->public_key)
             {
-                /* dump public key */
-                meshx_tty_printf("my public key:");
+                /* dump public key, or wait until it is generated */
                 meshx_prov_public_key_t pub_key;
-                meshx_prov_get_local_public_key(pprov->metadata.prov_dev, &pub_key);
-                meshx_tty_dump((const uint8_t *)&pub_key, sizeof(meshx_prov_public_key_t));
-                meshx_tty_printf("\r\n");
+                if (MESHX_SUCCESS == meshx_prov_get_local_public_key(pprov->metadata.prov_dev, &pub_key))
+                {
+                    meshx_tty_printf("my public key:");
+                    meshx_tty_dump((const uint8_t *)&pub_key, sizeof(meshx_prov_public_key_t));
+                    meshx_tty_printf("\r\n");
+                }
+                else
+                {
+                    meshx_tty_printf("my public key is generating\r\n");
+                }
             }
         }
         break;
+    case MESHX_PROV_NOTIFY_LOCAL_PUBLIC_KEY:
+        {
+            meshx_tty_printf("my public key:");
+            meshx_tty_dump((const uint8_t *)pprov->pdata, sizeof(meshx_prov_public_key_t));
+            meshx_tty_printf("\r\n");
+        }
+        break;
     case MESHX_PROV_NOTIFY_PUBLIC_KEY:
         {
             const meshx_prov_public_key_t *ppub_key = pprov->pdata;
@@ -77,6 +77,8 @@ int32_t meshx_trace_send(const char *pdata, uint32_t len)
 }
 
 #if 1
+static bool public_key_pending;
+
 static int32_t meshx_notify_prov_cb(const void *pdata, uint8_t len)
 {
     const meshx_notify_prov_t *pprov = pdata;
@@ -167,13 +169,26 @@ static int32_t meshx_notify_prov_cb(const void *pdata, uint8_t len)
             {
                 meshx_tty_printf("send public key\r\n");
 
-                /* send public key */
+                /* send public key, or wait until it is generated */
                 meshx_prov_public_key_t pub_key;
-                meshx_prov_get_local_public_key(pprov->metadata.prov_dev, &pub_key);
-                meshx_prov_public_key(pprov->metadata.prov_dev, &pub_key);
+                if (MESHX_SUCCESS == meshx_prov_get_local_public_key(pprov->metadata.prov_dev, &pub_key))
+                {
+                    meshx_prov_public_key(pprov->metadata.prov_dev, &pub_key);
+                }
+                else
+                {
+                    public_key_pending = TRUE;
+                }
             }
         }
         break;
+    case MESHX_PROV_NOTIFY_LOCAL_PUBLIC_KEY:
+        if (public_key_pending)
+        {
+            public_key_pending = FALSE;
+            meshx_prov_public_key(pprov->metadata.prov_dev, pprov->pdata);
+        }
+        break;
     case MESHX_PROV_NOTIFY_FAILED:
         {
             /* @ref meshx provisison failed error code macros */
@@ -294,6 +309,9 @@ static int32_t meshx_notify_prov_cb(const void *pdata, uint8_t len)
             meshx_tty_printf("ack: %d\r\n", *pstate);
         }
         break;
+    case MESHX_PROV_NOTIFY_LOCAL_PUBLIC_KEY:
+        meshx_cmd_prov_local_public_key_ready(pprov->metadata.prov_dev, pprov->pdata);
+        break;
     case MESHX_PROV_NOTIFY_FAILED:
         {
             /* @ref meshx provisison failed error code macros */
@@ -448,7 +466,7 @@ static void *meshx_thread(void *pargs)
     ctx.ttl = 4;
     ctx.iv_index = meshx_iv_index_get();
     ctx.pnet_key = &meshx_net_key_get(0)->key_value[0];
-    ctx.pdev_key = &meshx_dev_key_get(0x1201)->dev_key;
+    ctx.pdev_key = meshx_dev_key_get(0x1201);
     ctx.aid = 0;//papp_key->aid;
     ctx.akf = 0;
     ctx.szmic = 0;
@@ -7,7 +7,7 @@
 #include <stdio.h>
 #include "aes_cmac.h"
 
-extern void aes128_encrypt(const unsigned char key[16], const unsigned char input[16],
+extern void aes128_encrypt(const void *pcipher, const unsigned char input[16],
                            unsigned char output[16]);
 
 /* For CMAC Calculation */
@@ -41,7 +41,7 @@ void leftshift_onebit(unsigned char *input, unsigned char *output)
     return;
 }
 
-void generate_subkey(unsigned char *key, unsigned char *K1, unsigned
+void generate_subkey(const void *pcipher, unsigned char *K1, unsigned
                      char *K2)
 {
     unsigned char L[16];
@@ -49,7 +49,7 @@ void generate_subkey(unsigned char *key, unsigned char *K1, unsigned
     unsigned char tmp[16];
     int i;
     for (i = 0; i < 16; i++) { Z[i] = 0; }
-    aes128_encrypt(key, Z, L);
+    aes128_encrypt(pcipher, Z, L);
     if ((L[0] & 0x80) == 0)     /* If MSB(L) = 0, then K1 = L << 1 */
     {
         leftshift_onebit(L, K1);
@@ -92,13 +92,20 @@ void padding(unsigned char *lastb, unsigned char *pad, int length)
     }
 }
 
-void AES_CMAC(unsigned char *key, unsigned char *input, int length,
+void AES_CMAC(const void *pcipher, unsigned char *input, int length,
               unsigned char *mac)
 {
-    unsigned char X[16], Y[16], M_last[16], padded[16];
     unsigned char K1[16], K2[16];
+    generate_subkey(pcipher, K1, K2);
+    AES_CMAC_with_subkey(pcipher, K1, K2, input, length, mac);
+}
+
+void AES_CMAC_with_subkey(const void *pcipher, const unsigned char *K1,
+                          const unsigned char *K2, unsigned char *input, int length,
+                          unsigned char *mac)
+{
+    unsigned char X[16], Y[16], M_last[16], padded[16];
     int n, i, flag;
-    generate_subkey(key, K1, K2);
     n = (length + 15) / 16; /* n is number of rounds */
     if (n == 0)
     {
@@ -118,21 +125,21 @@ void AES_CMAC(unsigned char *key, unsigned char *input, int length,
     }
     if (flag)     /* last block is complete block */
     {
-        xor_128(&input[16 * (n - 1)], K1, M_last);
+        xor_128(&input[16 * (n - 1)], (unsigned char *)K1, M_last);
     }
     else
     {
         padding(&input[16 * (n - 1)], padded, length % 16);
-        xor_128(padded, K2, M_last);
+        xor_128(padded, (unsigned char *)K2, M_last);
     }
     for (i = 0; i < 16; i++) { X[i] = 0; }
     for (i = 0; i < n - 1; i++)
     {
         xor_128(X, &input[16 * i], Y); /* Y := Mi (+) X */
-        aes128_encrypt(key, Y, X); /* X := AES-128(KEY, Y); */
+        aes128_encrypt(pcipher, Y, X); /* X := AES-128(KEY, Y); */
     }
     xor_128(X, M_last, Y);
-    aes128_encrypt(key, Y, X);
+    aes128_encrypt(pcipher, Y, X);
     for (i = 0; i < 16; i++)
     {
         mac[i] = X[i];
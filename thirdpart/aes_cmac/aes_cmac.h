@@ -9,8 +9,14 @@
 #define _AES_CMAC_H_
 
 
-extern void AES_CMAC(unsigned char *key, unsigned char *input, int length,
+/* pcipher: expanded key which is passed through to aes128_encrypt */
+extern void AES_CMAC(const void *pcipher, unsigned char *input, int length,
                      unsigned char *mac);
+extern void generate_subkey(const void *pcipher, unsigned char *K1, unsigned char *K2);
+/* K1, K2: subkeys generated by generate_subkey with the same pcipher */
+extern void AES_CMAC_with_subkey(const void *pcipher, const unsigned char *K1,
+                                 const unsigned char *K2, unsigned char *input, int length,
+                                 unsigned char *mac);
 
 
 #endif
\ No newline at end of file
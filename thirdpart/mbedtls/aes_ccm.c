@@ -33,9 +33,6 @@
 #include "aes_ccm.h"
 
 
-extern int32_t meshx_aes128_encrypt(const uint8_t input[16], const uint8_t key[16],
-                                    uint8_t output[16]);
-
 #define CCM_ENCRYPT 0
 #define CCM_DECRYPT 1
 
@@ -51,7 +48,7 @@ extern int32_t meshx_aes128_encrypt(const uint8_t input[16], const uint8_t key[1
 #define UPDATE_CBC_MAC                                                      \
     for( i = 0; i < 16; i++ )                                               \
         y[i] ^= b[i];                                                       \
-    meshx_aes128_encrypt(y, ctx->key, y);
+    meshx_aes128_ctx_encrypt(ctx->pcipher, y, y);
 
 /*
  * Encrypt or decrypt a partial block with CTR
@@ -59,7 +56,7 @@ extern int32_t meshx_aes128_encrypt(const uint8_t input[16], const uint8_t key[1
  * This avoids allocating one more 16 bytes buffer while allowing src == dst.
  */
 #define CTR_CRYPT( dst, src, len  )                                         \
-    meshx_aes128_encrypt(ctr, ctx->key, b);                                 \
+    meshx_aes128_ctx_encrypt(ctx->pcipher, ctr, b);                         \
     for( i = 0; i < len; i++ )                                              \
         dst[i] = src[i] ^ b[i];
 
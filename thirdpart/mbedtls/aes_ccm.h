@@ -50,6 +50,7 @@
 #define MBEDTLS_CCM_H
 
 #include <stdio.h>
+#include "meshx_security_wrapper.h"
 
 
 /**
@@ -58,7 +59,7 @@
  */
 typedef struct mbedtls_ccm_context
 {
-    uint8_t key[16];
+    const meshx_aes128_ctx_t *pcipher;
 } mbedtls_ccm_context;
 
 /**